@@ -0,0 +1,344 @@
+// asciibench: 캡처한 프레임 코퍼스(-asciicapture)를 ASCII 변환 커널 조합마다 재생해서
+// 처리량/지연 분포를 재고, 같은 가중 방식끼리 출력이 비트 단위로 같은지 확인
+//
+//   asciibench <corpus> [-grid WxH]... [-frames N] [-repeat N] [-warmup N]
+//                       [-workers N] [-dither off|bayer|floyd|atkinson|all] [-json <file>]
+//
+// 출력이 어긋나는 조합이 있으면 종료 코드 1
+
+#include "config.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "i_ascii.h"
+#include "i_asciicorpus.h"
+
+struct Grid { int w, h; };
+
+// 기본 지오메트리: 기본 그리드, 1/2, 1/3, 소스와 같은 해상도
+static const Grid default_grids[] = { { 240, 80 }, { 160, 50 }, { 80, 25 }, { 320, 200 } };
+
+struct Variant {
+    int area;          // 1: 분수 면적 가중, 0: 정수 경계 (출력 비교 그룹)
+    int downsample;    // ascii_set_downsample_kernel 번호
+    int fused;
+    const char* simd;  // "scalar" 또는 ascii_set_simd_kernel 이름
+    int source;        // ASCII_SOURCE_PAL8 | ASCII_SOURCE_RGBA32
+    int dither;        // ASCII_DITHER_* (방식마다 출력 비교 그룹이 따로)
+};
+
+struct Result {
+    Grid grid;
+    Variant v;
+    std::string downsample_name;
+    uint64_t frames;
+    double cells_per_sec, ns_per_cell;
+    double p50, p90, p99, p999, max;  // µs
+    int mismatches;                   // 기준 조합과 다른 프레임 수
+    int first_mismatch;
+};
+
+static const char* const downsample_names[] = { "integral", "weighted", "specialized", "separable" };
+static const char* const dither_names[] = { "off", "bayer", "floyd", "atkinson" };
+
+// FNV-1a 64: 프레임 출력 비교용
+static uint64_t hash_cells(const void* cells, size_t bytes) {
+    const uint8_t* p = (const uint8_t*)cells;
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < bytes; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static inline uint64_t now_ns(void) {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static double percentile_us(const std::vector<uint64_t>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    const size_t rank = std::max<size_t>(1, (size_t)std::ceil(p * (double)sorted.size()));
+    return (double)sorted[std::min(rank, sorted.size()) - 1] / 1000.0;
+}
+
+// 프레임 하나 변환 (팔레트/RGBA 준비는 측정 밖)
+static std::vector<uint32_t> rgba_scratch;
+
+static bool prepare_frame(const AsciiCorpusFrame& f, int source, const uint32_t** rgba) {
+    if (f.type == ASCII_CORPUS_RGBA32) {
+        if (source != ASCII_SOURCE_RGBA32) return false;
+        *rgba = (const uint32_t*)f.pixels;
+        return true;
+    }
+    I_SetASCIIPalette(f.palette);
+    if (source == ASCII_SOURCE_RGBA32) {
+        // SDL 8비트 → 32비트 블릿과 같은 값
+        const uint8_t* px = (const uint8_t*)f.pixels;
+        const size_t n = (size_t)f.width * f.height;
+        rgba_scratch.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            const uint8_t* c = f.palette + px[i] * 3;
+            rgba_scratch[i] = 0xff000000u | (c[0] << 16) | (c[1] << 8) | c[2];
+        }
+        *rgba = rgba_scratch.data();
+    }
+    return true;
+}
+
+static void convert(const AsciiCorpusFrame& f, int source, const uint32_t* rgba, const Grid& g) {
+    if (source == ASCII_SOURCE_RGBA32) {
+        I_ConvertRGBAtoASCII(rgba, f.width, f.height, (void*)I_GetASCIIBuffer(), g.w, g.h);
+    } else {
+        I_ConvertPal8toASCII((const uint8_t*)f.pixels, f.width, f.height,
+                             (void*)I_GetASCIIBuffer(), g.w, g.h);
+    }
+}
+
+static bool apply_variant(const Variant& v) {
+    ascii_set_area_weighting(v.area);
+    ascii_set_downsample_kernel(v.downsample);
+    ascii_set_fused(v.fused);
+    ascii_set_source_mode(v.source);
+    ascii_set_dither(v.dither);
+    if (std::strcmp(v.simd, "scalar") == 0) {
+        ascii_set_simd(0);
+        return true;
+    }
+    ascii_set_simd(1);
+    return ascii_set_simd_kernel(v.simd) != 0;
+}
+
+// 조합 하나 실행. 강제한 다운샘플 커널을 이 지오메트리에서 못 쓰면 false
+static bool run_variant(const Grid& g, const Variant& v, int frame_count, int repeat, int warmup,
+                        std::vector<uint64_t>& hashes, bool reference, Result& res) {
+    if (!apply_variant(v)) return false;
+    ascii_set_grid(g.w, g.h);
+    const size_t cell_bytes = (size_t)g.w * g.h * sizeof(AsciiCell);
+
+    std::vector<uint64_t> times;
+    times.reserve((size_t)frame_count * repeat);
+    res.grid = g;
+    res.v = v;
+    res.mismatches = 0;
+    res.first_mismatch = -1;
+
+    bool checked_kernel = false;
+    uint64_t cells = 0, total_ns = 0;
+    for (int pass = -1; pass < repeat; ++pass) {
+        for (int i = 0; i < frame_count; ++i) {
+            if (pass < 0 && i >= warmup) break;  // 워밍업: 앞쪽 프레임만
+            AsciiCorpusFrame f;
+            const uint32_t* rgba = nullptr;
+            I_GetASCIICorpusFrame(i, &f);
+            if (!prepare_frame(f, v.source, &rgba)) return false;
+
+            const uint64_t t0 = now_ns();
+            convert(f, v.source, rgba, g);
+            const uint64_t dt = now_ns() - t0;
+
+            if (!checked_kernel) {
+                // 요청한 커널이 못 쓰이면 자동 선택으로 넘어가므로 건너뜀
+                if (std::strcmp(ascii_get_downsample_kernel(), downsample_names[v.downsample]) != 0) {
+                    return false;
+                }
+                checked_kernel = true;
+            }
+            if (pass < 0) continue;
+            times.push_back(dt);
+            total_ns += dt;
+            cells += (uint64_t)g.w * g.h;
+
+            if (pass == 0) {
+                const uint64_t h = hash_cells(I_GetASCIIBuffer(), cell_bytes);
+                if (reference) {
+                    hashes[i] = h;
+                } else if (hashes[i] != h) {
+                    if (res.mismatches++ == 0) res.first_mismatch = i;
+                }
+            }
+        }
+    }
+
+    std::sort(times.begin(), times.end());
+    res.downsample_name = downsample_names[v.downsample];
+    res.frames = times.size();
+    res.cells_per_sec = total_ns ? (double)cells * 1e9 / (double)total_ns : 0.0;
+    res.ns_per_cell = cells ? (double)total_ns / (double)cells : 0.0;
+    res.p50 = percentile_us(times, 0.50);
+    res.p90 = percentile_us(times, 0.90);
+    res.p99 = percentile_us(times, 0.99);
+    res.p999 = percentile_us(times, 0.999);
+    res.max = times.empty() ? 0.0 : (double)times.back() / 1000.0;
+    return true;
+}
+
+static void write_json(const char* path, const std::vector<Result>& results,
+                       const char* corpus, int frames) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "asciibench: cannot write '%s'\n", path);
+        return;
+    }
+    fprintf(f, "{\"corpus\":\"%s\",\"frames\":%d,\"simd_kernel\":\"%s\",\"results\":[",
+            corpus, frames, ascii_get_simd_kernel());
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        fprintf(f, "%s{\"grid\":[%d,%d],\"weighting\":\"%s\",\"downsample\":\"%s\","
+                   "\"pipeline\":\"%s\",\"simd\":\"%s\",\"source\":\"%s\",\"dither\":\"%s\",\"frames\":%llu,"
+                   "\"cells_per_sec\":%.0f,\"ns_per_cell\":%.3f,\"p50\":%.3f,\"p90\":%.3f,"
+                   "\"p99\":%.3f,\"p999\":%.3f,\"max\":%.3f,\"mismatches\":%d}",
+                i ? "," : "", r.grid.w, r.grid.h, r.v.area ? "area" : "integer",
+                r.downsample_name.c_str(), r.v.fused ? "fused" : "two-pass", r.v.simd,
+                r.v.source == ASCII_SOURCE_PAL8 ? "pal8" : "rgba32", dither_names[r.v.dither],
+                (unsigned long long)r.frames, r.cells_per_sec, r.ns_per_cell,
+                r.p50, r.p90, r.p99, r.p999, r.max, r.mismatches);
+    }
+    fprintf(f, "]}\n");
+    fclose(f);
+}
+
+static void usage(void) {
+    fprintf(stderr,
+            "usage: asciibench <corpus> [-grid WxH]... [-frames N] [-repeat N]\n"
+            "                  [-warmup N] [-workers N] [-dither off|bayer|floyd|atkinson|all]\n"
+            "                  [-json <file>]\n");
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    const char* corpus = nullptr;
+    const char* json_path = nullptr;
+    std::vector<Grid> grids;
+    int max_frames = 0, repeat = 3, warmup = 3, workers = 1;
+    std::vector<int> dithers = { ASCII_DITHER_OFF };
+
+    for (int i = 1; i < argc; ++i) {
+        const bool has_arg = i + 1 < argc;
+        if (!std::strcmp(argv[i], "-grid") && has_arg) {
+            Grid g;
+            if (sscanf(argv[++i], "%dx%d", &g.w, &g.h) != 2 || g.w <= 0 || g.h <= 0) usage();
+            grids.push_back(g);
+        } else if (!std::strcmp(argv[i], "-frames") && has_arg) {
+            max_frames = atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "-repeat") && has_arg) {
+            repeat = std::max(1, atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "-warmup") && has_arg) {
+            warmup = std::max(0, atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "-workers") && has_arg) {
+            workers = std::max(0, atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "-dither") && has_arg) {
+            const char* name = argv[++i];
+            dithers.clear();
+            for (int d = 0; d < ASCII_DITHER_COUNT; ++d) {
+                if (!std::strcmp(name, "all") || !std::strcmp(name, dither_names[d])) dithers.push_back(d);
+            }
+            if (dithers.empty()) usage();
+        } else if (!std::strcmp(argv[i], "-json") && has_arg) {
+            json_path = argv[++i];
+        } else if (argv[i][0] != '-' && !corpus) {
+            corpus = argv[i];
+        } else {
+            usage();
+        }
+    }
+    if (!corpus) usage();
+    if (grids.empty()) grids.assign(std::begin(default_grids), std::end(default_grids));
+
+    const int frame_count = I_LoadASCIICorpus(corpus, max_frames);
+    if (frame_count <= 0) {
+        fprintf(stderr, "asciibench: no frames in '%s'\n", corpus);
+        return 2;
+    }
+    bool any_pal8 = false, any_rgba = false;
+    for (int i = 0; i < frame_count; ++i) {
+        AsciiCorpusFrame f;
+        I_GetASCIICorpusFrame(i, &f);
+        (f.type == ASCII_CORPUS_PAL8 ? any_pal8 : any_rgba) = true;
+    }
+
+    I_InitASCII();
+    ascii_set_incremental(0);    // 매 프레임 전체 변환을 잼
+    ascii_set_frame_skip(0);     // 같은 프레임도 건너뛰지 않고 변환
+    ascii_set_stage_timing(0);   // 단계 히스토그램 시계 호출 제외
+    ascii_set_workers(workers);
+
+    // SIMD 축: 스칼라 + 이 CPU에서 쓸 수 있는 커널
+    std::vector<const char*> simds = { "scalar" };
+    for (const char* k : { "ssse3", "avx2", "wasm-simd128" }) {
+        if (ascii_set_simd_kernel(k)) simds.push_back(k);
+    }
+    ascii_set_simd_kernel("auto");
+
+    std::vector<int> sources;
+    if (any_pal8 && !any_rgba) sources.push_back(ASCII_SOURCE_PAL8);
+    sources.push_back(ASCII_SOURCE_RGBA32);
+
+    printf("corpus %s: %d frames, repeat %d, warmup %d, workers %d, simd %s\n",
+           corpus, frame_count, repeat, warmup, ascii_get_workers(), ascii_get_simd_kernel());
+    printf("%-9s %-7s %-11s %-8s %-12s %-6s %-8s %12s %8s %9s %9s %9s %9s %s\n",
+           "grid", "weight", "downsample", "pipeline", "simd", "source", "dither",
+           "Mcells/s", "ns/cell", "p50 us", "p90 us", "p99 us", "p99.9 us", "check");
+
+    std::vector<Result> results;
+    std::vector<uint64_t> hashes(frame_count);
+    int mismatched = 0;
+    for (const Grid& g : grids) {
+        for (int dither : dithers) {
+            for (int area = 0; area <= 1; ++area) {
+                bool have_reference = false;
+                for (int ds = 0; ds < 4; ++ds) {
+                    for (int fused = 1; fused >= 0; --fused) {
+                        for (const char* simd : simds) {
+                            for (int source : sources) {
+                                const Variant v = { area, ds, fused, simd, source, dither };
+                                Result r;
+                                if (!run_variant(g, v, frame_count, repeat, warmup, hashes,
+                                                 !have_reference, r)) {
+                                    continue;
+                                }
+                                have_reference = true;
+                                if (r.mismatches) mismatched++;
+                                char grid[24], check[40];
+                                snprintf(grid, sizeof(grid), "%dx%d", g.w, g.h);
+                                if (r.mismatches) {
+                                    snprintf(check, sizeof(check), "DIFF %d (first %d)",
+                                             r.mismatches, r.first_mismatch);
+                                } else {
+                                    snprintf(check, sizeof(check), "ok");
+                                }
+                                printf("%-9s %-7s %-11s %-8s %-12s %-6s %-8s %12.1f %8.3f %9.1f %9.1f %9.1f %9.1f %s\n",
+                                       grid, area ? "area" : "integer", r.downsample_name.c_str(),
+                                       fused ? "fused" : "two-pass", simd,
+                                       source == ASCII_SOURCE_PAL8 ? "pal8" : "rgba32",
+                                       dither_names[dither],
+                                       r.cells_per_sec / 1e6, r.ns_per_cell,
+                                       r.p50, r.p90, r.p99, r.p999, check);
+                                results.push_back(r);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (json_path) write_json(json_path, results, corpus, frame_count);
+    I_ShutdownASCII();
+    I_FreeASCIICorpus();
+
+    if (mismatched) {
+        printf("%d variant(s) differ from the reference output\n", mismatched);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,324 @@
+// asciicastload: 관전 방송 서버(i_asciicast) 부하 생성기
+// 코퍼스(-asciicapture)를 변환해 유닉스 소켓으로 방송하고, 같은 프로세스 안의 가짜 구독자 N개가
+// 메시지를 받아 자기 그리드에 적용함. 구독자 수마다 프레임당 인코딩/전송 시간을 재서
+// 인코딩 비용이 구독자 수와 무관한지 보여 주고, 끝에 모든 구독자 그리드가 서버 프레임과 같은지 확인
+//
+//   asciicastload <corpus> [-clients N]... [-frames N] [-grid WxH] [-slow N]
+//   asciicastload -connect <주소> [-clients N] [-seconds S]   (실행 중인 -asciicast 서버에 붙기)
+//
+// -slow N: 구독자 N개는 8프레임에 한 번만 읽음 (링을 놓쳐 키프레임으로 건너뛰는 경로)
+// 구독자 그리드가 어긋나면 종료 코드 1
+
+#include "config.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "i_ascii.h"
+#include "i_asciicast.h"
+#include "i_asciicorpus.h"
+
+static const int default_clients[] = { 1, 10, 100, 400 };
+
+struct Subscriber {
+    int fd = -1;
+    bool slow = false;
+    std::vector<uint8_t> buf;     // 아직 다 못 받은 메시지
+    std::vector<AsciiCell> grid;
+    int w = 0, h = 0;
+    uint32_t seq = 0;
+    bool synced = false;          // 키프레임을 받았는지
+    bool broken = false;          // 형식/순번 오류
+    uint64_t bytes = 0, messages = 0, keys = 0;
+};
+
+static inline double now_ms(void) {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+static inline uint32_t get_u16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static inline uint32_t get_u32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// 메시지 하나 적용
+static void apply_message(Subscriber& s, const uint8_t* m, size_t size) {
+    const char type = (char)m[4];
+    const uint32_t seq = get_u32(m + 8);
+    const int w = (int)get_u16(m + 12), h = (int)get_u16(m + 14);
+    const uint8_t* body = m + ASCII_CAST_HEADER_SIZE;
+    const size_t body_size = size - ASCII_CAST_HEADER_SIZE;
+    s.messages++;
+
+    if (type == ASCII_CAST_KEY) {
+        if (body_size != (size_t)w * h * sizeof(AsciiCell)) { s.broken = true; return; }
+        s.grid.resize((size_t)w * h);
+        std::memcpy(s.grid.data(), body, body_size);
+        s.w = w; s.h = h;
+        s.seq = seq;
+        s.synced = true;
+        s.keys++;
+        return;
+    }
+    if (type != ASCII_CAST_DELTA || !s.synced || seq != s.seq + 1 || w != s.w || h != s.h) {
+        s.broken = true;
+        return;
+    }
+    size_t off = 0;
+    while (off + 6 <= body_size) {
+        const uint32_t start = get_u32(body + off);
+        const uint32_t count = get_u16(body + off + 4);
+        off += 6;
+        if (off + count * sizeof(AsciiCell) > body_size || start + count > (uint32_t)(w * h)) {
+            s.broken = true;
+            return;
+        }
+        std::memcpy(&s.grid[start], body + off, count * sizeof(AsciiCell));
+        off += count * sizeof(AsciiCell);
+    }
+    if (off != body_size) s.broken = true;
+    s.seq = seq;
+}
+
+// 받을 수 있는 만큼 받아서 완성된 메시지를 적용. 연결이 끊겼으면 false
+static bool drain(Subscriber& s) {
+    uint8_t chunk[65536];
+    for (;;) {
+        const ssize_t r = recv(s.fd, chunk, sizeof(chunk), 0);
+        if (r == 0) return false;
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            break;
+        }
+        s.bytes += (uint64_t)r;
+        s.buf.insert(s.buf.end(), chunk, chunk + r);
+    }
+    size_t off = 0;
+    while (s.buf.size() - off >= ASCII_CAST_HEADER_SIZE) {
+        const uint8_t* m = s.buf.data() + off;
+        if (std::memcmp(m, ASCII_CAST_MAGIC, 4) != 0) { s.broken = true; return true; }
+        const size_t size = ASCII_CAST_HEADER_SIZE + get_u32(m + 16);
+        if (s.buf.size() - off < size) break;
+        apply_message(s, m, size);
+        off += size;
+    }
+    s.buf.erase(s.buf.begin(), s.buf.begin() + off);
+    return true;
+}
+
+static int connect_to(const char* address) {
+    int fd = -1;
+    if (!std::strncmp(address, "unix:", 5)) {
+        struct sockaddr_un sa;
+        std::memset(&sa, 0, sizeof(sa));
+        sa.sun_family = AF_UNIX;
+        std::strncpy(sa.sun_path, address + 5, sizeof(sa.sun_path) - 1);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, (struct sockaddr*)&sa, sizeof(sa)) != 0) { close(fd); fd = -1; }
+    } else {
+        std::string host = "127.0.0.1", port = address;
+        const size_t colon = port.rfind(':');
+        if (colon != std::string::npos) {
+            host = port.substr(0, colon);
+            port = port.substr(colon + 1);
+        }
+        struct addrinfo hints, *res = nullptr;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_socktype = SOCK_STREAM;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0) return -1;
+        for (struct addrinfo* ai = res; ai && fd < 0; ai = ai->ai_next) {
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) { close(fd); fd = -1; }
+        }
+        freeaddrinfo(res);
+    }
+    if (fd >= 0) fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    return fd;
+}
+
+// 같은 프로세스의 서버면 접속마다 수락시킴 (대기열이 차면 connect가 막힘)
+static bool connect_all(std::vector<Subscriber>& subs, int count, int slow, const char* address) {
+    subs.assign((size_t)count, Subscriber());
+    for (int i = 0; i < count; ++i) {
+        subs[i].fd = connect_to(address);
+        I_PumpASCIICast();
+        subs[i].slow = i < slow;
+        if (subs[i].fd < 0) {
+            fprintf(stderr, "asciicastload: cannot connect subscriber %d to '%s'\n", i, address);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void close_all(std::vector<Subscriber>& subs) {
+    for (Subscriber& s : subs) if (s.fd >= 0) close(s.fd);
+    subs.clear();
+}
+
+static void raise_fd_limit(void) {
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+}
+
+// 외부 서버에 붙어 S초 동안 받기만 함
+static int run_connect(const char* address, int count, double seconds) {
+    std::vector<Subscriber> subs;
+    if (!connect_all(subs, count, 0, address)) return 2;
+    const double t0 = now_ms();
+    while (now_ms() - t0 < seconds * 1000.0) {
+        for (Subscriber& s : subs) if (s.fd >= 0 && !drain(s)) { close(s.fd); s.fd = -1; }
+        usleep(2000);
+    }
+    uint64_t bytes = 0, msgs = 0, keys = 0;
+    int broken = 0, closed = 0;
+    for (const Subscriber& s : subs) {
+        bytes += s.bytes; msgs += s.messages; keys += s.keys;
+        broken += s.broken; closed += s.fd < 0;
+    }
+    printf("%d subscriber(s) for %.1f s: %llu messages, %llu keyframes, %.0f bytes/s per subscriber, "
+           "%d broken, %d closed\n", count, seconds, (unsigned long long)msgs,
+           (unsigned long long)keys, (double)bytes / count / seconds, broken, closed);
+    close_all(subs);
+    return broken ? 1 : 0;
+}
+
+static void usage(void) {
+    fprintf(stderr,
+            "usage: asciicastload <corpus> [-clients N]... [-frames N] [-grid WxH] [-slow N]\n"
+            "       asciicastload -connect <address> [-clients N] [-seconds S]\n");
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    const char* corpus = nullptr;
+    const char* address = nullptr;
+    std::vector<int> counts;
+    int frames = 350, slow = 0, grid_w = ASCII_WIDTH, grid_h = ASCII_HEIGHT;
+    double seconds = 10.0;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool has_arg = i + 1 < argc;
+        if (!std::strcmp(argv[i], "-clients") && has_arg) {
+            counts.push_back(std::max(1, atoi(argv[++i])));
+        } else if (!std::strcmp(argv[i], "-frames") && has_arg) {
+            frames = std::max(1, atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "-grid") && has_arg) {
+            if (sscanf(argv[++i], "%dx%d", &grid_w, &grid_h) != 2) usage();
+        } else if (!std::strcmp(argv[i], "-slow") && has_arg) {
+            slow = std::max(0, atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "-connect") && has_arg) {
+            address = argv[++i];
+        } else if (!std::strcmp(argv[i], "-seconds") && has_arg) {
+            seconds = std::max(0.1, atof(argv[++i]));
+        } else if (argv[i][0] != '-' && !corpus) {
+            corpus = argv[i];
+        } else {
+            usage();
+        }
+    }
+    raise_fd_limit();
+    if (address) return run_connect(address, counts.empty() ? 1 : counts[0], seconds);
+    if (!corpus) usage();
+    if (counts.empty()) counts.assign(std::begin(default_clients), std::end(default_clients));
+
+    const int frame_count = I_LoadASCIICorpus(corpus, 0);
+    if (frame_count <= 0) {
+        fprintf(stderr, "asciicastload: no frames in '%s'\n", corpus);
+        return 2;
+    }
+    I_InitASCII();
+    ascii_set_frame_skip(0);
+    if (!I_SetASCIIGrid(grid_w, grid_h)) usage();
+
+    char sock[64];
+    snprintf(sock, sizeof(sock), "unix:/tmp/asciicastload-%d.sock", (int)getpid());
+
+    printf("corpus %s: %d frames (%d broadcast per run), grid %dx%d, %d slow subscriber(s)\n",
+           corpus, frame_count, frames, grid_w, grid_h, slow);
+    printf("%9s %14s %14s %16s %12s %10s %7s %s\n", "clients", "encode us/fr", "send us/fr",
+           "send us/fr/cli", "bytes/fr/cli", "keyframes", "drops", "check");
+
+    int failed = 0;
+    for (int count : counts) {
+        if (!I_StartASCIICast(sock)) {
+            fprintf(stderr, "asciicastload: cannot listen on '%s'\n", sock);
+            return 2;
+        }
+        std::vector<Subscriber> subs;
+        if (!connect_all(subs, count, std::min(slow, count), sock)) return 2;
+
+        for (int f = 0; f < frames; ++f) {
+            AsciiCorpusFrame cf;
+            I_GetASCIICorpusFrame(f % frame_count, &cf);
+            if (cf.type == ASCII_CORPUS_PAL8) {
+                I_SetASCIIPalette(cf.palette);
+                I_ConvertPal8toASCII((const uint8_t*)cf.pixels, cf.width, cf.height,
+                                     (void*)I_GetASCIIBuffer(), grid_w, grid_h);
+            } else {
+                I_ConvertRGBAtoASCII((const uint32_t*)cf.pixels, cf.width, cf.height,
+                                     (void*)I_GetASCIIBuffer(), grid_w, grid_h);
+            }
+            I_BroadcastASCIIFrame((const AsciiCell*)I_GetASCIIBuffer(), grid_w, grid_h);
+            for (Subscriber& s : subs) {
+                if (s.fd >= 0 && (!s.slow || f % 8 == 7) && !drain(s)) { close(s.fd); s.fd = -1; }
+            }
+        }
+
+        // 모든 구독자가 마지막 프레임까지 받도록 마저 보냄
+        AsciiCastStats st;
+        I_GetASCIICastStats(&st);
+        for (int round = 0; round < 1000; ++round) {
+            I_PumpASCIICast();
+            bool done = true;
+            for (Subscriber& s : subs) {
+                if (s.fd >= 0 && !drain(s)) { close(s.fd); s.fd = -1; }
+                done = done && (s.fd < 0 || s.seq == (uint32_t)st.frames);
+            }
+            if (done) break;
+        }
+
+        const AsciiCell* last = (const AsciiCell*)I_GetASCIIBuffer();
+        int bad = 0;
+        uint64_t bytes = 0;
+        for (const Subscriber& s : subs) {
+            bytes += s.bytes;
+            if (s.fd < 0 || s.broken || s.seq != (uint32_t)st.frames || s.w != grid_w || s.h != grid_h
+             || std::memcmp(s.grid.data(), last, sizeof(AsciiCell) * (size_t)grid_w * grid_h) != 0) {
+                bad++;
+            }
+        }
+        I_GetASCIICastStats(&st);
+        char check[32];
+        snprintf(check, sizeof(check), bad ? "DIFF %d" : "ok", bad);
+        printf("%9d %14.1f %14.1f %16.2f %12.0f %10llu %7llu %s\n", count,
+               st.encode_ms * 1000.0 / frames, st.send_ms * 1000.0 / frames,
+               st.send_ms * 1000.0 / frames / count, (double)bytes / frames / count,
+               (unsigned long long)st.keyframes, (unsigned long long)st.drops, check);
+        failed += bad;
+
+        close_all(subs);
+        I_StopASCIICast();
+    }
+    I_ShutdownASCII();
+    return failed ? 1 : 0;
+}
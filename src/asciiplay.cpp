@@ -0,0 +1,162 @@
+// asciiplay: ASCII 세션 녹화(-asciirecord) 재생기
+// 녹화된 AsciiCell 그리드를 터미널(i_asciiterm)이나 관전 방송 서버(i_asciicast)로 tic 시간에 맞춰 내보냄
+// 변환을 다시 하지 않으므로 실시간보다 훨씬 빠르게 돌릴 수 있음
+//
+//   asciiplay <session> [-speed X | -fast] [-seek TIC] [-until TIC] [-colors 24|256|16]
+//                       [-cast <주소>]
+//   asciiplay <session> -stats   (디코딩 속도/탐색 지연만 재고 출력하지 않음)
+//
+// 파일을 열 수 없으면 종료 코드 2
+
+#include "config.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "i_ascii.h"
+#include "i_asciicast.h"
+#include "i_asciisession.h"
+#include "i_asciiterm.h"
+
+#define TICRATE 35  // i_timer.h (게임 쪽 헤더는 끌어오지 않음)
+
+static inline double now_ms(void) {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+// 처음부터 끝까지 디코딩 + 임의 tic 탐색
+static int run_stats(int frames) {
+    const int first = I_GetASCIIReplayFirstTic(), last = I_GetASCIIReplayLastTic();
+    double t0 = now_ms();
+    int decoded = 1;
+    while (I_NextASCIIReplayFrame()) decoded++;
+    const double decode_ms = now_ms() - t0;
+
+    const int seeks = 200;
+    double worst = 0.0, total = 0.0;
+    uint32_t rng = 1;
+    for (int i = 0; i < seeks; ++i) {
+        rng = rng * 1103515245u + 12345u;
+        const int tic = first + (int)((rng >> 8) % (uint32_t)(last - first + 1));
+        const double s0 = now_ms();
+        if (!I_SeekASCIIReplay(tic)) {
+            fprintf(stderr, "asciiplay: seek to tic %d failed\n", tic);
+            return 1;
+        }
+        const double s = now_ms() - s0;
+        total += s;
+        worst = std::max(worst, s);
+    }
+    printf("%d frames (%d decoded), tics %d..%d (%.1f s of play)\n", frames, decoded, first, last,
+           (last - first) / (double)TICRATE);
+    printf("decode %.1f us/frame (%.0fx real time at %d fps)\n", decode_ms * 1000.0 / decoded,
+           (last - first) / (double)TICRATE * 1000.0 / std::max(decode_ms, 1e-3), TICRATE);
+    printf("seek   %.1f us avg, %.1f us worst over %d random tics\n", total * 1000.0 / seeks,
+           worst * 1000.0, seeks);
+    return decoded == frames ? 0 : 1;
+}
+
+static void usage(void) {
+    fprintf(stderr,
+            "usage: asciiplay <session> [-speed X | -fast] [-seek TIC] [-until TIC]\n"
+            "                 [-colors 24|256|16] [-cast <address>]\n"
+            "       asciiplay <session> -stats\n");
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    const char* cast = nullptr;
+    double speed = 1.0;
+    int seek = -1, until = -1, stats = 0, color_mode = ASCII_TERM_TRUECOLOR;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool has_arg = i + 1 < argc;
+        if (!std::strcmp(argv[i], "-speed") && has_arg) {
+            speed = atof(argv[++i]);
+            if (speed <= 0.0) usage();
+        } else if (!std::strcmp(argv[i], "-fast")) {
+            speed = 0.0;
+        } else if (!std::strcmp(argv[i], "-seek") && has_arg) {
+            seek = atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "-until") && has_arg) {
+            until = atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "-colors") && has_arg) {
+            const int c = atoi(argv[++i]);
+            color_mode = c == 256 ? ASCII_TERM_256 : c == 16 ? ASCII_TERM_16 : ASCII_TERM_TRUECOLOR;
+        } else if (!std::strcmp(argv[i], "-cast") && has_arg) {
+            cast = argv[++i];
+        } else if (!std::strcmp(argv[i], "-stats")) {
+            stats = 1;
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            usage();
+        }
+    }
+    if (!path) usage();
+
+    const int frames = I_OpenASCIIReplay(path);
+    if (frames <= 0) {
+        fprintf(stderr, "asciiplay: cannot open session '%s'\n", path);
+        return 2;
+    }
+    if (stats) {
+        const int r = run_stats(frames);
+        I_CloseASCIIReplay();
+        return r;
+    }
+
+    if (cast && !I_StartASCIICast(cast)) {
+        fprintf(stderr, "asciiplay: cannot listen on '%s'\n", cast);
+        return 2;
+    }
+    const int term = I_InitASCIITerm(color_mode);
+    if (!term && !cast) {
+        fprintf(stderr, "asciiplay: stdout is not a terminal (use -cast or -stats)\n");
+        I_CloseASCIIReplay();
+        return 2;
+    }
+    if (seek >= 0) I_SeekASCIIReplay(seek);
+
+    // 첫 프레임의 tic을 기준으로 벽시계에 맞춤 (-fast면 기다리지 않음)
+    const int start_tic = I_GetASCIIReplayTic();
+    const double t0 = now_ms();
+    int shown = 0, last_tic = start_tic;
+    do {
+        const int tic = I_GetASCIIReplayTic();
+        if (until >= 0 && tic > until) break;
+        if (speed > 0.0) {
+            const double due = t0 + (tic - start_tic) * 1000.0 / TICRATE / speed;
+            const double wait = due - now_ms();
+            if (wait > 0.0) std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(wait));
+        }
+        const AsciiCell* cells = I_GetASCIIReplayCells();
+        const int w = I_GetASCIIReplayWidth(), h = I_GetASCIIReplayHeight();
+        if (term) I_PresentASCIITerm(cells, w, h);
+        if (cast) I_BroadcastASCIIFrame(cells, w, h);
+        shown++;
+        last_tic = tic;
+    } while (I_NextASCIIReplayFrame());
+
+    const double elapsed = now_ms() - t0;
+    if (term) I_ShutdownASCIITerm();
+    if (cast) {
+        // 구독자에게 남은 데이터를 마저 보냄
+        for (int i = 0; i < 100; ++i) {
+            I_PumpASCIICast();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        I_StopASCIICast();
+    }
+    fprintf(stderr, "asciiplay: %d frames, tics %d..%d in %.2f s\n", shown, start_tic,
+            last_tic, elapsed / 1000.0);
+    I_CloseASCIIReplay();
+    return 0;
+}
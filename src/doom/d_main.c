@@ -52,6 +52,7 @@
 #include "m_menu.h"
 #include "p_saveg.h"
 
+#include "i_ascii.h"
 #include "i_endoom.h"
 #include "i_input.h"
 #include "i_joystick.h"
@@ -234,8 +235,14 @@ boolean D_Display (void)
     
     // clean up border stuff
     if (gamestate != oldgamestate && gamestate != GS_LEVEL)
+    {
 	I_SetPalette (W_CacheLumpName (DEH_String("PLAYPAL"),PU_CACHE));
 
+	// no status bar or view border outside a level
+	I_SetASCIIRegion(ASCII_REGION_STATUSBAR, NULL, 0);
+	I_SetASCIIRegion(ASCII_REGION_BORDER, NULL, 0);
+    }
+
     // see if the border needs to be initially drawn
     if (gamestate == GS_LEVEL && oldgamestate != GS_LEVEL)
     {
@@ -159,6 +159,10 @@ void HUlib_eraseTextLine(hu_textline_t* l)
 		// erase right border
 	    }
 	}
+
+	// R_VideoErase writes the screen directly; tell the ASCII
+	// converter the border under the text changed.
+	V_MarkRect(0, l->y, SCREENWIDTH, lh);
     }
 
     if (l->needsupdate) l->needsupdate--;
@@ -24,6 +24,7 @@
 #include "doomdef.h"
 #include "deh_main.h"
 
+#include "i_ascii.h"
 #include "i_system.h"
 #include "z_zone.h"
 #include "w_wad.h"
@@ -782,6 +783,10 @@ R_InitBuffer
     // Preclaculate all row offsets.
     for (i=0 ; i<height ; i++) 
 	ylookup[i] = I_VideoBuffer + (i+viewwindowy)*SCREENWIDTH; 
+
+    // The old border may now be part of the view; R_DrawViewBorder
+    // registers the new one with the ASCII converter.
+    I_SetASCIIRegion(ASCII_REGION_BORDER, NULL, 0);
 } 
  
  
@@ -928,12 +933,25 @@ void R_DrawViewBorder (void)
     int		side;
     int		ofs;
     int		i; 
+    int		rects[16];
  
     if (scaledviewwidth == SCREENWIDTH) 
 	return; 
   
     top = ((SCREENHEIGHT-SBARHEIGHT)-viewheight)/2; 
     side = (SCREENWIDTH-scaledviewwidth)/2; 
+
+    // Let the ASCII converter reuse the border cells until something
+    // is drawn over them: top, bottom, left and right of the view.
+    rects[0] = 0;                     rects[1] = 0;
+    rects[2] = SCREENWIDTH;           rects[3] = top;
+    rects[4] = 0;                     rects[5] = top + viewheight;
+    rects[6] = SCREENWIDTH;           rects[7] = SCREENHEIGHT - SBARHEIGHT - top - viewheight;
+    rects[8] = 0;                     rects[9] = top;
+    rects[10] = side;                 rects[11] = viewheight;
+    rects[12] = SCREENWIDTH - side;   rects[13] = top;
+    rects[14] = side;                 rects[15] = viewheight;
+    I_SetASCIIRegion(ASCII_REGION_BORDER, rects, 4);
  
     // copy top and one line of left side 
     R_VideoErase (0, top*SCREENWIDTH+side); 
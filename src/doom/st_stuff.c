@@ -23,6 +23,7 @@
 #include <stdio.h>
 #include <ctype.h>
 
+#include "i_ascii.h"
 #include "i_system.h"
 #include "i_video.h"
 #include "z_zone.h"
@@ -1000,10 +1001,16 @@ void ST_diffDraw(void)
 
 void ST_Drawer (boolean fullscreen, boolean refresh)
 {
+    static const int statusbar_rect[4] = { ST_X, ST_Y, ST_WIDTH, ST_HEIGHT };
   
     st_statusbaron = (!fullscreen) || automapactive;
     st_firsttime = st_firsttime || refresh;
 
+    // The ASCII converter reuses the status bar cells until a widget
+    // is redrawn (every widget draw goes through V_MarkRect).
+    I_SetASCIIRegion(ASCII_REGION_STATUSBAR, statusbar_rect,
+                     st_statusbaron ? 1 : 0);
+
     // Do red-/gold-shifts from damage/items
     ST_doPaletteStuff();
 
@@ -1,5 +1,4 @@
 #include "config.h"
-#ifdef __EMSCRIPTEN__
 
 #include <cstdio>
 #include <cstdlib>
@@ -7,27 +6,90 @@
 #include <cstdint>
 #include <cmath>
 #include <algorithm>
+#include <atomic>
+#include <type_traits>
+
+#ifdef __EMSCRIPTEN__
 #include <emscripten.h>
+#else
+#include <chrono>
+// 네이티브 빌드에서는 export 매크로가 의미 없음
+#define EMSCRIPTEN_KEEPALIVE
+#endif
 
 #if defined(__wasm_simd128__)
 #include <wasm_simd128.h>
 #endif
 
+// 워커 풀: 네이티브는 std::thread(pthread), Emscripten은 -pthread 빌드일 때만
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define ASCII_HAVE_THREADS 1
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+// x86 네이티브: SSSE3/AVX2 커널 (런타임 CPU 감지로 선택)
+#if !defined(__EMSCRIPTEN__) && \
+    (defined(__x86_64__) || defined(_M_X64) || \
+     ((defined(__i386__) || defined(_M_IX86)) && defined(__SSE2__)))
+#define ASCII_X86_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+#define ASCII_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define ASCII_TARGET_AVX2  __attribute__((target("avx2")))
+#else
+#define ASCII_TARGET_SSSE3
+#define ASCII_TARGET_AVX2
+#endif
+#endif
+
 #include "i_ascii.h"
 #include "i_video.h"
 
 // ===== 설정/상수 =====
-static constexpr char  ASCII_CHARS[]   = " .:-=+*#%@";
+static constexpr char  ASCII_CHARS[]   = ASCII_GLYPHS;
 static constexpr int   ASCII_CHARS_LEN = sizeof(ASCII_CHARS) - 1;
+static_assert(ASCII_CHARS_LEN <= 16, "패킹 출력은 문자 번호를 4비트에 저장");
 static constexpr float GAMMA_VALUE     = 0.35f;  // 더 밝게
 // ====================
 
-#define CELL_BUFFER_SIZE (ASCII_WIDTH * ASCII_HEIGHT)
-static AsciiCell cell_buffer[CELL_BUFFER_SIZE];
+// 문자 그리드 (런타임 변경 가능, 기본값은 i_ascii.h의 ASCII_WIDTH/HEIGHT)
+static constexpr int ASCII_GRID_MAX = 2048;  // 가로/세로 상한
+static int grid_w = ASCII_WIDTH, grid_h = ASCII_HEIGHT;
+static AsciiCell* cell_buffer = nullptr;     // grid_w * grid_h
 
 // 플래그/통계
 static bool ascii_initialized = false;
 static bool use_simd = true;
+static bool use_fused = true;   // false: 기존 2-패스(temp_r/g/b) 경로
+
+// 다운샘플 (패스1)
+static bool use_area_weighting = true;  // false: 기존 정수 경계 박스 평균 (JS 엔진과 같은 결과)
+static bool use_specialized = true;     // false: 특수화 커널 대신 항상 범용 커널
+enum AsciiDownsampleKernel {
+    ASCII_DOWNSAMPLE_INTEGRAL = 0,     // 적분영상 + 정수 경계
+    ASCII_DOWNSAMPLE_WEIGHTED,         // 범용 분수 면적 가중
+    ASCII_DOWNSAMPLE_SPECIALIZED,      // 해상도 특수화 (정수 경계 또는 분수 가중)
+    ASCII_DOWNSAMPLE_SEPARABLE,        // 가로 16비트 부분합 + 세로 누적 (두 가중 방식 공통)
+    ASCII_DOWNSAMPLE_COUNT
+};
+static AsciiDownsampleKernel downsample_kernel = ASCII_DOWNSAMPLE_INTEGRAL;
+static int downsample_request = -1;     // -1: 지오메트리별 자동 튜닝, 그 외: 고정 (불가능하면 자동)
+
+// SIMD 커널 종류 (빌드 타깃 + 런타임 CPU 감지 결과)
+enum AsciiSimdKernel {
+    ASCII_KERNEL_SCALAR = 0,
+    ASCII_KERNEL_WASM128,
+    ASCII_KERNEL_SSSE3,
+    ASCII_KERNEL_AVX2,
+};
+static AsciiSimdKernel simd_kernel = ASCII_KERNEL_SCALAR;
+static AsciiSimdKernel simd_kernel_best = ASCII_KERNEL_SCALAR;  // CPU가 지원하는 최상위 커널
+static bool simd_kernel_detected = false;
 
 // 벤치마크 모드
 static bool benchmark_mode = false;
@@ -48,20 +110,57 @@ struct BenchmarkStats {
     double avg_time_ms;
 };
 
-static constexpr uint32_t BENCHMARK_WARMUP_FRAMES = 3;  // 워밍업 3프레임
+static uint32_t benchmark_warmup_frames = 3;  // 워밍업 프레임 (벤치마크 통계/단계 히스토그램, 런타임 설정)
+static constexpr uint32_t ASCII_TUNE_WARMUP_FRAMES = 3;  // 다운샘플 커널 튜닝: 후보별 워밍업
+static constexpr uint32_t ASCII_TUNE_FRAMES = 8;         // 다운샘플 커널 튜닝: 후보별 측정 프레임
 
-static BenchmarkStats stats_simd_on = {0, 0, 0.0, 1e9, 0.0, 0.0};
-static BenchmarkStats stats_simd_off = {0, 0, 0.0, 1e9, 0.0, 0.0};
+// 파이프라인별 통계 (융합 / 2-패스) - 기존 getter는 현재 파이프라인 값을 반환
+enum { PIPE_FUSED = 0, PIPE_TWO_PASS, PIPE_COUNT };
+static constexpr BenchmarkStats EMPTY_STATS = {0, 0, 0.0, 1e9, 0.0, 0.0};
+static BenchmarkStats stats_simd_on[PIPE_COUNT] = {EMPTY_STATS, EMPTY_STATS};
+static BenchmarkStats stats_simd_off[PIPE_COUNT] = {EMPTY_STATS, EMPTY_STATS};
+static BenchmarkStats stats_dither[ASCII_DITHER_COUNT] = {EMPTY_STATS, EMPTY_STATS, EMPTY_STATS, EMPTY_STATS};
 
-// LUT
-static uint8_t gamma_table[256];  // 채널별 감마 보정
-static uint8_t idxLUT[256];       // 밝기(0..255) → 문자 인덱스
+static inline int current_pipe(void) { return use_fused ? PIPE_FUSED : PIPE_TWO_PASS; }
+
+// LUT (SIMD 셔플 테이블로도 쓰이므로 16바이트 정렬)
+alignas(16) static uint8_t gamma_table[256];  // 채널별 감마 보정
+alignas(16) static uint8_t idxLUT[256];       // 밝기(0..255) → 문자 인덱스
+alignas(16) static uint8_t ascii_chars16[16]; // 문자 인덱스 → 문자 (셔플용)
+// idxLUT는 계단 폭(≈28)이 16보다 넓어 16칸 블록마다 계단이 최대 1개:
+// idx = base[상위니블] + (하위니블 >= thr[상위니블]) 로 셔플 2번에 조회 가능
+alignas(16) static uint8_t idx_base16[16];
+alignas(16) static uint8_t idx_thr16[16];
+static bool idx_step16_ok = false;
 static bool lut_initialized = false;
 
 // (선택) 엔진 FPS/지연 추적
 static uint32_t g_ascii_frame_id = 0;
 static double   g_ascii_last_ms  = 0.0;
 
+// 직전 변환의 출력 (I_PublishASCIIFrame이 여기서 복사)
+static const AsciiCell* last_out = nullptr;
+static int last_out_w = 0, last_out_h = 0;
+
+// ===== 프레임 발행 (트리플 버퍼) =====
+// 생산자(변환 스레드)는 back 슬롯만, 소비자는 front 슬롯만 만지고 가운데 슬롯을 원자 교환으로 주고받음
+// published_slot = 가운데 슬롯 번호 | (새 프레임이면 PUBLISH_FRESH) → 어느 쪽도 기다리지 않음
+struct AsciiFrameSlot {
+    AsciiCell* cells;
+    uint16_t*  packed;            // 패킹 출력이 켜져 있을 때만 채움
+    AsciiWideCell* wide;          // 하위 셀 출력이 켜져 있을 때만 (처음 쓸 때 할당)
+    int        wide_capacity;
+    uint8_t    palette[4096 * 3]; // INDEXED 팔레트 사본
+    int        capacity;          // 셀 수
+    AsciiFrame frame;             // 소비자에게 넘기는 메타데이터 (포인터는 이 슬롯)
+};
+static constexpr uint32_t PUBLISH_FRESH = 4;
+static AsciiFrameSlot publish_slots[3];
+static std::atomic<uint32_t> published_slot(1);
+static int back_slot = 0, front_slot = 2;
+static uint32_t publish_sequence = 0;
+static uint32_t published_frame_id = 0;  // 같은 변환을 두 번 발행하지 않도록
+
 // 1초 윈도우 FPS 계산용
 static double fps_window_start_simd_on = 0.0;
 static double fps_window_start_simd_off = 0.0;
@@ -70,21 +169,509 @@ static uint32_t fps_frame_count_simd_off = 0;
 static double current_fps_simd_on = 0.0;
 static double current_fps_simd_off = 0.0;
 
+// ===== 팔레트 도메인 입력 =====
+// 8비트 I_VideoBuffer를 직접 읽을 때 쓰는 팔레트 인덱스 → 0xLLRRGGBB 테이블
+// (하위 24비트는 RGBA32 입력과 같은 배치, 상위 바이트는 팔레트 색 밝기)
+// I_SetASCIIPalette에서 팔레트가 실제로 바뀔 때만 다시 만듦
+static uint32_t pal_packed[256];
+static uint8_t  pal_rgb[256 * 3];
+static uint32_t pal_generation = 0;
+static bool     pal_valid = false;
+
+// 입력 소스 모드 (0: RGBA32 argbbuffer, 1: 8비트 팔레트 버퍼)
+static int  source_mode = ASCII_SOURCE_PAL8;
+static bool sdl_output_visible = true;  // SDL 텍스처가 화면에 보이는지
+
+// ===== 증분 변환 (더티 셀) =====
+// 직전 프레임 소스 사본과 행 단위로 비교해 바뀐 픽셀 구간만 찾고,
+// 그 구간에 걸친 셀만 직접 박스 합으로 다시 계산 (적분영상 생략)
+static bool use_incremental = true;
+static uint8_t* shadow_src = nullptr;     // 직전 프레임 소스 (원본 픽셀 형식 그대로)
+static size_t   shadow_capacity = 0;
+static int      shadow_w = 0, shadow_h = 0, shadow_bpp = 0;
+static int      shadow_aw = 0, shadow_ah = 0;
+static uint32_t shadow_generation = 0;    // 팔레트 세대 (8비트 소스)
+static const AsciiCell* shadow_out = nullptr;
+static bool     shadow_valid = false;
+static int *dirty_lo = nullptr, *dirty_hi = nullptr; // 소스 행별 변경 구간 [lo, hi)
+static int *live_lo = nullptr, *live_hi = nullptr;   // 소스 행별 비교할 구간 [lo, hi) (나머지는 깨끗한 정적 영역)
+static int  dirty_rows = 0;
+
+// 정적 화면 영역: 사각형 {x0, y0, x1, y1} (소스 픽셀), 더티가 풀린 뒤로 픽셀이 그대로라는 엔진의 약속
+struct AsciiRegion {
+    int  rects[ASCII_REGION_MAX_RECTS][4];
+    int  count;
+    bool dirty;
+};
+static AsciiRegion regions[ASCII_REGION_COUNT];
+static bool use_regions = true;
+static int  region_rows_reused = 0;   // 직전 프레임에서 직전 출력을 재사용한 셀 행 수
+
+// 셀 델타 목록 (직전 프레임 대비 실제로 바뀐 셀만)
+static AsciiCellDelta* delta_list = nullptr;  // 셀 스크래치 아레나
+static int  delta_count = 0;
+static bool delta_full = true;  // true: 전체 변환 프레임 → 소비자는 전체 다시 그리기
+static AsciiCell* row_cells = nullptr;  // 증분 경로의 셀 한 행 스크래치 (아레나)
+
+// ===== 16비트 패킹 출력 =====
+static int       packed_format = ASCII_PACKED_OFF;
+static uint16_t* packed_buffer = nullptr;   // 문자 번호 4비트 + 색 12비트
+static int       packed_capacity = 0;
+static bool      packed_valid = false;      // 직전 변환과 같은 출력/크기로 채워져 있는지 (델타 패킹 가능)
+static const AsciiCell* packed_src = nullptr;
+static int       packed_w = 0, packed_h = 0;
+static uint8_t   packed_palette[4096 * 3];  // INDEXED: 프레임별 적응 팔레트
+static int       packed_palette_count = 0;
+static uint32_t  packed_acc[4096][4];       // 키별 {개수, r합, g합, b합} (팔레트 만든 뒤 0으로)
+static uint16_t  packed_remap[4096];        // RGB444 키 → 팔레트 번호
+
+// ===== 하위 셀 출력 (반 블록/점자) =====
+static int            subcell_mode = ASCII_SUBCELL_OFF;
+static AsciiWideCell* wide_buffer = nullptr;
+static int            wide_capacity = 0;
+static bool           wide_valid = false;       // 직전 변환이 채웠는지
+static const AsciiCell* wide_src = nullptr;     // 채운 변환의 셀 출력 (발행 때 대조)
+static bool           integral_ready = false;   // 이번 프레임 적분영상이 소스 전체로 채워졌는지 (직렬 경로)
+static int            sub_mode = ASCII_SUBCELL_OFF, sub_sw = 0, sub_sh = 0, sub_aw = 0, sub_ah = 0;
+static int*           sub_x = nullptr;          // 하위 픽셀 열마다 {x0, x1}
+static int*           sub_y = nullptr;          // 하위 픽셀 행마다 {y0, y1}
+static uint32_t*      sub_inv = nullptr;        // 박스 면적 → (1 << 16) / 면적
+static int            sub_inv_size = 0;
+static void*          sub_block = nullptr;      // 평면 + 커널 출력 (32바이트 정렬)
+static uint16_t*      sub_plane = nullptr;      // 셀 한 행: 하위 행(최대 4) x {밝기, R, G, B} x sub_stride
+static int            sub_stride = 0;
+static uint32_t      *sub_bits = nullptr, *sub_fg = nullptr, *sub_bg = nullptr;  // 셀 한 행 커널 출력
+static uint8_t   glyph_index_lut[256];      // 문자 → ASCII_CHARS 번호
+
+// ===== 시간 히스테리시스 =====
+static bool use_temporal = false;
+static int  temporal_lum_margin = 6;    // 글리프 구간 폭(≈28)보다 충분히 작게
+static int  temporal_color_margin = 8;
+static AsciiCell* temporal_state = nullptr;  // character = 문자 번호
+static int  temporal_capacity = 0;
+static int  temporal_w = 0, temporal_h = 0;
+static const AsciiCell* temporal_out = nullptr;
+static bool temporal_valid = false;
+static bool temporal_tables_ready = false;
+static int  temporal_stabilized = 0;    // 직전 프레임에서 변환 결과와 다르게 내보낸 셀 수
+alignas(16) static uint8_t gamma_inv[256];     // 감마 출력 → 입력 (역상 평균)
+alignas(16) static uint8_t hold_lo16[16];      // 글리프별 유지 구간 (margin 포함, 0..255)
+alignas(16) static uint8_t hold_hi16[16];
+
+// ===== 모양 글리프 (하위 셀 밝기 서명) =====
+static bool use_shape = false;
+static int  shape_threshold = 40;        // 사분면 밝기 차가 이보다 작으면 램프 문자 유지
+static uint8_t  shape_table[4096];       // 서명 키 → 문자 (0: 램프 문자 유지)
+static bool     shape_table_ready = false;
+static int      shape_sw = 0, shape_sh = 0, shape_aw = 0, shape_ah = 0;
+static int*     shape_qx = nullptr;      // 셀 열마다 {x0, xm, x1}: 왼쪽 [x0,xm), 오른쪽 [xm,x1)
+static int*     shape_qy = nullptr;      // 셀 행마다 {y0, ym, y1}: 위 [y0,ym), 아래 [ym,y1)
+static uint32_t* shape_prefix = nullptr; // 위/아래 띠의 열 누적 밝기 2 * (src_w + 1)
+static uint32_t* shape_inv = nullptr;    // 사분면 면적 → (1 << 16) / 면적
+static int      shape_inv_size = 0;
+static int      shape_matched = 0;       // 직전 프레임에서 모양 글리프로 바꾼 셀 수 (증분 프레임은 다시 계산한 셀만)
+
+// ===== 디더링 =====
+static int     dither_mode = ASCII_DITHER_OFF;
+static int     dither_levels = 0;              // 채널별 색 단계 (0: 자동)
+static int     dither_built_mode = ASCII_DITHER_OFF, dither_built_levels = 0;
+static int     dither_w = 0, dither_h = 0;
+static void*   dither_block = nullptr;         // BAYER 오프셋 평면 2개 (그리드 전체)
+static int     dither_capacity = 0;
+static const int8_t* bayer_lum = nullptr;      // 이번 프레임 패스2가 쓸 셀별 밝기 오프셋 (끄면 NULL)
+static const int8_t* bayer_color = nullptr;    // 셀별 색 오프셋 (색 디더링 안 하면 NULL)
+alignas(16) static uint8_t dither_quant[256];  // 감마 보정 값 → 가장 가까운 색 단계 값
+static uint8_t dither_level_value[256];        // 색 단계 번호 → 값 (색 디더링 안 하면 항등)
+static float*  diffuse_block = nullptr;        // 오차 확산 행 3개 x (w + 4)칸 x {r, g, b, 밝기}
+static int     diffuse_capacity = 0;
+static float*  diffuse_rows[3];                // 현재 행, 다음 행, 그다음 행 (양옆 2칸 여백)
+alignas(16) static float diffuse_step[4], diffuse_inv[4], diffuse_keep[4];
+
+// ===== 터미널 색 양자화 (xterm 256색 / ANSI 16색) =====
+static constexpr int QUANT_CUBE_SIZE = 1 << (3 * ASCII_QUANT_BITS);
+static uint8_t* quant_cube[ASCII_QUANT_COUNT];            // 큐브 칸 → 색 번호 (+ gather 여백 3바이트)
+static uint8_t  quant_palette[ASCII_QUANT_COUNT][256 * 3]; // 색 번호 → {r, g, b}
+
+// ===== 워커 풀 (행 밴드 병렬 변환) =====
+// 작업을 행 밴드로 나눠 호출 스레드(워커 0) + 상주 스레드가 함께 처리
+// 밴드 경계와 무관하게 셀마다 같은 정수 연산 → 결과는 워커 수와 무관하게 동일
+static constexpr int ASCII_MAX_WORKERS = 8;
+static constexpr int ASCII_AUTO_WORKERS = 4;           // 자동 설정 상한 (Emscripten PTHREAD_POOL_SIZE와 맞춤)
+static constexpr int ASCII_PARALLEL_MIN_CELLS  = 32768;      // 이보다 작은 그리드/소스는
+static constexpr int ASCII_PARALLEL_MIN_PIXELS = 256 * 1024; // 동기화 비용이 더 큼
+static int    worker_request = 0;   // 0: 자동 (min(코어 수, ASCII_AUTO_WORKERS))
+static int    worker_count = 1;     // 실제 참여 워커 수 (호출 스레드 포함)
+static bool   last_frame_parallel = false;
+static double worker_busy_ms[ASCII_MAX_WORKERS];  // 이번 프레임 누적
+static double worker_last_ms[ASCII_MAX_WORKERS];  // 직전 전체 변환 프레임
+
+// 워커별 셀 한 행 버퍼 (셀 스크래치 아레나, 워커 0 = row_r/g/b)
+static uint16_t *worker_row[ASCII_MAX_WORKERS][3];
+
+// 밴드 캐리: 밴드 b 위쪽 전체의 누적 행 (R/G/B 각 I_W)
+static uint32_t* band_carry = nullptr;
+static int band_carry_size = 0;
+static int* boundary_rows = nullptr;  // 캐리 보정이 필요한 적분영상 행 (셀 경계 Y0/Y1)
+static int* boundary_band = nullptr;  // boundary_rows[i]가 속한 밴드
+static int  boundary_rows_size = 0;
+
 // ===== 적분영상/경계 버퍼 =====
 static uint32_t *I_R = nullptr, *I_G = nullptr, *I_B = nullptr; // (src_w+1)*(src_h+1)
 static int I_W = 0, I_H = 0; // integral dims
 
-static int *X0 = nullptr, *X1 = nullptr, *Y0 = nullptr, *Y1 = nullptr;
-static int *COUNT_X = nullptr, *COUNT_Y = nullptr;
-static uint32_t *INV_COUNT = nullptr;  // 역수 LUT: (1<<16) / cnt
-static int B_W = 0, B_H = 0; // ascii dims
+// ===== 지오메트리 플랜 캐시 =====
+// (src, dst) 해상도마다 경계/카운트/역수 LUT를 한 블록에 만들어 두고 재사용
+// → 몇 가지 그리드 크기를 오가도 두 번째부터는 비용 없음 (가득 차면 LRU 교체)
+struct AsciiPlan {
+    int src_w, src_h, ascii_w, ascii_h;
+    uint32_t last_used;  // 0이면 빈 슬롯
+    void* block;         // 아래 테이블 전체가 들어 있는 할당 하나
+    int *x0, *x1, *y0, *y1, *count_x, *count_y;
+    uint32_t* inv_count;
+    // 분수 면적 가중: 셀 x는 연속 구간 [x*sw/gw, (x+1)*sw/gw)를 덮음
+    // fx0/fx1: 걸치는 픽셀 구간, wx[wx_off[x] + i]: 픽셀 fx0+i와 겹친 길이 (1/PX 픽셀 단위)
+    int *fx0, *fx1, *fy0, *fy1, *wx_off, *wy_off;
+    uint16_t *wx, *wy;
+    uint64_t frac_inv;   // round(2^32 / 가중치 합)
+    bool frac_ok;        // 가중치 합이 ASCII_FRAC_MAX_WEIGHT 이하
+    bool sep_ok[2];      // [정수 경계, 분수 가중] 셀 열 가로 부분합이 16비트에 들어가는지
+    // 다운샘플 커널 자동 튜닝 ([가중 방식][커널]), tuned < 0이면 측정 중
+    BenchmarkStats tune[2][ASCII_DOWNSAMPLE_COUNT];
+    int tuned[2];
+};
+static constexpr int ASCII_PLAN_CACHE = 8;
+// 분수 가중 합 상한: 255 * 합 < 2^31 (초과하면 정수 경계 박스 평균으로)
+static constexpr int64_t ASCII_FRAC_MAX_WEIGHT = 1 << 23;
+static AsciiPlan plan_cache[ASCII_PLAN_CACHE];
+static uint32_t plan_clock = 0;
+
+static AsciiPlan* cur_plan = nullptr;
+
+// 현재 플랜의 테이블 (변환 코드는 이 이름으로 접근)
+static const int *X0 = nullptr, *X1 = nullptr, *Y0 = nullptr, *Y1 = nullptr;
+static const int *COUNT_X = nullptr, *COUNT_Y = nullptr;
+static const uint32_t *INV_COUNT = nullptr;  // 역수 LUT: (1<<16) / cnt
 
-// 임시 RGB 버퍼 (SIMD용 연속 메모리)
+// ===== 셀 스크래치 아레나 =====
+// 그리드 크기에 비례하는 작업 버퍼를 한 번의 할당에서 32바이트 단위로 잘라 씀:
+// 2-패스 평면(temp_r/g/b), 워커별 행 버퍼, 델타 목록, 증분 행 셀
+static void* scratch_block = nullptr;
+static int scratch_cells = 0, scratch_width = 0;
+
+// 임시 RGB 버퍼 (2-패스 경로 전용, SIMD용 연속 메모리)
 static uint16_t *temp_r = nullptr, *temp_g = nullptr, *temp_b = nullptr;
-static int temp_size = 0;
+
+// 융합 경로의 셀 한 행 평균 버퍼 (L1 상주, worker_row[0])
+static uint16_t *row_r = nullptr, *row_g = nullptr, *row_b = nullptr;
+
+// 분리형 다운샘플 워커별 스크래치 (아레나): 셀 열 가로 부분합(16비트 레인 ×3) + 세로 누적(32비트)
+// sep_row: 부분합에 들어 있는 소스 행 (sep_frame이 같을 때만 유효, 분수 가중의 경계 행 재사용)
+static uint64_t *sep_h[ASCII_MAX_WORKERS];
+static uint32_t *sep_acc[ASCII_MAX_WORKERS][3];
+static int      sep_row[ASCII_MAX_WORKERS];
+static uint32_t sep_row_frame[ASCII_MAX_WORKERS];
+static uint32_t sep_frame = 0;  // 전체 변환마다 증가
 // ==============================
 
-extern "C" {
+// ---------- 플랫폼 공통 헬퍼 ----------
+
+// 밀리초 단위 단조 시계 (emscripten_get_now 대체)
+static double ascii_now_ms(void) {
+#ifdef __EMSCRIPTEN__
+    return emscripten_get_now();
+#else
+    using namespace std::chrono;
+    return duration<double, std::milli>(
+        steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// 정렬 할당 - size를 alignment의 배수로 올림 (aligned_alloc 요구사항)
+static void* ascii_aligned_alloc(size_t alignment, size_t byte_size) {
+    size_t aligned_size = (byte_size + alignment - 1) & ~(alignment - 1);
+#ifdef _WIN32
+    return _aligned_malloc(aligned_size, alignment);
+#else
+    return aligned_alloc(alignment, aligned_size);
+#endif
+}
+
+static void ascii_aligned_free(void* p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+// 나노초 단위 단조 시계 (단계 히스토그램용, Emscripten은 performance.now 정밀도를 따름)
+static uint64_t ascii_now_ns(void) {
+#ifdef __EMSCRIPTEN__
+    return (uint64_t)(emscripten_get_now() * 1e6);
+#else
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(
+        steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// ---------- 단계별 지연 히스토그램 ----------
+// 로그-선형(HDR 방식) 버킷: 2의 거듭제곱 구간마다 32칸 → 상대 오차 <= 1/32
+// 단계 시간은 프레임 안에서 누적한 뒤 프레임 끝에 단계마다 한 번 기록
+// (융합 경로는 패스1/2가 행 단위로 섞이므로 합쳐서 cells_fused, 분리하려면 ascii_set_fused(0))
+enum AsciiStage {
+    STAGE_SETUP = 0,     // LUT/플랜/스크래치/적분영상 용량 확보 (재할당 포함)
+    STAGE_DIRTY_SCAN,    // 증분: 소스 사본 비교
+    STAGE_DIRTY_CELLS,   // 증분: 더티 셀 재계산
+    STAGE_INTEGRAL,      // 적분영상 (병렬이면 밴드 + 캐리 보정)
+    STAGE_CELLS_FUSED,   // 융합 패스1+2
+    STAGE_PASS1,         // 2-패스: 셀 평균
+    STAGE_PASS2,         // 2-패스: 밝기/문자/감마
+    STAGE_SHAPE,         // 모양 글리프 (사분면 밝기 서명)
+    STAGE_SUBCELL,       // 하위 셀 출력 (반 블록/점자)
+    STAGE_TEMPORAL,      // 시간 히스테리시스
+    STAGE_PACK,          // 16비트 패킹 출력
+    STAGE_TOTAL,         // 변환 전체
+    STAGE_COUNT
+};
+static const char* const stage_names[STAGE_COUNT] = {
+    "setup", "dirty_scan", "dirty_cells", "integral",
+    "cells_fused", "pass1", "pass2", "shape", "subcell", "temporal", "pack", "total"
+};
+
+static constexpr int HIST_SUB_BITS = 5;
+static constexpr int HIST_SUB = 1 << HIST_SUB_BITS;
+static constexpr int HIST_MAX_BITS = 40;  // 2^40ns ≈ 18분까지, 그 이상은 마지막 버킷
+static constexpr int HIST_BUCKETS = (HIST_MAX_BITS - HIST_SUB_BITS + 1) * HIST_SUB;
+
+struct LatencyHistogram {
+    uint32_t counts[HIST_BUCKETS];
+    uint64_t count;
+    uint64_t sum_ns, min_ns, max_ns;
+};
+
+static bool stage_timing = true;
+static LatencyHistogram stage_hist[STAGE_COUNT];
+static uint64_t stage_frame_ns[STAGE_COUNT];  // 이번 프레임 누적
+static bool     stage_ran[STAGE_COUNT];
+static uint32_t stage_warmup_seen = 0;        // 리셋 후 지나간 워밍업 프레임
+static uint64_t stage_frames = 0;             // 기록된 프레임
+
+static inline int hist_bucket(uint64_t v) {
+    if (v < (uint64_t)HIST_SUB) return (int)v;
+    int msb = 63;
+    while (!(v >> msb)) --msb;
+    const int shift = msb - HIST_SUB_BITS;
+    const int idx = (shift + 1) * HIST_SUB + (int)((v >> shift) - HIST_SUB);
+    return std::min(idx, HIST_BUCKETS - 1);
+}
+
+// 버킷에 들어가는 가장 큰 값 (꼬리 지연을 낮춰 보고하지 않도록)
+static inline uint64_t hist_bucket_high(int idx) {
+    if (idx < HIST_SUB) return (uint64_t)idx;
+    const int shift = idx / HIST_SUB - 1;
+    const uint64_t top = (uint64_t)(HIST_SUB + idx % HIST_SUB);
+    return ((top + 1) << shift) - 1;
+}
+
+static void hist_record(LatencyHistogram& h, uint64_t ns) {
+    h.counts[hist_bucket(ns)]++;
+    if (h.count == 0 || ns < h.min_ns) h.min_ns = ns;
+    if (ns > h.max_ns) h.max_ns = ns;
+    h.sum_ns += ns;
+    h.count++;
+}
+
+static uint64_t hist_percentile(const LatencyHistogram& h, double p) {
+    if (h.count == 0) return 0;
+    const uint64_t rank = std::max<uint64_t>(1, (uint64_t)std::ceil(p * (double)h.count));
+    uint64_t seen = 0;
+    for (int i = 0; i < HIST_BUCKETS; ++i) {
+        seen += h.counts[i];
+        if (seen >= rank) return std::min(hist_bucket_high(i), h.max_ns);
+    }
+    return h.max_ns;
+}
+
+static void reset_stage_stats(void) {
+    std::memset(stage_hist, 0, sizeof(stage_hist));
+    stage_warmup_seen = 0;
+    stage_frames = 0;
+}
+
+static inline uint64_t stage_clock(void) {
+    return stage_timing ? ascii_now_ns() : 0;
+}
+
+// 단계 s에 (지금 - t)를 더하고 지금을 돌려줌 → 연속 구간을 t = stage_mark(...)로 이어 잼
+static inline uint64_t stage_mark(AsciiStage s, uint64_t t) {
+    if (!stage_timing) return 0;
+    const uint64_t now = ascii_now_ns();
+    stage_frame_ns[s] += now - t;
+    stage_ran[s] = true;
+    return now;
+}
+
+static inline void stage_begin_frame(void) {
+    std::fill(stage_frame_ns, stage_frame_ns + STAGE_COUNT, (uint64_t)0);
+    std::fill(stage_ran, stage_ran + STAGE_COUNT, false);
+}
+
+static void stage_commit_frame(void) {
+    if (!stage_timing) return;
+    if (stage_warmup_seen < benchmark_warmup_frames) {
+        stage_warmup_seen++;
+        return;
+    }
+    for (int s = 0; s < STAGE_COUNT; ++s) {
+        if (stage_ran[s]) hist_record(stage_hist[s], stage_frame_ns[s]);
+    }
+    stage_frames++;
+}
+
+// ---------- 워커 풀 ----------
+typedef void (*AsciiJob)(int worker, int workers, void* ctx);
+
+#ifdef ASCII_HAVE_THREADS
+// 힙에 두고 종료 시에만 join (정적 std::thread 소멸자가 exit 경로에서 terminate하지 않도록)
+static std::thread* pool_threads[ASCII_MAX_WORKERS - 1];
+static int pool_thread_count = 0;
+static std::mutex pool_mutex;
+static std::condition_variable pool_start_cv, pool_done_cv;
+static AsciiJob pool_job = nullptr;
+static void*    pool_ctx = nullptr;
+static int      pool_job_workers = 0;
+static uint32_t pool_generation = 0;
+static int      pool_pending = 0;
+static bool     pool_quit = false;
+
+// seen: 생성 시점의 세대 (그 이전 작업은 이미 끝났으므로 건너뜀)
+static void pool_worker_main(int id, uint32_t seen) {
+    for (;;) {
+        AsciiJob job; void* ctx; int workers;
+        {
+            std::unique_lock<std::mutex> lock(pool_mutex);
+            pool_start_cv.wait(lock, [&] { return pool_quit || pool_generation != seen; });
+            if (pool_quit) return;
+            seen = pool_generation;
+            job = pool_job; ctx = pool_ctx; workers = pool_job_workers;
+        }
+        if (id < workers) {
+            const double t0 = ascii_now_ms();
+            job(id, workers, ctx);
+            worker_busy_ms[id] += ascii_now_ms() - t0;
+        }
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            if (--pool_pending == 0) pool_done_cv.notify_one();
+        }
+    }
+}
+
+static void pool_stop(void) {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        pool_quit = true;
+    }
+    pool_start_cv.notify_all();
+    for (int i = 0; i < pool_thread_count; ++i) {
+        pool_threads[i]->join();
+        delete pool_threads[i];
+        pool_threads[i] = nullptr;
+    }
+    pool_thread_count = 0;
+    pool_quit = false;
+}
+
+// 처음 병렬 작업이 올 때 시작. I_ShutdownASCII를 거치지 않는 exit() (I_Error 등)에서도
+// 대기 중인 워커가 정적 condition_variable 소멸을 막지 않도록 atexit로 정리
+static void pool_start(int workers) {
+    static bool pool_atexit_registered = false;
+    if (pool_thread_count == workers - 1) return;
+    pool_stop();
+    if (!pool_atexit_registered) {
+        atexit(pool_stop);
+        pool_atexit_registered = true;
+    }
+    for (int i = 1; i < workers; ++i) {
+        pool_threads[i - 1] = new std::thread(pool_worker_main, i, pool_generation);
+    }
+    pool_thread_count = workers - 1;
+}
+#endif
+
+// 요청 값(0=자동)에 맞춰 워커 수 결정. 스레드는 pool_run이 필요할 때 시작
+static void update_worker_count(void) {
+    int n = 1;
+#ifdef ASCII_HAVE_THREADS
+    if (worker_request > 0) {
+        n = worker_request;
+    } else {
+        const int hw = (int)std::thread::hardware_concurrency();
+        n = std::min(std::max(hw, 1), ASCII_AUTO_WORKERS);
+    }
+    n = std::min(std::max(n, 1), ASCII_MAX_WORKERS);
+    if (pool_thread_count != n - 1) pool_stop();
+#endif
+    worker_count = n;
+}
+
+// job(i, workers, ctx)를 워커 0..workers-1에서 실행하고 모두 끝날 때까지 대기
+// (워커 0은 호출 스레드, workers <= worker_count). worker_busy_ms에 워커별 시간 누적
+static void pool_run(AsciiJob job, void* ctx, int workers) {
+#ifdef ASCII_HAVE_THREADS
+    if (workers > 1) pool_start(worker_count);
+    const bool wake = workers > 1 && pool_thread_count > 0;
+    if (wake) {
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            pool_job = job; pool_ctx = ctx; pool_job_workers = workers;
+            pool_pending = pool_thread_count;
+            ++pool_generation;
+        }
+        pool_start_cv.notify_all();
+    }
+#endif
+    const double t0 = ascii_now_ms();
+    job(0, workers, ctx);
+    worker_busy_ms[0] += ascii_now_ms() - t0;
+#ifdef ASCII_HAVE_THREADS
+    if (wake) {
+        std::unique_lock<std::mutex> lock(pool_mutex);
+        pool_done_cv.wait(lock, [] { return pool_pending == 0; });
+    }
+#endif
+}
+
+// 사용할 SIMD 커널 결정 (한 번만)
+static void detect_simd_kernel(void) {
+    if (simd_kernel_detected) return;
+    simd_kernel = ASCII_KERNEL_SCALAR;
+#if defined(__wasm_simd128__)
+    simd_kernel = ASCII_KERNEL_WASM128;
+#elif defined(ASCII_X86_SIMD)
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    const bool has_ssse3 = (info[2] & (1 << 9)) != 0;
+    // AVX2: CPUID.7.EBX[5] + OS의 YMM 상태 저장(OSXSAVE/XGETBV) 확인
+    bool has_avx2 = false;
+    if ((info[2] & (1 << 27)) && (info[2] & (1 << 28))
+     && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        has_avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    const bool has_ssse3 = __builtin_cpu_supports("ssse3");
+    const bool has_avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (has_avx2) simd_kernel = ASCII_KERNEL_AVX2;
+    else if (has_ssse3) simd_kernel = ASCII_KERNEL_SSSE3;
+#endif
+    simd_kernel_best = simd_kernel;
+    simd_kernel_detected = true;
+}
 
 // ---------- LUT 초기화 ----------
 static void init_luts_once(void) {
@@ -104,15 +691,311 @@ static void init_luts_once(void) {
         else if (idx >= ASCII_CHARS_LEN) idx = ASCII_CHARS_LEN - 1;
         idxLUT[b] = (uint8_t)idx;
     }
+    std::memset(ascii_chars16, ' ', sizeof(ascii_chars16));
+    std::memcpy(ascii_chars16, ASCII_CHARS, ASCII_CHARS_LEN);
+    std::memset(glyph_index_lut, 0, sizeof(glyph_index_lut));
+    for (int k = 0; k < ASCII_CHARS_LEN; ++k) glyph_index_lut[(uint8_t)ASCII_CHARS[k]] = (uint8_t)k;
+    // 니블 분할 계단 테이블 (조건이 깨지면 SIMD는 256엔트리 셔플로 폴백)
+    idx_step16_ok = true;
+    for (int h = 0; h < 16; ++h) {
+        const uint8_t* blk = &idxLUT[16 * h];
+        int thr = 16;
+        for (int l = 1; l < 16; ++l) {
+            if (blk[l] != blk[0]) { thr = l; break; }
+        }
+        for (int l = thr; l < 16; ++l) {
+            if (blk[l] != blk[0] + 1) idx_step16_ok = false;
+        }
+        idx_base16[h] = blk[0];
+        idx_thr16[h]  = (uint8_t)thr;
+    }
     lut_initialized = true;
 }
 
+// ---------- 터미널 색 양자화 ----------
+// xterm 큐브는 채널별로 나뉘므로 큐브 안 최근접 = 채널마다 가장 가까운 단계, 회색 단계는 평균에 가장 가까운 것
+// → 둘 중 가까운 쪽이 정확한 최근접 (0..15는 터미널마다 달라 제외). ANSI 16색은 16개 전부와 비교 (같으면 작은 번호)
+// 큐브 칸(4x4x4 값) 안의 모든 색이 같은 최근접이면 그 번호, 아니면 quant_exact_mark 표시 → 그 셀만 정확히 계산
+// 최근접 영역은 볼록하고 두 색의 거리 차는 좌표에 대해 선형이므로 칸 모서리 범위만 보면 판정이 정확함
+static const uint8_t quant_cube_levels[6] = { 0, 95, 135, 175, 215, 255 };
+static const uint8_t quant_ansi16[16][3] = {
+    {   0,   0,   0 }, { 205,   0,   0 }, {   0, 205,   0 }, { 205, 205,   0 },
+    {   0,   0, 238 }, { 205,   0, 205 }, {   0, 205, 205 }, { 229, 229, 229 },
+    { 127, 127, 127 }, { 255,   0,   0 }, {   0, 255,   0 }, { 255, 255,   0 },
+    {  92,  92, 255 }, { 255,   0, 255 }, {   0, 255, 255 }, { 255, 255, 255 },
+};
+// 그 대상이 내지 않는 번호를 "정확히 계산" 표시로 씀 (xterm은 0..15를 안 씀, ANSI는 16 이상을 안 씀)
+static const uint8_t quant_exact_mark[ASCII_QUANT_COUNT] = { 0, 0xFF };
+
+static inline int quant_dist2(int r0, int g0, int b0, const uint8_t* c) {
+    return (r0 - c[0]) * (r0 - c[0]) + (g0 - c[1]) * (g0 - c[1]) + (b0 - c[2]) * (b0 - c[2]);
+}
+
+static inline int quant_cube_step(int v) {
+    // 단계 사이 중간값 기준
+    return v < 48 ? 0 : v < 115 ? 1 : (v - 35) / 40;
+}
+
+static inline int quant_gray_step(int sum) {
+    // 회색 8 + 10i: i = round((평균 - 8) / 10) = round((합 - 24) / 30)
+    return std::min(23, std::max(0, (sum - 9) / 30));
+}
+
+static int quant_nearest(int target, int r, int g, int b) {
+    if (target == ASCII_QUANT_XTERM256) {
+        const int cube = 16 + 36 * quant_cube_step(r) + 6 * quant_cube_step(g) + quant_cube_step(b);
+        const int gray = 232 + quant_gray_step(r + g + b);
+        return quant_dist2(r, g, b, quant_palette[target] + gray * 3) <
+               quant_dist2(r, g, b, quant_palette[target] + cube * 3) ? gray : cube;
+    }
+    int best = 0, best_d = 1 << 30;
+    for (int i = 0; i < 16; ++i) {
+        const int d = quant_dist2(r, g, b, quant_ansi16[i]);
+        if (d < best_d) { best_d = d; best = i; }
+    }
+    return best;
+}
+
+// 색 번호 → {r, g, b} 표 (큐브보다 먼저, 한 번만)
+static void quant_init_palettes(void) {
+    if (quant_palette[ASCII_QUANT_XTERM256][255 * 3]) return;  // 마지막 회색 238
+    for (int i = 0; i < 16; ++i) std::memcpy(quant_palette[ASCII_QUANT_XTERM256] + i * 3, quant_ansi16[i], 3);
+    for (int i = 0; i < 216; ++i) {
+        uint8_t* c = quant_palette[ASCII_QUANT_XTERM256] + (16 + i) * 3;
+        c[0] = quant_cube_levels[i / 36];
+        c[1] = quant_cube_levels[(i / 6) % 6];
+        c[2] = quant_cube_levels[i % 6];
+    }
+    for (int i = 0; i < 24; ++i) {
+        std::memset(quant_palette[ASCII_QUANT_XTERM256] + (232 + i) * 3, 8 + 10 * i, 3);
+    }
+    std::memcpy(quant_palette[ASCII_QUANT_ANSI16], quant_ansi16, sizeof(quant_ansi16));
+}
+
+// 칸 [lo, lo + 3]^3 전체에서 색 a가 색 b보다 엄격히 가까운지
+// d_b - d_a = Σ 2x(a - b) + |b|² - |a|²는 x에 대해 선형 → 축마다 작아지는 쪽 끝의 값이 최솟값
+static inline bool quant_wins_box(const uint8_t* a, const uint8_t* b, const int* lo) {
+    int m = 0;
+    for (int k = 0; k < 3; ++k) {
+        const int w = 2 * (a[k] - b[k]);
+        m += w * (w >= 0 ? lo[k] : lo[k] + 3) + b[k] * b[k] - a[k] * a[k];
+    }
+    return m > 0;
+}
+
+// 칸 모서리 lo의 최근접이 칸 안 후보 전부를 이기면 그 번호 (모서리에서 지는 색은 칸 전체에서 이길 수 없음)
+// 같은 거리가 생기는 칸은 표시만 하고 정확한 계산의 순서 규칙에 맡김
+static uint8_t quant_bin(int target, const int* lo) {
+    const uint8_t* pal = quant_palette[target];
+    if (target == ASCII_QUANT_ANSI16) {
+        int d[16], best = 0;
+        for (int j = 0; j < 16; ++j) {
+            d[j] = quant_dist2(lo[0], lo[1], lo[2], pal + j * 3);
+            if (d[j] < d[best]) best = j;
+        }
+        // 칸 안에서 거리 차는 모서리 값에서 최대 Σ 6|a - b| ≤ 6*765만큼 줄어듦 → 그보다 먼 색은 검사 생략
+        for (int j = 0; j < 16; ++j) {
+            if (j != best && d[j] - d[best] <= 6 * 765 &&
+                !quant_wins_box(pal + best * 3, pal + j * 3, lo)) return quant_exact_mark[target];
+        }
+        return (uint8_t)best;
+    }
+    const int best = quant_nearest(target, lo[0], lo[1], lo[2]);
+    // xterm: 칸 안에서 나올 수 있는 후보는 채널별 큐브 단계 최대 2개씩, 회색 단계 최대 2개
+    int lo_step[3], hi_step[3];
+    for (int k = 0; k < 3; ++k) {
+        lo_step[k] = quant_cube_step(lo[k]);
+        hi_step[k] = quant_cube_step(lo[k] + 3);
+    }
+    for (int r = lo_step[0]; r <= hi_step[0]; ++r) {
+        for (int g = lo_step[1]; g <= hi_step[1]; ++g) {
+            for (int b = lo_step[2]; b <= hi_step[2]; ++b) {
+                const int c = 16 + 36 * r + 6 * g + b;
+                if (c != best && !quant_wins_box(pal + best * 3, pal + c * 3, lo)) return quant_exact_mark[target];
+            }
+        }
+    }
+    const int sum = lo[0] + lo[1] + lo[2];
+    for (int gi = quant_gray_step(sum); gi <= quant_gray_step(sum + 9); ++gi) {
+        const int c = 232 + gi;
+        if (c != best && !quant_wins_box(pal + best * 3, pal + c * 3, lo)) return quant_exact_mark[target];
+    }
+    return (uint8_t)best;
+}
+
+// 큐브 하나 256KB. 쓰는 쪽(터미널 초기화 등)이 처음 요청할 때 한 번 만듦
+static bool quant_build(int target) {
+    if (quant_cube[target]) return true;
+    quant_init_palettes();
+    uint8_t* cube = (uint8_t*)ascii_aligned_alloc(32, QUANT_CUBE_SIZE + 32);
+    if (!cube) return false;
+    uint8_t* p = cube;
+    int lo[3];
+    for (lo[0] = 0; lo[0] < 256; lo[0] += 4) {
+        for (lo[1] = 0; lo[1] < 256; lo[1] += 4) {
+            for (lo[2] = 0; lo[2] < 256; lo[2] += 4) {
+                *p++ = quant_bin(target, lo);
+            }
+        }
+    }
+    std::memset(p, 0, 32);  // gather가 끝 칸에서 읽는 여백
+    quant_cube[target] = cube;
+    return true;
+}
+
+static void quant_free(void) {
+    for (int t = 0; t < ASCII_QUANT_COUNT; ++t) {
+        ascii_aligned_free(quant_cube[t]);
+        quant_cube[t] = nullptr;
+    }
+}
+
+static inline int quant_lookup(int target, int r, int g, int b) {
+    const uint8_t v = quant_cube[target][((r >> 2) << 12) | ((g >> 2) << 6) | (b >> 2)];
+    return v != quant_exact_mark[target] ? v : quant_nearest(target, r, g, b);
+}
+
+// 셀 dword = 문자 | r << 8 | g << 16 | b << 24 → 칸 번호 (r6 << 12) | (g6 << 6) | b6
+static inline uint32_t quant_key(uint32_t v) {
+    return ((v << 2) & 0x3F000u) | ((v >> 12) & 0xFC0u) | (v >> 26);
+}
+
+typedef void (*QuantKernel)(int, const AsciiCell*, uint8_t*, int);
+
+static void quant_cells_scalar(int target, const AsciiCell* cells, uint8_t* out, int n) {
+    const uint8_t* cube = quant_cube[target];
+    const uint8_t mark = quant_exact_mark[target];
+    for (int i = 0; i < n; ++i) {
+        uint32_t v;
+        std::memcpy(&v, cells + i, 4);
+        const uint8_t q = cube[quant_key(v)];
+        out[i] = q != mark ? q : (uint8_t)quant_nearest(target, cells[i].r, cells[i].g, cells[i].b);
+    }
+}
+
+// 표시된 칸에 떨어진 셀만 정확히 다시 계산 (벡터 경로 뒤처리)
+static inline void quant_fix_exact(int target, const AsciiCell* cells, uint8_t* out, int n) {
+    const uint8_t mark = quant_exact_mark[target];
+    for (int i = 0; i < n; ++i) {
+        if (out[i] == mark) out[i] = (uint8_t)quant_nearest(target, cells[i].r, cells[i].g, cells[i].b);
+    }
+}
+
+#if defined(__wasm_simd128__)
+// gather가 없으므로 칸 번호만 벡터로 만들고 조회는 레인별
+static void quant_cells_wasm128(int target, const AsciiCell* cells, uint8_t* out, int n) {
+    const uint8_t* cube = quant_cube[target];
+    const v128_t mark = wasm_i32x4_splat(quant_exact_mark[target]);
+    int i = 0;
+    for (; i <= n - 4; i += 4) {
+        const v128_t v = wasm_v128_load(cells + i);
+        const v128_t key = wasm_v128_or(
+            wasm_v128_or(wasm_v128_and(wasm_i32x4_shl(v, 2), wasm_i32x4_splat(0x3F000)),
+                         wasm_v128_and(wasm_u32x4_shr(v, 12), wasm_i32x4_splat(0xFC0))),
+            wasm_u32x4_shr(v, 26));
+        const v128_t q = wasm_i32x4_make(cube[wasm_i32x4_extract_lane(key, 0)],
+                                         cube[wasm_i32x4_extract_lane(key, 1)],
+                                         cube[wasm_i32x4_extract_lane(key, 2)],
+                                         cube[wasm_i32x4_extract_lane(key, 3)]);
+        out[i + 0] = (uint8_t)wasm_i32x4_extract_lane(q, 0);
+        out[i + 1] = (uint8_t)wasm_i32x4_extract_lane(q, 1);
+        out[i + 2] = (uint8_t)wasm_i32x4_extract_lane(q, 2);
+        out[i + 3] = (uint8_t)wasm_i32x4_extract_lane(q, 3);
+        if (wasm_v128_any_true(wasm_i32x4_eq(q, mark))) quant_fix_exact(target, cells + i, out + i, 4);
+    }
+    quant_cells_scalar(target, cells + i, out + i, n - i);
+}
+#endif
+
+#if defined(ASCII_X86_SIMD)
+// 셀 8개 → 칸 번호 8개 → gather(칸에서 4바이트, 여백 덕분에 끝 칸도 안전) → 하위 바이트만 모아 8바이트 저장
+ASCII_TARGET_AVX2
+static void quant_cells_avx2(int target, const AsciiCell* cells, uint8_t* out, int n) {
+    const uint8_t* cube = quant_cube[target];
+    const __m256i lo6 = _mm256_set1_epi32(0x3F000);
+    const __m256i mid6 = _mm256_set1_epi32(0xFC0);
+    const __m256i mark = _mm256_set1_epi8((char)quant_exact_mark[target]);
+    // 레인마다 하위 바이트를 128비트 레인의 앞 4바이트로
+    const __m256i take = _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                          0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    int i = 0;
+    for (; i <= n - 8; i += 8) {
+        const __m256i v = _mm256_loadu_si256((const __m256i*)(cells + i));
+        const __m256i key = _mm256_or_si256(
+            _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(v, 2), lo6),
+                            _mm256_and_si256(_mm256_srli_epi32(v, 12), mid6)),
+            _mm256_srli_epi32(v, 26));
+        const __m256i got = _mm256_shuffle_epi8(_mm256_i32gather_epi32((const int*)cube, key, 1), take);
+        const uint32_t a = (uint32_t)_mm_cvtsi128_si32(_mm256_castsi256_si128(got));
+        const uint32_t b = (uint32_t)_mm_cvtsi128_si32(_mm256_extracti128_si256(got, 1));
+        std::memcpy(out + i, &a, 4);
+        std::memcpy(out + i + 4, &b, 4);
+        // 앞 4바이트(0x000F000F)만 유효
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(got, mark)) & 0x000F000F) {
+            quant_fix_exact(target, cells + i, out + i, 8);
+        }
+    }
+    quant_cells_scalar(target, cells + i, out + i, n - i);
+}
+#endif
+
+static QuantKernel select_quant_kernel(void) {
+    if (!use_simd) return quant_cells_scalar;
+    switch (simd_kernel) {
+#if defined(__wasm_simd128__)
+    case ASCII_KERNEL_WASM128: return quant_cells_wasm128;
+#endif
+#if defined(ASCII_X86_SIMD)
+    case ASCII_KERNEL_AVX2:    return quant_cells_avx2;
+#endif
+    default:                   return quant_cells_scalar;
+    }
+}
+
+// ---------- 프레임 발행 슬롯 ----------
+static bool ensure_slot_capacity(AsciiFrameSlot& slot, int cells) {
+    if (slot.cells && slot.capacity >= cells) return true;
+    AsciiCell* c = (AsciiCell*)ascii_aligned_alloc(32, sizeof(AsciiCell) * (size_t)cells);
+    uint16_t* p = (uint16_t*)ascii_aligned_alloc(32, sizeof(uint16_t) * (size_t)cells);
+    if (!c || !p) {
+        ascii_aligned_free(c);
+        ascii_aligned_free(p);
+        return false;
+    }
+    ascii_aligned_free(slot.cells);
+    ascii_aligned_free(slot.packed);
+    slot.cells = c;
+    slot.packed = p;
+    slot.capacity = cells;
+    return true;
+}
+
+static void free_publish_slots(void) {
+    for (AsciiFrameSlot& slot : publish_slots) {
+        ascii_aligned_free(slot.cells);
+        ascii_aligned_free(slot.packed);
+        ascii_aligned_free(slot.wide);
+        std::memset(&slot.frame, 0, sizeof(slot.frame));
+        slot.cells = nullptr;
+        slot.packed = nullptr;
+        slot.wide = nullptr;
+        slot.capacity = 0;
+        slot.wide_capacity = 0;
+    }
+    published_slot.store(1);
+    back_slot = 0;
+    front_slot = 2;
+    published_frame_id = g_ascii_frame_id;
+}
+
 // ---------- API ----------
 void I_InitASCII(void) {
     if (ascii_initialized) return;
     init_luts_once();
-    std::memset(cell_buffer, 0, sizeof(cell_buffer));
+    detect_simd_kernel();
+    update_worker_count();
     ascii_initialized = true;
+    I_SetASCIIGrid(grid_w, grid_h);
 }
 
 void I_ShutdownASCII(void) {
@@ -120,29 +1003,132 @@ void I_ShutdownASCII(void) {
     ascii_initialized = false;
 
     free(I_R); free(I_G); free(I_B); I_R=I_G=I_B=nullptr; I_W=I_H=0;
-    free(X0); free(X1); free(Y0); free(Y1);
-    free(COUNT_X); free(COUNT_Y); free(INV_COUNT);
-    X0=X1=Y0=Y1=COUNT_X=COUNT_Y=nullptr; INV_COUNT=nullptr; B_W=B_H=0;
-    free(temp_r); free(temp_g); free(temp_b);
-    temp_r=temp_g=temp_b=nullptr; temp_size=0;
+    for (int i = 0; i < ASCII_PLAN_CACHE; ++i) free(plan_cache[i].block);
+    std::memset(plan_cache, 0, sizeof(plan_cache));
+    X0=X1=Y0=Y1=COUNT_X=COUNT_Y=nullptr; INV_COUNT=nullptr; cur_plan=nullptr;
+    ascii_aligned_free(scratch_block); scratch_block=nullptr; scratch_cells=scratch_width=0;
+    temp_r=temp_g=temp_b=nullptr; row_r=row_g=row_b=nullptr;
+    std::memset(worker_row, 0, sizeof(worker_row));
+    std::memset(sep_h, 0, sizeof(sep_h)); std::memset(sep_acc, 0, sizeof(sep_acc));
+    delta_list=nullptr; row_cells=nullptr;
+    ascii_aligned_free(cell_buffer); cell_buffer=nullptr;
+    last_out=nullptr; last_out_w=last_out_h=0;
+    free_publish_slots();
+    ascii_aligned_free(packed_buffer); packed_buffer=nullptr; packed_capacity=0;
+    packed_valid=false; packed_src=nullptr; packed_palette_count=0;
+    free(shadow_src); shadow_src=nullptr; shadow_capacity=0; shadow_valid=false;
+    free(dirty_lo); free(dirty_hi); dirty_lo=dirty_hi=nullptr; dirty_rows=0;
+    free(live_lo); free(live_hi); live_lo=live_hi=nullptr;
+    delta_count=0; delta_full=true;
+    ascii_aligned_free(temporal_state); temporal_state=nullptr; temporal_capacity=0;
+    temporal_valid=false; temporal_out=nullptr; temporal_tables_ready=false;
+    free(shape_qx); free(shape_qy); free(shape_prefix); free(shape_inv);
+    shape_qx=shape_qy=nullptr; shape_prefix=shape_inv=nullptr; shape_inv_size=0;
+    shape_sw=shape_sh=shape_aw=shape_ah=0;
+    ascii_aligned_free(wide_buffer); wide_buffer=nullptr; wide_capacity=0; wide_valid=false; wide_src=nullptr;
+    free(sub_x); free(sub_y); free(sub_inv); ascii_aligned_free(sub_block);
+    sub_x=sub_y=nullptr; sub_inv=nullptr; sub_block=nullptr; sub_plane=nullptr;
+    sub_bits=sub_fg=sub_bg=nullptr; sub_inv_size=sub_stride=0;
+    sub_mode=ASCII_SUBCELL_OFF; sub_sw=sub_sh=sub_aw=sub_ah=0;
+    ascii_aligned_free(dither_block); dither_block=nullptr; dither_capacity=0; dither_w=dither_h=0;
+    ascii_aligned_free(diffuse_block); diffuse_block=nullptr; diffuse_capacity=0;
+    bayer_lum=bayer_color=nullptr; dither_built_mode=ASCII_DITHER_OFF; dither_built_levels=0;
+    quant_free();
+#ifdef ASCII_HAVE_THREADS
+    pool_stop();
+#endif
+    worker_count = 1;
+    free(band_carry); band_carry=nullptr; band_carry_size=0;
+    free(boundary_rows); free(boundary_band);
+    boundary_rows=boundary_band=nullptr; boundary_rows_size=0;
 }
 
 const void* I_GetASCIIBuffer(void) {
     return cell_buffer;
 }
 
-// ---------- 경계/카운트 준비 ----------
-static void ensure_bounds(int src_w, int src_h, int ascii_w, int ascii_h) {
-    if (B_W == ascii_w && B_H == ascii_h && X0 && X1 && Y0 && Y1) return;
+int I_GetASCIIWidth(void) {
+    return grid_w;
+}
+
+int I_GetASCIIHeight(void) {
+    return grid_h;
+}
+
+// 그리드 변경: 셀 버퍼만 다시 잡음 (플랜/스크래치는 다음 변환에서 크기에 맞춰 선택)
+int I_SetASCIIGrid(int width, int height) {
+    if (width <= 0 || height <= 0 ||
+        width > ASCII_GRID_MAX || height > ASCII_GRID_MAX) return 0;
+    if (cell_buffer && width == grid_w && height == grid_h) return 1;
+
+    AsciiCell* buf = (AsciiCell*)ascii_aligned_alloc(32, sizeof(AsciiCell) * width * height);
+    if (!buf) return 0;
+    std::memset(buf, 0, sizeof(AsciiCell) * width * height);
+    ascii_aligned_free(cell_buffer);
+    cell_buffer = buf;
+    grid_w = width;
+    grid_h = height;
+    return 1;
+}
+
+// ---------- 지오메트리 플랜 ----------
+static inline size_t align32(size_t n) { return (n + 31) & ~(size_t)31; }
 
-    free(X0); free(X1); free(Y0); free(Y1); free(COUNT_X); free(COUNT_Y); free(INV_COUNT);
-    X0=(int*)malloc(sizeof(int)*ascii_w);
-    X1=(int*)malloc(sizeof(int)*ascii_w);
-    Y0=(int*)malloc(sizeof(int)*ascii_h);
-    Y1=(int*)malloc(sizeof(int)*ascii_h);
-    COUNT_X=(int*)malloc(sizeof(int)*ascii_w);
-    COUNT_Y=(int*)malloc(sizeof(int)*ascii_h);
-    INV_COUNT=(uint32_t*)malloc(sizeof(uint32_t)*ascii_w*ascii_h);
+static constexpr int ascii_gcd(int a, int b) { return b ? ascii_gcd(b, a % b) : a; }
+
+static void reset_plan_tuning(AsciiPlan* plan) {
+    for (int m = 0; m < 2; ++m) {
+        for (int k = 0; k < ASCII_DOWNSAMPLE_COUNT; ++k) plan->tune[m][k] = EMPTY_STATS;
+        plan->tuned[m] = -1;
+    }
+}
+
+// 분수 면적 가중치 한 축: 셀 c는 [c*src, (c+1)*src), 픽셀 p는 [p*dst, (p+1)*dst) (1/dst 픽셀 단위)
+// 겹친 길이를 gcd로 나눠 저장 → 축별 가중치 합 = src/gcd
+static void build_frac_axis(int src, int dst, int* f0, int* f1, int* off, uint16_t* w) {
+    const int g = ascii_gcd(src, dst);
+    int n = 0;
+    for (int c = 0; c < dst; ++c) {
+        const int64_t a0 = (int64_t)c * src, a1 = (int64_t)(c + 1) * src;
+        f0[c] = (int)(a0 / dst);
+        f1[c] = (int)((a1 + dst - 1) / dst);
+        off[c] = n;
+        for (int p = f0[c]; p < f1[c]; ++p) {
+            const int64_t lo = std::max(a0, (int64_t)p * dst);
+            const int64_t hi = std::min(a1, (int64_t)(p + 1) * dst);
+            w[n++] = (uint16_t)((hi - lo) / g);
+        }
+    }
+}
+
+static void build_plan(AsciiPlan* plan, int src_w, int src_h, int ascii_w, int ascii_h) {
+    const size_t col_bytes = align32(sizeof(int) * ascii_w);
+    const size_t row_bytes = align32(sizeof(int) * ascii_h);
+    const size_t inv_bytes = align32(sizeof(uint32_t) * ascii_w * ascii_h);
+    // 셀마다 걸치는 픽셀 수의 합 <= 소스 + 셀 수 (경계 픽셀만 두 셀이 공유)
+    const size_t wx_bytes  = align32(sizeof(uint16_t) * (src_w + ascii_w));
+    const size_t wy_bytes  = align32(sizeof(uint16_t) * (src_h + ascii_h));
+    free(plan->block);
+    uint8_t* p = (uint8_t*)malloc(6 * col_bytes + 6 * row_bytes + inv_bytes
+                                  + wx_bytes + wy_bytes);
+    plan->block = p;
+    plan->x0      = (int*)p; p += col_bytes;
+    plan->x1      = (int*)p; p += col_bytes;
+    plan->count_x = (int*)p; p += col_bytes;
+    plan->fx0     = (int*)p; p += col_bytes;
+    plan->fx1     = (int*)p; p += col_bytes;
+    plan->wx_off  = (int*)p; p += col_bytes;
+    plan->y0      = (int*)p; p += row_bytes;
+    plan->y1      = (int*)p; p += row_bytes;
+    plan->count_y = (int*)p; p += row_bytes;
+    plan->fy0     = (int*)p; p += row_bytes;
+    plan->fy1     = (int*)p; p += row_bytes;
+    plan->wy_off  = (int*)p; p += row_bytes;
+    plan->wx      = (uint16_t*)p; p += wx_bytes;
+    plan->wy      = (uint16_t*)p; p += wy_bytes;
+    plan->inv_count = (uint32_t*)p;
+    plan->src_w = src_w; plan->src_h = src_h;
+    plan->ascii_w = ascii_w; plan->ascii_h = ascii_h;
 
     for (int x = 0; x < ascii_w; ++x) {
         int x0 = (int)((int64_t)x     * src_w / ascii_w);
@@ -150,7 +1136,7 @@ static void ensure_bounds(int src_w, int src_h, int ascii_w, int ascii_h) {
         if (x1 <= x0) x1 = x0 + 1;
         if (x0 < 0) x0 = 0;
         if (x1 > src_w) x1 = src_w;
-        X0[x]=x0; X1[x]=x1; COUNT_X[x]=x1-x0;
+        plan->x0[x]=x0; plan->x1[x]=x1; plan->count_x[x]=x1-x0;
     }
     for (int y = 0; y < ascii_h; ++y) {
         int y0 = (int)((int64_t)y     * src_h / ascii_h);
@@ -158,18 +1144,102 @@ static void ensure_bounds(int src_w, int src_h, int ascii_w, int ascii_h) {
         if (y1 <= y0) y1 = y0 + 1;
         if (y0 < 0) y0 = 0;
         if (y1 > src_h) y1 = src_h;
-        Y0[y]=y0; Y1[y]=y1; COUNT_Y[y]=y1-y0;
+        plan->y0[y]=y0; plan->y1[y]=y1; plan->count_y[y]=y1-y0;
     }
 
     // 역수 LUT 계산: (1<<16) / cnt → 곱셈+시프트로 나눗셈 대체
     for (int y = 0; y < ascii_h; ++y) {
         for (int x = 0; x < ascii_w; ++x) {
-            int cnt = COUNT_Y[y] * COUNT_X[x];
-            INV_COUNT[y*ascii_w + x] = (cnt > 0) ? ((1u << 16) / cnt) : 0;
+            int cnt = plan->count_y[y] * plan->count_x[x];
+            plan->inv_count[y*ascii_w + x] = (cnt > 0) ? ((1u << 16) / cnt) : 0;
         }
     }
 
-    B_W = ascii_w; B_H = ascii_h;
+    build_frac_axis(src_w, ascii_w, plan->fx0, plan->fx1, plan->wx_off, plan->wx);
+    build_frac_axis(src_h, ascii_h, plan->fy0, plan->fy1, plan->wy_off, plan->wy);
+    const int64_t total = (int64_t)(src_w / ascii_gcd(src_w, ascii_w))
+                        * (src_h / ascii_gcd(src_h, ascii_h));
+    plan->frac_ok  = total <= ASCII_FRAC_MAX_WEIGHT;
+    plan->frac_inv = ((1ull << 32) + (uint64_t)total / 2) / (uint64_t)total;
+
+    // 가로 부분합 상한: 셀 폭(정수 경계) 또는 셀 가중치 합(분수, = src_w/gcd) × 255
+    const int max_count_x = *std::max_element(plan->count_x, plan->count_x + ascii_w);
+    plan->sep_ok[0] = max_count_x * 255 <= 0xFFFF;
+    plan->sep_ok[1] = plan->frac_ok &&
+                      (src_w / ascii_gcd(src_w, ascii_w)) * 255 <= 0xFFFF;
+    reset_plan_tuning(plan);
+}
+
+// 캐시에서 플랜을 찾거나 (빈 슬롯 / 가장 오래 안 쓴 슬롯에) 만들어 현재 플랜으로
+static void select_plan(int src_w, int src_h, int ascii_w, int ascii_h) {
+    AsciiPlan* plan = nullptr;
+    AsciiPlan* victim = &plan_cache[0];
+    for (int i = 0; i < ASCII_PLAN_CACHE; ++i) {
+        AsciiPlan* p = &plan_cache[i];
+        if (p->last_used && p->src_w == src_w && p->src_h == src_h &&
+            p->ascii_w == ascii_w && p->ascii_h == ascii_h) {
+            plan = p;
+            break;
+        }
+        if (p->last_used < victim->last_used) victim = p;
+    }
+    if (!plan) {
+        plan = victim;
+        build_plan(plan, src_w, src_h, ascii_w, ascii_h);
+    }
+    plan->last_used = ++plan_clock;
+    cur_plan = plan;
+
+    X0 = plan->x0; X1 = plan->x1; Y0 = plan->y0; Y1 = plan->y1;
+    COUNT_X = plan->count_x; COUNT_Y = plan->count_y;
+    INV_COUNT = plan->inv_count;
+}
+
+// 현재 플랜에 분수 면적 가중을 적용하는지 (가중치 합이 너무 크면 정수 경계로)
+static inline bool area_weighted(void) {
+    return use_area_weighting && cur_plan->frac_ok;
+}
+
+// ---------- 셀 스크래치 아레나 ----------
+static void ensure_cell_scratch(int ascii_w, int ascii_h) {
+    const int cells = ascii_w * ascii_h;
+    if (scratch_block && scratch_cells >= cells && scratch_width >= ascii_w) return;
+    const int need_cells = std::max(cells, scratch_cells);
+    const int need_width = std::max(ascii_w, scratch_width);
+
+    const size_t plane_bytes = align32(sizeof(uint16_t) * need_cells);
+    const size_t row_bytes   = align32(sizeof(uint16_t) * need_width);
+    const size_t delta_bytes = align32(sizeof(AsciiCellDelta) * need_cells);
+    const size_t cells_bytes = align32(sizeof(AsciiCell) * need_width);
+    const size_t acc_bytes   = align32(sizeof(uint32_t) * need_width);
+    const size_t lane_bytes  = align32(sizeof(uint64_t) * need_width);
+    const size_t total = 3 * plane_bytes
+                       + ASCII_MAX_WORKERS * (3 * row_bytes + lane_bytes + 3 * acc_bytes)
+                       + delta_bytes + cells_bytes;
+
+    ascii_aligned_free(scratch_block);
+    uint8_t* p = (uint8_t*)ascii_aligned_alloc(32, total);
+    scratch_block = p;
+    temp_r = (uint16_t*)p; p += plane_bytes;
+    temp_g = (uint16_t*)p; p += plane_bytes;
+    temp_b = (uint16_t*)p; p += plane_bytes;
+    for (int k = 0; k < ASCII_MAX_WORKERS; ++k) {
+        for (int c = 0; c < 3; ++c) {
+            worker_row[k][c] = (uint16_t*)p; p += row_bytes;
+        }
+    }
+    row_r = worker_row[0][0]; row_g = worker_row[0][1]; row_b = worker_row[0][2];
+    for (int k = 0; k < ASCII_MAX_WORKERS; ++k) {
+        sep_h[k] = (uint64_t*)p; p += lane_bytes;
+        for (int c = 0; c < 3; ++c) {
+            sep_acc[k][c] = (uint32_t*)p; p += acc_bytes;
+        }
+        sep_row_frame[k] = 0;
+    }
+    delta_list = (AsciiCellDelta*)p; p += delta_bytes;
+    row_cells = (AsciiCell*)p;
+    scratch_cells = need_cells;
+    scratch_width = need_width;
 }
 
 // ---------- 적분영상 준비 ----------
@@ -187,34 +1257,54 @@ static void ensure_integral_capacity(int src_w, int src_h) {
 
 static inline int IIX(int x, int y, int W) { return y*W + x; }
 
-// RGBA32 → R/G/B 적분영상
-static void build_integral_images(const uint32_t *rgba, int w, int h) {
-    ensure_integral_capacity(w, h);
-    const int W = I_W; // w+1
+// ---------- 입력 소스 ----------
+// 픽셀 i → 0x??RRGGBB. 적분영상/박스 평균 코드는 소스 종류에 대해 템플릿화
 
-    // 첫 행/열 0 클리어
-    std::memset(I_R, 0, sizeof(uint32_t)*W);
-    std::memset(I_G, 0, sizeof(uint32_t)*W);
-    std::memset(I_B, 0, sizeof(uint32_t)*W);
-    for (int y = 1; y <= h; ++y) {
-        I_R[IIX(0,y,W)] = 0;
-        I_G[IIX(0,y,W)] = 0;
-        I_B[IIX(0,y,W)] = 0;
+// generation(): 같은 픽셀 값이 다른 색이 되는 상태 변화 (증분 변환 무효화용)
+
+// lum(i): 픽셀 밝기 (패스2와 같은 가중치, 모양 글리프 서명용)
+struct SourceRGBA32 {
+    const uint32_t* pixels;
+    inline uint32_t operator()(int i) const { return pixels[i]; }
+    inline uint32_t lum(int i) const {
+        const uint32_t s = pixels[i];
+        return (((s >> 16) & 0xFF) * 299 + ((s >> 8) & 0xFF) * 587 + (s & 0xFF) * 114) >> 10;
     }
+    inline uint32_t generation() const { return 0; }
+};
 
-    // 행+열 누적 통합 (이전 행 결과를 바로 더함)
-    for (int y = 0; y < h; ++y) {
+struct SourcePal8 {
+    const uint8_t*  pixels;
+    const uint32_t* palette;   // pal_packed (상위 바이트 = 밝기)
+    inline uint32_t operator()(int i) const { return palette[pixels[i]]; }
+    inline uint32_t lum(int i) const { return palette[pixels[i]] >> 24; }
+    inline uint32_t generation() const { return pal_generation; }
+};
+
+// 소스 행 [y_begin, y_end) → 적분영상 행 y_begin+1 .. y_end (0열 포함)
+// band_local이면 첫 행의 윗행을 0(적분영상 0행)으로 보고 밴드 안에서만 누적
+// → 워커별 밴드를 따로 만든 뒤 캐리(윗 밴드 마지막 행)를 더해 전역 값으로 맞춤
+template <class Source>
+static void build_integral_rows(const Source& src, int w, int y_begin, int y_end,
+                                bool band_local) {
+    const int W = I_W; // w+1
+
+    for (int y = y_begin; y < y_end; ++y) {
         uint32_t rsum = 0, gsum = 0, bsum = 0;
-        const uint32_t* srcRow = rgba + y*w;
+        const int srcRow = y*w;
+        const int prevY = (band_local && y == y_begin) ? 0 : y;
+        I_R[IIX(0,y+1,W)] = 0;
+        I_G[IIX(0,y+1,W)] = 0;
+        I_B[IIX(0,y+1,W)] = 0;
         uint32_t* dstR = I_R + IIX(1, y+1, W);
         uint32_t* dstG = I_G + IIX(1, y+1, W);
         uint32_t* dstB = I_B + IIX(1, y+1, W);
-        uint32_t* prevR = I_R + IIX(1, y, W);
-        uint32_t* prevG = I_G + IIX(1, y, W);
-        uint32_t* prevB = I_B + IIX(1, y, W);
+        const uint32_t* prevR = I_R + IIX(1, prevY, W);
+        const uint32_t* prevG = I_G + IIX(1, prevY, W);
+        const uint32_t* prevB = I_B + IIX(1, prevY, W);
 
         for (int x = 0; x < w; ++x) {
-            uint32_t s = srcRow[x];
+            uint32_t s = src(srcRow + x);
             rsum += (s>>16)&0xFF;
             gsum += (s>> 8)&0xFF;
             bsum += (s    )&0xFF;
@@ -225,24 +1315,2849 @@ static void build_integral_images(const uint32_t *rgba, int w, int h) {
     }
 }
 
-static void ensure_temp_buffer(int size) {
-    if (temp_size >= size) return;
-    free(temp_r); free(temp_g); free(temp_b);
-    // 16바이트 정렬 (SIMD) - size를 alignment의 배수로 올림
-    constexpr size_t alignment = 16;
-    size_t byte_size = sizeof(uint16_t) * size;
-    size_t aligned_size = (byte_size + alignment - 1) & ~(alignment - 1);
-    temp_r = (uint16_t*)aligned_alloc(alignment, aligned_size);
-    temp_g = (uint16_t*)aligned_alloc(alignment, aligned_size);
-    temp_b = (uint16_t*)aligned_alloc(alignment, aligned_size);
-    temp_size = size;
+// 소스 → R/G/B 적분영상 (소스 행 [0, rows)까지, 나머지 행은 이번 프레임 값이 아님)
+template <class Source>
+static void build_integral_images(const Source& src, int w, int h, int rows) {
+    ensure_integral_capacity(w, h);
+    const int W = I_W; // w+1
+
+    // 첫 행 0 클리어 (0열은 행마다 build_integral_rows에서)
+    std::memset(I_R, 0, sizeof(uint32_t)*W);
+    std::memset(I_G, 0, sizeof(uint32_t)*W);
+    std::memset(I_B, 0, sizeof(uint32_t)*W);
+
+    // 행+열 누적 통합 (이전 행 결과를 바로 더함)
+    build_integral_rows(src, w, 0, rows, false);
 }
 
 static inline uint8_t clamp_to_byte(int v) {
     return static_cast<uint8_t>(std::min(255, std::max(0, v)));
 }
 
-// ---------- 메인 변환 ----------
+// ---------- 패스2 커널 ----------
+// 입력: src_r/g/b (셀 평균 RGB, 32바이트 정렬), 출력: AsciiCell{문자, 감마 보정 RGB}
+// 2-패스 경로는 temp_r/g/b 전체를, 융합 경로는 행 버퍼 한 줄을 넘김
+// cell0: src[0]의 그리드 셀 번호 (BAYER 디더링 오프셋 bayer_lum/bayer_color[cell0 + i])
+
+// 스칼라: [begin, end) 구간 (SIMD 커널의 나머지 처리에도 사용)
+static void pass2_scalar(const uint16_t* src_r, const uint16_t* src_g,
+                         const uint16_t* src_b, AsciiCell* out, int begin, int end, int cell0) {
+    for (int i = begin; i < end; ++i) {
+        const uint8_t rv = clamp_to_byte(src_r[i]);
+        const uint8_t gv = clamp_to_byte(src_g[i]);
+        const uint8_t bv = clamp_to_byte(src_b[i]);
+        int lum = (rv*299 + gv*587 + bv*114) >> 10;
+        if (bayer_lum) lum += bayer_lum[cell0 + i];
+
+        out[i].character = ASCII_CHARS[idxLUT[clamp_to_byte(lum)]];
+        out[i].r = gamma_table[rv];
+        out[i].g = gamma_table[gv];
+        out[i].b = gamma_table[bv];
+        if (bayer_color) {
+            const int d = bayer_color[cell0 + i];
+            out[i].r = dither_quant[clamp_to_byte(out[i].r + d)];
+            out[i].g = dither_quant[clamp_to_byte(out[i].g + d)];
+            out[i].b = dither_quant[clamp_to_byte(out[i].b + d)];
+        }
+    }
+}
+
+// SIMD 패스2 공통 구조 (16셀/반복, 8비트 레인)
+//  1) uint16 평균 RGB 16셀 → 포화 pack으로 uint8 (clamp 0-255)
+//  2) 밝기 = (r*299 + g*587 + b*114) >> 10 (16비트 pair 내적 → 32비트 → pack)
+//  3) 감마: 256엔트리 gamma_table을 16행×16열로 나눠 상위 니블별
+//     셔플(pshufb/swizzle) 16번 → OR 합성. 범위 밖 인덱스는 0이 되도록 바이어스
+//  4) 문자 인덱스: 니블 분할 계단 테이블(idx_base16/idx_thr16) 셔플 2번
+//     → ASCII_CHARS 16바이트 테이블 셔플 한 번
+//     BAYER 디더링이면 밝기/감마 보정 색에 셀별 int8 오프셋을 포화 덧셈 (0x80 XOR로 부호 있는 포화 덧셈을
+//     부호 없는 0..255 clamp로 바꿈) 후 색은 dither_quant 셔플 조회
+//  5) char/r/g/b 평면을 바이트/워드 unpack으로 AsciiCell 배열로 인터리브 저장
+
+// 행 1..15 전개 (-O2에서도 루프 없이 셔플이 연속으로 나오도록)
+#define LUT_ROWS_1_15(ROW) \
+    ROW(1) ROW(2) ROW(3) ROW(4) ROW(5) ROW(6) ROW(7) ROW(8) \
+    ROW(9) ROW(10) ROW(11) ROW(12) ROW(13) ROW(14) ROW(15)
+
+#if defined(__wasm_simd128__)
+// swizzle은 인덱스 >= 16이면 0을 돌려줌 → 행마다 16씩 빼면서 OR
+static inline v128_t lut256_wasm128(const uint8_t* table, v128_t v) {
+    const v128_t step = wasm_i8x16_splat(16);
+    v128_t res = wasm_i8x16_swizzle(wasm_v128_load(table), v);
+    #define LUT_ROW(h) \
+        v = wasm_i8x16_sub(v, step); \
+        res = wasm_v128_or(res, wasm_i8x16_swizzle(wasm_v128_load(table + 16 * (h)), v));
+    LUT_ROWS_1_15(LUT_ROW)
+    #undef LUT_ROW
+    return res;
+}
+
+// 밝기 → 문자 인덱스 (계단 테이블 셔플 2번, 불가하면 256엔트리 조회)
+static inline v128_t lum_to_index_wasm128(v128_t lum) {
+    if (!idx_step16_ok) return lut256_wasm128(idxLUT, lum);
+    const v128_t nib = wasm_i8x16_splat(0x0F);
+    v128_t hi = wasm_v128_and(wasm_u8x16_shr(lum, 4), nib);
+    v128_t lo = wasm_v128_and(lum, nib);
+    v128_t base = wasm_i8x16_swizzle(wasm_v128_load(idx_base16), hi);
+    v128_t thr  = wasm_i8x16_swizzle(wasm_v128_load(idx_thr16), hi);
+    return wasm_i8x16_sub(base, wasm_u8x16_ge(lo, thr));
+}
+
+// WASM SIMD128: 16셀씩 처리
+// v + d (d는 int8), 0..255로 포화
+static inline v128_t add_dither_wasm128(v128_t v, v128_t d) {
+    const v128_t sign = wasm_i8x16_splat((int8_t)0x80);
+    return wasm_v128_xor(wasm_i8x16_add_sat(wasm_v128_xor(v, sign), d), sign);
+}
+
+static void pass2_wasm128(const uint16_t* src_r, const uint16_t* src_g,
+                          const uint16_t* src_b, AsciiCell* out, int begin, int end, int cell0) {
+    const v128_t v255    = wasm_i16x8_splat(255);
+    const v128_t coef_rg = wasm_i32x4_splat((587 << 16) | 299);
+    const v128_t coef_b  = wasm_i32x4_splat(114);
+    const v128_t zero    = wasm_i16x8_splat(0);
+    const v128_t chars   = wasm_v128_load(ascii_chars16);
+
+    int i = begin;
+    for (; i <= end - 16; i += 16) {
+        // 16셀 RGB 로드 + clamp 0-255
+        v128_t r0 = wasm_u16x8_min(wasm_v128_load(&src_r[i]), v255);
+        v128_t r1 = wasm_u16x8_min(wasm_v128_load(&src_r[i + 8]), v255);
+        v128_t g0 = wasm_u16x8_min(wasm_v128_load(&src_g[i]), v255);
+        v128_t g1 = wasm_u16x8_min(wasm_v128_load(&src_g[i + 8]), v255);
+        v128_t b0 = wasm_u16x8_min(wasm_v128_load(&src_b[i]), v255);
+        v128_t b1 = wasm_u16x8_min(wasm_v128_load(&src_b[i + 8]), v255);
+
+        // 밝기 = (r*299 + g*587 + b*114) >> 10
+        #define LUM4(rr, gg, bb, LO) wasm_i32x4_shr(wasm_i32x4_add( \
+            wasm_i32x4_dot_i16x8(wasm_i16x8_shuffle(rr, gg, LO, LO+8, LO+1, LO+9, LO+2, LO+10, LO+3, LO+11), coef_rg), \
+            wasm_i32x4_dot_i16x8(wasm_i16x8_shuffle(bb, zero, LO, 8, LO+1, 8, LO+2, 8, LO+3, 8), coef_b)), 10)
+        v128_t lum0 = wasm_i16x8_narrow_i32x4(LUM4(r0, g0, b0, 0), LUM4(r0, g0, b0, 4));
+        v128_t lum1 = wasm_i16x8_narrow_i32x4(LUM4(r1, g1, b1, 0), LUM4(r1, g1, b1, 4));
+        #undef LUM4
+
+        v128_t r   = wasm_u8x16_narrow_i16x8(r0, r1);
+        v128_t g   = wasm_u8x16_narrow_i16x8(g0, g1);
+        v128_t b   = wasm_u8x16_narrow_i16x8(b0, b1);
+        v128_t lum = wasm_u8x16_narrow_i16x8(lum0, lum1);
+        if (bayer_lum) lum = add_dither_wasm128(lum, wasm_v128_load(&bayer_lum[cell0 + i]));
+
+        // LUT: 감마 + 문자 인덱스 → 문자
+        v128_t ch = wasm_i8x16_swizzle(chars, lum_to_index_wasm128(lum));
+        r = lut256_wasm128(gamma_table, r);
+        g = lut256_wasm128(gamma_table, g);
+        b = lut256_wasm128(gamma_table, b);
+        if (bayer_color) {
+            const v128_t d = wasm_v128_load(&bayer_color[cell0 + i]);
+            r = lut256_wasm128(dither_quant, add_dither_wasm128(r, d));
+            g = lut256_wasm128(dither_quant, add_dither_wasm128(g, d));
+            b = lut256_wasm128(dither_quant, add_dither_wasm128(b, d));
+        }
+
+        // AsciiCell{char,r,g,b} 인터리브
+        v128_t cr_lo = wasm_i8x16_shuffle(ch, r, 0,16,1,17,2,18,3,19,4,20,5,21,6,22,7,23);
+        v128_t cr_hi = wasm_i8x16_shuffle(ch, r, 8,24,9,25,10,26,11,27,12,28,13,29,14,30,15,31);
+        v128_t gb_lo = wasm_i8x16_shuffle(g, b, 0,16,1,17,2,18,3,19,4,20,5,21,6,22,7,23);
+        v128_t gb_hi = wasm_i8x16_shuffle(g, b, 8,24,9,25,10,26,11,27,12,28,13,29,14,30,15,31);
+        uint8_t* dst = (uint8_t*)(out + i);
+        wasm_v128_store(dst,      wasm_i16x8_shuffle(cr_lo, gb_lo, 0, 8, 1, 9, 2, 10, 3, 11));
+        wasm_v128_store(dst + 16, wasm_i16x8_shuffle(cr_lo, gb_lo, 4, 12, 5, 13, 6, 14, 7, 15));
+        wasm_v128_store(dst + 32, wasm_i16x8_shuffle(cr_hi, gb_hi, 0, 8, 1, 9, 2, 10, 3, 11));
+        wasm_v128_store(dst + 48, wasm_i16x8_shuffle(cr_hi, gb_hi, 4, 12, 5, 13, 6, 14, 7, 15));
+    }
+
+    // 나머지 스칼라
+    pass2_scalar(src_r, src_g, src_b, out, i, end, cell0);
+}
+#endif
+
+#if defined(ASCII_X86_SIMD)
+// pshufb는 인덱스 최상위 비트가 1이면 0을 돌려줌:
+// (v - 16h)를 0x70과 포화 덧셈 → [0,15]만 0x70..0x7F, 나머지는 0x80 이상
+ASCII_TARGET_SSSE3
+static inline __m128i lut256_ssse3(const uint8_t* table, __m128i v) {
+    const __m128i bias = _mm_set1_epi8(0x70);
+    const __m128i step = _mm_set1_epi8(16);
+    __m128i res = _mm_shuffle_epi8(_mm_load_si128((const __m128i*)table),
+                                   _mm_adds_epu8(v, bias));
+    #define LUT_ROW(h) \
+        v = _mm_sub_epi8(v, step); \
+        res = _mm_or_si128(res, _mm_shuffle_epi8( \
+            _mm_load_si128((const __m128i*)(table + 16 * (h))), _mm_adds_epu8(v, bias)));
+    LUT_ROWS_1_15(LUT_ROW)
+    #undef LUT_ROW
+    return res;
+}
+
+// 밝기 → 문자 인덱스 (계단 테이블 셔플 2번, 불가하면 256엔트리 조회)
+ASCII_TARGET_SSSE3
+static inline __m128i lum_to_index_ssse3(__m128i lum) {
+    if (!idx_step16_ok) return lut256_ssse3(idxLUT, lum);
+    const __m128i nib = _mm_set1_epi8(0x0F);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(lum, 4), nib);
+    __m128i lo = _mm_and_si128(lum, nib);
+    __m128i base = _mm_shuffle_epi8(_mm_load_si128((const __m128i*)idx_base16), hi);
+    __m128i thr  = _mm_shuffle_epi8(_mm_load_si128((const __m128i*)idx_thr16), hi);
+    return _mm_sub_epi8(base, _mm_cmpeq_epi8(_mm_max_epu8(lo, thr), lo));
+}
+
+// v + d (d는 int8), 0..255로 포화
+static inline __m128i add_dither_sse2(__m128i v, __m128i d) {
+    const __m128i sign = _mm_set1_epi8((char)0x80);
+    return _mm_xor_si128(_mm_adds_epi8(_mm_xor_si128(v, sign), d), sign);
+}
+
+// SSSE3: 16셀씩 처리
+ASCII_TARGET_SSSE3
+static void pass2_ssse3(const uint16_t* src_r, const uint16_t* src_g,
+                        const uint16_t* src_b, AsciiCell* out, int begin, int end, int cell0) {
+    const __m128i coef_rg = _mm_set1_epi32((587 << 16) | 299);
+    const __m128i coef_b  = _mm_set1_epi32(114);
+    const __m128i v255    = _mm_set1_epi16(255);
+    const __m128i zero    = _mm_setzero_si128();
+    const __m128i chars   = _mm_load_si128((const __m128i*)ascii_chars16);
+
+    int i = begin;
+    for (; i <= end - 16; i += 16) {
+        // 16셀 RGB 로드 + clamp 0-255 (값은 항상 0 이상)
+        __m128i r0 = _mm_min_epi16(_mm_load_si128((const __m128i*)&src_r[i]), v255);
+        __m128i r1 = _mm_min_epi16(_mm_load_si128((const __m128i*)&src_r[i + 8]), v255);
+        __m128i g0 = _mm_min_epi16(_mm_load_si128((const __m128i*)&src_g[i]), v255);
+        __m128i g1 = _mm_min_epi16(_mm_load_si128((const __m128i*)&src_g[i + 8]), v255);
+        __m128i b0 = _mm_min_epi16(_mm_load_si128((const __m128i*)&src_b[i]), v255);
+        __m128i b1 = _mm_min_epi16(_mm_load_si128((const __m128i*)&src_b[i + 8]), v255);
+
+        // 밝기 = (r*299 + g*587 + b*114) >> 10 (pmaddwd로 32비트 누적)
+        #define LUM4(UNPACK, rr, gg, bb) _mm_srai_epi32(_mm_add_epi32( \
+            _mm_madd_epi16(UNPACK(rr, gg), coef_rg), \
+            _mm_madd_epi16(UNPACK(bb, zero), coef_b)), 10)
+        __m128i lum0 = _mm_packs_epi32(LUM4(_mm_unpacklo_epi16, r0, g0, b0),
+                                       LUM4(_mm_unpackhi_epi16, r0, g0, b0));
+        __m128i lum1 = _mm_packs_epi32(LUM4(_mm_unpacklo_epi16, r1, g1, b1),
+                                       LUM4(_mm_unpackhi_epi16, r1, g1, b1));
+        #undef LUM4
+
+        __m128i r   = _mm_packus_epi16(r0, r1);
+        __m128i g   = _mm_packus_epi16(g0, g1);
+        __m128i b   = _mm_packus_epi16(b0, b1);
+        __m128i lum = _mm_packus_epi16(lum0, lum1);
+        if (bayer_lum) {
+            lum = add_dither_sse2(lum, _mm_loadu_si128((const __m128i*)&bayer_lum[cell0 + i]));
+        }
+
+        // LUT: 감마 + 문자 인덱스 → 문자
+        __m128i ch = _mm_shuffle_epi8(chars, lum_to_index_ssse3(lum));
+        r = lut256_ssse3(gamma_table, r);
+        g = lut256_ssse3(gamma_table, g);
+        b = lut256_ssse3(gamma_table, b);
+        if (bayer_color) {
+            const __m128i d = _mm_loadu_si128((const __m128i*)&bayer_color[cell0 + i]);
+            r = lut256_ssse3(dither_quant, add_dither_sse2(r, d));
+            g = lut256_ssse3(dither_quant, add_dither_sse2(g, d));
+            b = lut256_ssse3(dither_quant, add_dither_sse2(b, d));
+        }
+
+        // AsciiCell{char,r,g,b} 인터리브
+        __m128i cr_lo = _mm_unpacklo_epi8(ch, r), cr_hi = _mm_unpackhi_epi8(ch, r);
+        __m128i gb_lo = _mm_unpacklo_epi8(g, b),  gb_hi = _mm_unpackhi_epi8(g, b);
+        __m128i* dst = (__m128i*)(out + i);
+        _mm_storeu_si128(dst + 0, _mm_unpacklo_epi16(cr_lo, gb_lo));
+        _mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(cr_lo, gb_lo));
+        _mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(cr_hi, gb_hi));
+        _mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(cr_hi, gb_hi));
+    }
+
+    // 나머지 스칼라
+    pass2_scalar(src_r, src_g, src_b, out, i, end, cell0);
+}
+
+// AVX2 버전: vpshufb는 128비트 레인 단위이므로 테이블 행을 양쪽 레인에 복제
+ASCII_TARGET_AVX2
+static inline __m256i lut256_avx2(const uint8_t* table, __m256i v) {
+    const __m256i bias = _mm256_set1_epi8(0x70);
+    const __m256i step = _mm256_set1_epi8(16);
+    __m256i res = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(
+        _mm_load_si128((const __m128i*)table)), _mm256_adds_epu8(v, bias));
+    #define LUT_ROW(h) \
+        v = _mm256_sub_epi8(v, step); \
+        res = _mm256_or_si256(res, _mm256_shuffle_epi8(_mm256_broadcastsi128_si256( \
+            _mm_load_si128((const __m128i*)(table + 16 * (h)))), _mm256_adds_epu8(v, bias)));
+    LUT_ROWS_1_15(LUT_ROW)
+    #undef LUT_ROW
+    return res;
+}
+
+ASCII_TARGET_AVX2
+static inline __m256i lum_to_index_avx2(__m256i lum) {
+    if (!idx_step16_ok) return lut256_avx2(idxLUT, lum);
+    const __m256i nib = _mm256_set1_epi8(0x0F);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(lum, 4), nib);
+    __m256i lo = _mm256_and_si256(lum, nib);
+    __m256i base = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(
+        _mm_load_si128((const __m128i*)idx_base16)), hi);
+    __m256i thr  = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(
+        _mm_load_si128((const __m128i*)idx_thr16)), hi);
+    return _mm256_sub_epi8(base, _mm256_cmpeq_epi8(_mm256_max_epu8(lo, thr), lo));
+}
+
+// AVX2: 32셀씩 처리
+// 레인 단위 pack 때문에 바이트 순서가 셀 0-7,16-23 | 8-15,24-31로 섞이지만
+// 모든 평면이 같은 순서이므로 마지막 인터리브 단계의 레인 교환으로 복원
+ASCII_TARGET_AVX2
+static inline __m256i add_dither_avx2(__m256i v, __m256i d) {
+    const __m256i sign = _mm256_set1_epi8((char)0x80);
+    return _mm256_xor_si256(_mm256_adds_epi8(_mm256_xor_si256(v, sign), d), sign);
+}
+
+// 오프셋 32개를 pack 결과와 같은 셀 순서(0-7,16-23 | 8-15,24-31)로
+ASCII_TARGET_AVX2
+static inline __m256i load_dither_avx2(const int8_t* p) {
+    return _mm256_permute4x64_epi64(_mm256_loadu_si256((const __m256i*)p), 0xD8);
+}
+
+ASCII_TARGET_AVX2
+static void pass2_avx2(const uint16_t* src_r, const uint16_t* src_g,
+                       const uint16_t* src_b, AsciiCell* out, int begin, int end, int cell0) {
+    const __m256i coef_rg = _mm256_set1_epi32((587 << 16) | 299);
+    const __m256i coef_b  = _mm256_set1_epi32(114);
+    const __m256i v255    = _mm256_set1_epi16(255);
+    const __m256i zero    = _mm256_setzero_si256();
+    const __m256i chars   = _mm256_broadcastsi128_si256(
+        _mm_load_si128((const __m128i*)ascii_chars16));
+
+    int i = begin;
+    for (; i <= end - 32; i += 32) {
+        __m256i r0 = _mm256_min_epi16(_mm256_load_si256((const __m256i*)&src_r[i]), v255);
+        __m256i r1 = _mm256_min_epi16(_mm256_load_si256((const __m256i*)&src_r[i + 16]), v255);
+        __m256i g0 = _mm256_min_epi16(_mm256_load_si256((const __m256i*)&src_g[i]), v255);
+        __m256i g1 = _mm256_min_epi16(_mm256_load_si256((const __m256i*)&src_g[i + 16]), v255);
+        __m256i b0 = _mm256_min_epi16(_mm256_load_si256((const __m256i*)&src_b[i]), v255);
+        __m256i b1 = _mm256_min_epi16(_mm256_load_si256((const __m256i*)&src_b[i + 16]), v255);
+
+        #define LUM8(UNPACK, rr, gg, bb) _mm256_srai_epi32(_mm256_add_epi32( \
+            _mm256_madd_epi16(UNPACK(rr, gg), coef_rg), \
+            _mm256_madd_epi16(UNPACK(bb, zero), coef_b)), 10)
+        __m256i lum0 = _mm256_packs_epi32(LUM8(_mm256_unpacklo_epi16, r0, g0, b0),
+                                          LUM8(_mm256_unpackhi_epi16, r0, g0, b0));
+        __m256i lum1 = _mm256_packs_epi32(LUM8(_mm256_unpacklo_epi16, r1, g1, b1),
+                                          LUM8(_mm256_unpackhi_epi16, r1, g1, b1));
+        #undef LUM8
+
+        __m256i r   = _mm256_packus_epi16(r0, r1);
+        __m256i g   = _mm256_packus_epi16(g0, g1);
+        __m256i b   = _mm256_packus_epi16(b0, b1);
+        __m256i lum = _mm256_packus_epi16(lum0, lum1);
+        if (bayer_lum) lum = add_dither_avx2(lum, load_dither_avx2(&bayer_lum[cell0 + i]));
+
+        __m256i ch = _mm256_shuffle_epi8(chars, lum_to_index_avx2(lum));
+        r = lut256_avx2(gamma_table, r);
+        g = lut256_avx2(gamma_table, g);
+        b = lut256_avx2(gamma_table, b);
+        if (bayer_color) {
+            const __m256i d = load_dither_avx2(&bayer_color[cell0 + i]);
+            r = lut256_avx2(dither_quant, add_dither_avx2(r, d));
+            g = lut256_avx2(dither_quant, add_dither_avx2(g, d));
+            b = lut256_avx2(dither_quant, add_dither_avx2(b, d));
+        }
+
+        __m256i cr_lo = _mm256_unpacklo_epi8(ch, r), cr_hi = _mm256_unpackhi_epi8(ch, r);
+        __m256i gb_lo = _mm256_unpacklo_epi8(g, b),  gb_hi = _mm256_unpackhi_epi8(g, b);
+        __m256i q0 = _mm256_unpacklo_epi16(cr_lo, gb_lo);  // 셀 0-3   | 8-11
+        __m256i q1 = _mm256_unpackhi_epi16(cr_lo, gb_lo);  // 셀 4-7   | 12-15
+        __m256i q2 = _mm256_unpacklo_epi16(cr_hi, gb_hi);  // 셀 16-19 | 24-27
+        __m256i q3 = _mm256_unpackhi_epi16(cr_hi, gb_hi);  // 셀 20-23 | 28-31
+        __m256i* dst = (__m256i*)(out + i);
+        _mm256_storeu_si256(dst + 0, _mm256_permute2x128_si256(q0, q1, 0x20));
+        _mm256_storeu_si256(dst + 1, _mm256_permute2x128_si256(q0, q1, 0x31));
+        _mm256_storeu_si256(dst + 2, _mm256_permute2x128_si256(q2, q3, 0x20));
+        _mm256_storeu_si256(dst + 3, _mm256_permute2x128_si256(q2, q3, 0x31));
+    }
+
+    // 나머지는 SSSE3 16셀 + 스칼라
+    pass2_ssse3(src_r, src_g, src_b, out, i, end, cell0);
+}
+#endif
+
+typedef void (*Pass2Kernel)(const uint16_t*, const uint16_t*, const uint16_t*,
+                            AsciiCell*, int, int, int);
+
+static Pass2Kernel select_pass2_kernel(void) {
+    if (!use_simd) return pass2_scalar;
+    switch (simd_kernel) {
+#if defined(__wasm_simd128__)
+    case ASCII_KERNEL_WASM128: return pass2_wasm128;
+#endif
+#if defined(ASCII_X86_SIMD)
+    case ASCII_KERNEL_AVX2:    return pass2_avx2;
+    case ASCII_KERNEL_SSSE3:   return pass2_ssse3;
+#endif
+    default:                   return pass2_scalar;
+    }
+}
+
+// ---------- 디더링 ----------
+// 문자: 램프 단계 폭 S = 256 / (문자 수 - 1)로 반올림 양자화(idxLUT) → 밝기에 오프셋을 더하면 임계값 디더링
+// 색: 감마 보정 값을 단계 값 round(k * 255 / (L - 1))로 양자화 (L = 16이면 k * 17 → RGB444 패킹과 일치)
+// BAYER 오프셋 = ((M + 0.5) / 64 - 0.5) * S (M: 셀 좌표 x & 7, y & 7의 8x8 행렬 값)
+// FLOYD/ATKINSON: 셀마다 {r, g, b, 밝기} 4레인을 한 벡터로 양자화하고 오차를 float 4레인으로 이웃에 나눔
+
+static inline int dither_color_levels(void) {
+    if (dither_levels > 0) return dither_levels;
+    return packed_format == ASCII_PACKED_RGB444 ? 16 : 0;
+}
+
+// 8x8 Bayer: M(2n) = [[4M, 4M+2], [4M+3, 4M+1]] → 좌표 하위 비트가 값의 상위 비트
+static inline int bayer8(int x, int y) {
+    int v = 0;
+    for (int bit = 0; bit < 3; ++bit) {
+        const int xb = (x >> bit) & 1, yb = (y >> bit) & 1;
+        v = (v << 2) | (((xb ^ yb) << 1) | yb);
+    }
+    return v;
+}
+
+static inline int bayer_offset(int m, float step) {
+    return (int)std::lround(((m + 0.5f) / 64.0f - 0.5f) * step);
+}
+
+static void build_dither_tables(int levels) {
+    for (int k = 0; k < 256; ++k) {
+        dither_level_value[k] = (uint8_t)(levels ? (k * 255 * 2 + levels - 1) / (2 * (levels - 1)) : k);
+    }
+    for (int v = 0; v < 256; ++v) {
+        dither_quant[v] = levels ? dither_level_value[(v * (levels - 1) * 2 + 255) / 510] : (uint8_t)v;
+    }
+}
+
+// BAYER 오프셋 평면 (그리드 크기/색 단계가 바뀔 때만 다시 만듦)
+static bool ensure_bayer_plane(int ascii_w, int ascii_h, int levels) {
+    const int cells = ascii_w * ascii_h;
+    if (dither_capacity < cells) {
+        void* block = ascii_aligned_alloc(32, align32((size_t)cells) * 2);
+        if (!block) return false;
+        ascii_aligned_free(dither_block);
+        dither_block = block;
+        dither_capacity = cells;
+        dither_w = 0;
+    }
+    int8_t* lum = (int8_t*)dither_block;
+    int8_t* color = lum + align32((size_t)dither_capacity);
+    if (dither_w != ascii_w || dither_h != ascii_h || dither_built_levels != levels
+     || dither_built_mode != ASCII_DITHER_BAYER) {
+        const float lum_step = 256.0f / (ASCII_CHARS_LEN - 1);
+        const float color_step = levels ? 255.0f / (levels - 1) : 0.0f;
+        for (int y = 0; y < ascii_h; ++y) {
+            for (int x = 0; x < ascii_w; ++x) {
+                const int m = bayer8(x, y);
+                lum[y * ascii_w + x] = (int8_t)std::max(-127, bayer_offset(m, lum_step));
+                color[y * ascii_w + x] = (int8_t)std::max(-127, std::min(127, bayer_offset(m, color_step)));
+            }
+        }
+        dither_w = ascii_w;
+        dither_h = ascii_h;
+    }
+    bayer_lum = lum;
+    bayer_color = levels ? color : nullptr;
+    return true;
+}
+
+// 오차 확산: 행 하나를 왼쪽부터. 호출 순서 = 그리드 행 순서 (행마다 diffuse_next_row)
+typedef void (*DiffuseKernel)(const uint16_t*, const uint16_t*, const uint16_t*, AsciiCell*, int);
+
+static inline void diffuse_store(AsciiCell& c, const int* q) {
+    c.character = ASCII_CHARS[std::min(q[3], ASCII_CHARS_LEN - 1)];
+    c.r = dither_level_value[q[0]];
+    c.g = dither_level_value[q[1]];
+    c.b = dither_level_value[q[2]];
+}
+
+// FLOYD: 오른쪽 7/16 | 왼쪽 아래 3/16, 아래 5/16, 오른쪽 아래 1/16
+// ATKINSON: 오른쪽 1칸/2칸, 왼쪽 아래/아래/오른쪽 아래, 두 줄 아래에 1/8씩 (6/8만 퍼뜨려 대비 유지)
+static void diffuse_row_scalar(const uint16_t* src_r, const uint16_t* src_g,
+                               const uint16_t* src_b, AsciiCell* out, int n) {
+    float* e0 = diffuse_rows[0] + 8;
+    float* e1 = diffuse_rows[1] + 8;
+    float* e2 = diffuse_rows[2] + 8;
+    const bool fs = dither_mode == ASCII_DITHER_FLOYD;
+    for (int x = 0; x < n; ++x) {
+        const uint8_t rv = clamp_to_byte(src_r[x]);
+        const uint8_t gv = clamp_to_byte(src_g[x]);
+        const uint8_t bv = clamp_to_byte(src_b[x]);
+        const float in[4] = { (float)gamma_table[rv], (float)gamma_table[gv], (float)gamma_table[bv],
+                              (float)((rv*299 + gv*587 + bv*114) >> 10) };
+        int q[4];
+        float e[4];
+        for (int c = 0; c < 4; ++c) {
+            const float v = std::min(std::max(in[c] + e0[x * 4 + c], 0.0f), 255.0f);
+            q[c] = (int)std::nearbyint(v * diffuse_inv[c]);
+            e[c] = (v - (float)q[c] * diffuse_step[c]) * diffuse_keep[c];
+        }
+        diffuse_store(out[x], q);
+        for (int c = 0; c < 4; ++c) {
+            if (fs) {
+                e0[(x + 1) * 4 + c] += e[c] * (7.0f / 16.0f);
+                e1[(x - 1) * 4 + c] += e[c] * (3.0f / 16.0f);
+                e1[x * 4 + c]       += e[c] * (5.0f / 16.0f);
+                e1[(x + 1) * 4 + c] += e[c] * (1.0f / 16.0f);
+            } else {
+                const float a = e[c] * 0.125f;
+                e0[(x + 1) * 4 + c] += a;
+                e0[(x + 2) * 4 + c] += a;
+                e1[(x - 1) * 4 + c] += a;
+                e1[x * 4 + c]       += a;
+                e1[(x + 1) * 4 + c] += a;
+                e2[x * 4 + c]       += a;
+            }
+        }
+    }
+}
+
+#if defined(__wasm_simd128__)
+static void diffuse_row_wasm128(const uint16_t* src_r, const uint16_t* src_g,
+                                const uint16_t* src_b, AsciiCell* out, int n) {
+    float* e0 = diffuse_rows[0] + 8;
+    float* e1 = diffuse_rows[1] + 8;
+    float* e2 = diffuse_rows[2] + 8;
+    const bool fs = dither_mode == ASCII_DITHER_FLOYD;
+    const v128_t step = wasm_v128_load(diffuse_step);
+    const v128_t inv  = wasm_v128_load(diffuse_inv);
+    const v128_t keep = wasm_v128_load(diffuse_keep);
+    const v128_t lo = wasm_f32x4_splat(0.0f), hi = wasm_f32x4_splat(255.0f);
+    #define ACC(p, w) wasm_v128_store(p, wasm_f32x4_add(wasm_v128_load(p), wasm_f32x4_mul(e, wasm_f32x4_splat(w))))
+    for (int x = 0; x < n; ++x) {
+        const uint8_t rv = clamp_to_byte(src_r[x]);
+        const uint8_t gv = clamp_to_byte(src_g[x]);
+        const uint8_t bv = clamp_to_byte(src_b[x]);
+        const v128_t in = wasm_f32x4_make(gamma_table[rv], gamma_table[gv], gamma_table[bv],
+                                          (float)((rv*299 + gv*587 + bv*114) >> 10));
+        const v128_t v = wasm_f32x4_min(wasm_f32x4_max(wasm_f32x4_add(in, wasm_v128_load(e0 + x * 4)), lo), hi);
+        const v128_t qf = wasm_f32x4_nearest(wasm_f32x4_mul(v, inv));
+        const v128_t e = wasm_f32x4_mul(wasm_f32x4_sub(v, wasm_f32x4_mul(qf, step)), keep);
+        alignas(16) int q[4];
+        wasm_v128_store(q, wasm_i32x4_trunc_sat_f32x4(qf));
+        diffuse_store(out[x], q);
+        if (fs) {
+            ACC(e0 + (x + 1) * 4, 7.0f / 16.0f);
+            ACC(e1 + (x - 1) * 4, 3.0f / 16.0f);
+            ACC(e1 + x * 4,       5.0f / 16.0f);
+            ACC(e1 + (x + 1) * 4, 1.0f / 16.0f);
+        } else {
+            ACC(e0 + (x + 1) * 4, 0.125f);
+            ACC(e0 + (x + 2) * 4, 0.125f);
+            ACC(e1 + (x - 1) * 4, 0.125f);
+            ACC(e1 + x * 4,       0.125f);
+            ACC(e1 + (x + 1) * 4, 0.125f);
+            ACC(e2 + x * 4,       0.125f);
+        }
+    }
+    #undef ACC
+}
+#endif
+
+#if defined(ASCII_X86_SIMD)
+// SSE2 (x86-64 기본): cvtps2dq는 MXCSR 기본 반올림(짝수 쪽) → 스칼라 nearbyint와 같음
+static void diffuse_row_sse2(const uint16_t* src_r, const uint16_t* src_g,
+                             const uint16_t* src_b, AsciiCell* out, int n) {
+    float* e0 = diffuse_rows[0] + 8;
+    float* e1 = diffuse_rows[1] + 8;
+    float* e2 = diffuse_rows[2] + 8;
+    const bool fs = dither_mode == ASCII_DITHER_FLOYD;
+    const __m128 step = _mm_load_ps(diffuse_step);
+    const __m128 inv  = _mm_load_ps(diffuse_inv);
+    const __m128 keep = _mm_load_ps(diffuse_keep);
+    const __m128 lo = _mm_setzero_ps(), hi = _mm_set1_ps(255.0f);
+    #define ACC(p, w) _mm_store_ps(p, _mm_add_ps(_mm_load_ps(p), _mm_mul_ps(e, _mm_set1_ps(w))))
+    for (int x = 0; x < n; ++x) {
+        const uint8_t rv = clamp_to_byte(src_r[x]);
+        const uint8_t gv = clamp_to_byte(src_g[x]);
+        const uint8_t bv = clamp_to_byte(src_b[x]);
+        const __m128 in = _mm_setr_ps(gamma_table[rv], gamma_table[gv], gamma_table[bv],
+                                      (float)((rv*299 + gv*587 + bv*114) >> 10));
+        const __m128 v = _mm_min_ps(_mm_max_ps(_mm_add_ps(in, _mm_load_ps(e0 + x * 4)), lo), hi);
+        const __m128i qi = _mm_cvtps_epi32(_mm_mul_ps(v, inv));
+        const __m128 e = _mm_mul_ps(_mm_sub_ps(v, _mm_mul_ps(_mm_cvtepi32_ps(qi), step)), keep);
+        alignas(16) int q[4];
+        _mm_store_si128((__m128i*)q, qi);
+        diffuse_store(out[x], q);
+        if (fs) {
+            ACC(e0 + (x + 1) * 4, 7.0f / 16.0f);
+            ACC(e1 + (x - 1) * 4, 3.0f / 16.0f);
+            ACC(e1 + x * 4,       5.0f / 16.0f);
+            ACC(e1 + (x + 1) * 4, 1.0f / 16.0f);
+        } else {
+            ACC(e0 + (x + 1) * 4, 0.125f);
+            ACC(e0 + (x + 2) * 4, 0.125f);
+            ACC(e1 + (x - 1) * 4, 0.125f);
+            ACC(e1 + x * 4,       0.125f);
+            ACC(e1 + (x + 1) * 4, 0.125f);
+            ACC(e2 + x * 4,       0.125f);
+        }
+    }
+    #undef ACC
+}
+#endif
+
+static DiffuseKernel select_diffuse_kernel(void) {
+    if (!use_simd) return diffuse_row_scalar;
+    switch (simd_kernel) {
+#if defined(__wasm_simd128__)
+    case ASCII_KERNEL_WASM128: return diffuse_row_wasm128;
+#endif
+#if defined(ASCII_X86_SIMD)
+    case ASCII_KERNEL_AVX2:
+    case ASCII_KERNEL_SSSE3:   return diffuse_row_sse2;
+#endif
+    default:                   return diffuse_row_scalar;
+    }
+}
+
+// 다음 그리드 행으로: 현재 행 버퍼를 비워 맨 뒤로
+static void diffuse_next_row(int ascii_w) {
+    float* done = diffuse_rows[0];
+    diffuse_rows[0] = diffuse_rows[1];
+    diffuse_rows[1] = diffuse_rows[2];
+    diffuse_rows[2] = done;
+    std::memset(done, 0, sizeof(float) * 4 * (size_t)(ascii_w + 4));
+}
+
+// 프레임 시작: 디더링 상태 준비. 오차 확산이면 행 커널을 돌려줌 (BAYER/끔이면 NULL, 패스2가 bayer_*를 읽음)
+// 방식이나 색 단계가 바뀌면 이전 출력과 섞이지 않도록 증분 그림자를 무효화
+static DiffuseKernel prepare_dither(int ascii_w, int ascii_h) {
+    bayer_lum = bayer_color = nullptr;
+    const int levels = dither_mode != ASCII_DITHER_OFF ? dither_color_levels() : 0;
+    if (dither_mode != dither_built_mode || levels != dither_built_levels) {
+        build_dither_tables(levels);
+        shadow_valid = false;
+    }
+    DiffuseKernel kernel = nullptr;
+    if (dither_mode == ASCII_DITHER_BAYER) {
+        if (!ensure_bayer_plane(ascii_w, ascii_h, levels)) return nullptr;
+    } else if (dither_mode == ASCII_DITHER_FLOYD || dither_mode == ASCII_DITHER_ATKINSON) {
+        const int floats = 4 * (ascii_w + 4);
+        if (diffuse_capacity < floats) {
+            float* block = (float*)ascii_aligned_alloc(32, sizeof(float) * 3 * (size_t)floats);
+            if (!block) return nullptr;
+            ascii_aligned_free(diffuse_block);
+            diffuse_block = block;
+            diffuse_capacity = floats;
+        }
+        for (int r = 0; r < 3; ++r) diffuse_rows[r] = diffuse_block + r * diffuse_capacity;
+        std::memset(diffuse_block, 0, sizeof(float) * 3 * (size_t)diffuse_capacity);
+        const float color_step = levels ? 255.0f / (levels - 1) : 1.0f;
+        const float lum_step = 255.0f / (ASCII_CHARS_LEN - 1);
+        for (int c = 0; c < 3; ++c) {
+            diffuse_step[c] = color_step;
+            diffuse_inv[c] = 1.0f / color_step;
+            diffuse_keep[c] = levels ? 1.0f : 0.0f;
+        }
+        diffuse_step[3] = lum_step;
+        diffuse_inv[3] = 1.0f / lum_step;
+        diffuse_keep[3] = 1.0f;
+        kernel = select_diffuse_kernel();
+    }
+    dither_built_mode = dither_mode;
+    dither_built_levels = levels;
+    return kernel;
+}
+
+// ---------- 16비트 패킹 출력 ----------
+// 셀 → (문자 번호 << 12) | R4 << 8 | G4 << 4 | B4
+// 채널 q = (v - (v >> 4) + 7) >> 4 ≈ round(v / 17): 복원 q * 17과의 오차 <= 9, 8비트 레인 안에서 계산
+// INDEXED는 같은 키로 묶은 뒤 키 → 팔레트 번호로 바꿈 (packed_remap)
+static inline uint16_t pack_cell_444(const AsciiCell& c) {
+    auto q = [](uint8_t v) { return (uint32_t)(v - (v >> 4) + 7) >> 4; };
+    return (uint16_t)(((uint32_t)glyph_index_lut[(uint8_t)c.character] << 12) |
+                      (q(c.r) << 8) | (q(c.g) << 4) | q(c.b));
+}
+
+static void pack_444_scalar(const AsciiCell* cells, uint16_t* out, int begin, int end) {
+    for (int i = begin; i < end; ++i) out[i] = pack_cell_444(cells[i]);
+}
+
+typedef void (*PackKernel)(const AsciiCell*, uint16_t*, int, int);
+
+#if defined(__wasm_simd128__)
+// 셀 4개(32비트 레인) → 패킹 값 (레인 하위 16비트)
+static inline v128_t pack4_wasm128(v128_t v) {
+    v128_t idx = wasm_i8x16_splat(0);
+    for (int k = 1; k < ASCII_CHARS_LEN; ++k) {
+        idx = wasm_v128_or(idx, wasm_v128_and(wasm_i8x16_eq(v, wasm_i8x16_splat(ASCII_CHARS[k])),
+                                              wasm_i8x16_splat((int8_t)k)));
+    }
+    idx = wasm_v128_and(idx, wasm_i32x4_splat(0xFF));
+    // 바이트별 반올림 니블: R은 비트 8..11, G는 16..19, B는 24..27
+    const v128_t nib = wasm_i8x16_splat(0x0F);
+    const v128_t hi = wasm_v128_and(wasm_u32x4_shr(v, 4), nib);
+    const v128_t t = wasm_i8x16_add(wasm_i8x16_sub(v, hi), wasm_i8x16_splat(7));
+    const v128_t q = wasm_v128_and(wasm_u32x4_shr(t, 4), nib);
+    return wasm_v128_or(wasm_v128_or(wasm_i32x4_shl(idx, 12),
+                                     wasm_v128_and(q, wasm_i32x4_splat(0x0F00))),
+                        wasm_v128_or(wasm_v128_and(wasm_u32x4_shr(q, 12), wasm_i32x4_splat(0xF0)),
+                                     wasm_u32x4_shr(q, 24)));
+}
+
+static void pack_444_wasm128(const AsciiCell* cells, uint16_t* out, int begin, int end) {
+    int i = begin;
+    for (; i <= end - 8; i += 8) {
+        const v128_t a = pack4_wasm128(wasm_v128_load(cells + i));
+        const v128_t b = pack4_wasm128(wasm_v128_load(cells + i + 4));
+        wasm_v128_store(out + i, wasm_u16x8_narrow_i32x4(a, b));
+    }
+    pack_444_scalar(cells, out, i, end);
+}
+#endif
+
+#if defined(ASCII_X86_SIMD)
+// SSE2 (x86 기준선): 문자 10개와 바이트 비교 → 문자 번호, 니블 반올림은 바이트 뺄셈/덧셈 + 시프트
+static inline __m128i pack4_sse2(__m128i v) {
+    __m128i idx = _mm_setzero_si128();
+    for (int k = 1; k < ASCII_CHARS_LEN; ++k) {
+        idx = _mm_or_si128(idx, _mm_and_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(ASCII_CHARS[k])),
+                                              _mm_set1_epi8((char)k)));
+    }
+    idx = _mm_and_si128(idx, _mm_set1_epi32(0xFF));
+    const __m128i nib = _mm_set1_epi8(0x0F);
+    const __m128i hi = _mm_and_si128(_mm_srli_epi32(v, 4), nib);
+    const __m128i t = _mm_add_epi8(_mm_sub_epi8(v, hi), _mm_set1_epi8(7));
+    const __m128i q = _mm_and_si128(_mm_srli_epi32(t, 4), nib);
+    return _mm_or_si128(_mm_or_si128(_mm_slli_epi32(idx, 12),
+                                     _mm_and_si128(q, _mm_set1_epi32(0x0F00))),
+                        _mm_or_si128(_mm_and_si128(_mm_srli_epi32(q, 12), _mm_set1_epi32(0xF0)),
+                                     _mm_srli_epi32(q, 24)));
+}
+
+static void pack_444_sse2(const AsciiCell* cells, uint16_t* out, int begin, int end) {
+    // 0..0xFFFF를 부호 있는 포화 없이 좁히기: -0x8000 → packs → 다시 +0x8000
+    const __m128i bias32 = _mm_set1_epi32(0x8000);
+    const __m128i bias16 = _mm_set1_epi16((short)0x8000);
+    int i = begin;
+    for (; i <= end - 8; i += 8) {
+        const __m128i a = pack4_sse2(_mm_loadu_si128((const __m128i*)(cells + i)));
+        const __m128i b = pack4_sse2(_mm_loadu_si128((const __m128i*)(cells + i + 4)));
+        const __m128i r = _mm_packs_epi32(_mm_sub_epi32(a, bias32), _mm_sub_epi32(b, bias32));
+        _mm_storeu_si128((__m128i*)(out + i), _mm_xor_si128(r, bias16));
+    }
+    pack_444_scalar(cells, out, i, end);
+}
+
+ASCII_TARGET_AVX2
+static inline __m256i pack8_avx2(__m256i v) {
+    __m256i idx = _mm256_setzero_si256();
+    for (int k = 1; k < ASCII_CHARS_LEN; ++k) {
+        idx = _mm256_or_si256(idx, _mm256_and_si256(
+            _mm256_cmpeq_epi8(v, _mm256_set1_epi8(ASCII_CHARS[k])), _mm256_set1_epi8((char)k)));
+    }
+    idx = _mm256_and_si256(idx, _mm256_set1_epi32(0xFF));
+    const __m256i nib = _mm256_set1_epi8(0x0F);
+    const __m256i hi = _mm256_and_si256(_mm256_srli_epi32(v, 4), nib);
+    const __m256i t = _mm256_add_epi8(_mm256_sub_epi8(v, hi), _mm256_set1_epi8(7));
+    const __m256i q = _mm256_and_si256(_mm256_srli_epi32(t, 4), nib);
+    return _mm256_or_si256(
+        _mm256_or_si256(_mm256_slli_epi32(idx, 12), _mm256_and_si256(q, _mm256_set1_epi32(0x0F00))),
+        _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(q, 12), _mm256_set1_epi32(0xF0)),
+                        _mm256_srli_epi32(q, 24)));
+}
+
+ASCII_TARGET_AVX2
+static void pack_444_avx2(const AsciiCell* cells, uint16_t* out, int begin, int end) {
+    int i = begin;
+    for (; i <= end - 16; i += 16) {
+        const __m256i a = pack8_avx2(_mm256_loadu_si256((const __m256i*)(cells + i)));
+        const __m256i b = pack8_avx2(_mm256_loadu_si256((const __m256i*)(cells + i + 8)));
+        // packus는 128비트 레인별 → 64비트 단위로 순서 복원
+        const __m256i r = _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xD8);
+        _mm256_storeu_si256((__m256i*)(out + i), r);
+    }
+    pack_444_sse2(cells, out, i, end);
+}
+#endif
+
+static PackKernel select_pack_kernel(void) {
+    // SIMD 커널은 램프 밖 문자를 0번으로 → 모양 글리프는 glyph_index_lut를 쓰는 스칼라로
+    if (!use_simd || use_shape) return pack_444_scalar;
+    switch (simd_kernel) {
+#if defined(__wasm_simd128__)
+    case ASCII_KERNEL_WASM128: return pack_444_wasm128;
+#endif
+#if defined(ASCII_X86_SIMD)
+    case ASCII_KERNEL_AVX2:    return pack_444_avx2;
+    case ASCII_KERNEL_SSSE3:   return pack_444_sse2;
+#endif
+    default:                   return pack_444_scalar;
+    }
+}
+
+static bool ensure_packed_capacity(int cells) {
+    if (packed_buffer && packed_capacity >= cells) return true;
+    uint16_t* buf = (uint16_t*)ascii_aligned_alloc(32, sizeof(uint16_t) * (size_t)cells);
+    if (!buf) return false;
+    ascii_aligned_free(packed_buffer);
+    packed_buffer = buf;
+    packed_capacity = cells;
+    packed_valid = false;
+    return true;
+}
+
+// 적응 팔레트: RGB444 키별 평균색 (키 하나에 색이 하나면 원래 색 그대로), 키 오름차순
+static void build_indexed_palette(const AsciiCell* cells, int total) {
+    for (int i = 0; i < total; ++i) {
+        const int key = packed_buffer[i] & 0x0FFF;
+        uint32_t* acc = packed_acc[key];
+        acc[0]++;
+        acc[1] += cells[i].r;
+        acc[2] += cells[i].g;
+        acc[3] += cells[i].b;
+    }
+    int n = 0;
+    for (int key = 0; key < 4096; ++key) {
+        uint32_t* acc = packed_acc[key];
+        if (!acc[0]) continue;
+        const uint32_t half = acc[0] / 2;
+        packed_palette[n * 3 + 0] = (uint8_t)((acc[1] + half) / acc[0]);
+        packed_palette[n * 3 + 1] = (uint8_t)((acc[2] + half) / acc[0]);
+        packed_palette[n * 3 + 2] = (uint8_t)((acc[3] + half) / acc[0]);
+        packed_remap[key] = (uint16_t)n++;
+        acc[0] = acc[1] = acc[2] = acc[3] = 0;
+    }
+    packed_palette_count = n;
+    for (int i = 0; i < total; ++i) {
+        const uint16_t p = packed_buffer[i];
+        packed_buffer[i] = (uint16_t)((p & 0xF000) | packed_remap[p & 0x0FFF]);
+    }
+}
+
+// 변환 직후 호출. RGB444 + 증분 프레임이면 델타 셀만 다시 패킹
+static void pack_output(const AsciiCell* out, int ascii_width, int ascii_height) {
+    const int total = ascii_width * ascii_height;
+    if (!ensure_packed_capacity(total)) return;
+    if (packed_src != out || packed_w != ascii_width || packed_h != ascii_height) {
+        packed_valid = false;
+    }
+
+    if (packed_format == ASCII_PACKED_RGB444 && packed_valid && !delta_full) {
+        for (int k = 0; k < delta_count; ++k) {
+            packed_buffer[delta_list[k].index] = pack_cell_444(delta_list[k].cell);
+        }
+        return;
+    }
+
+    select_pack_kernel()(out, packed_buffer, 0, total);
+    if (packed_format == ASCII_PACKED_INDEXED) build_indexed_palette(out, total);
+    else packed_palette_count = 0;
+    packed_src = out;
+    packed_w = ascii_width;
+    packed_h = ascii_height;
+    packed_valid = true;
+}
+
+// ---------- 내용 해시 (같은 프레임 건너뛰기) ----------
+// 64바이트 스트라이프 = 64비트 레인 8개: acc += lo32(d ^ k) * hi32(d ^ k) + d
+// 키는 스트라이프마다 STEP씩 바뀌어 같은 데이터라도 위치가 다르면 기여가 달라짐 (행 이동/교환 검출)
+// 모든 커널이 같은 레인 연산 → 커널을 바꿔도 해시가 같음
+static bool     use_frame_skip = true;
+static bool     frame_hash_valid = false;
+static uint64_t frame_hash = 0;
+static bool     frame_unchanged = false;  // 직전 변환 호출이 해시 일치로 생략됐는지
+static uint32_t frames_converted = 0, frames_skipped = 0;
+
+static constexpr uint64_t HASH_PRIME = 0x9E3779B185EBCA87ull;
+static constexpr uint64_t HASH_KEY_STEP = 0x165667B19E3779F9ull;
+alignas(32) static const uint64_t hash_keys[8] = {
+    0xbe4ba423396cfeb8ull, 0x1cad21f72c81017cull, 0xdb979083e96dd4deull, 0x1f67b3b7a4a44072ull,
+    0x78e5c0cc4ee679cbull, 0x2172ffcc7dd05a82ull, 0x8e2443f7744608b8ull, 0x4c263a81e69035e0ull,
+};
+
+static inline uint64_t hash_mix64(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    return h ^ (h >> 33);
+}
+
+typedef void (*HashKernel)(const uint8_t*, size_t, uint64_t*);
+
+static void hash_stripes_scalar(const uint8_t* p, size_t stripes, uint64_t* acc) {
+    uint64_t key[8];
+    std::memcpy(key, hash_keys, sizeof(key));
+    for (size_t s = 0; s < stripes; ++s, p += 64) {
+        for (int i = 0; i < 8; ++i) {
+            uint64_t d;
+            std::memcpy(&d, p + i * 8, 8);
+            const uint64_t dk = d ^ key[i];
+            acc[i] += (dk & 0xFFFFFFFFu) * (dk >> 32) + d;
+            key[i] += HASH_KEY_STEP;
+        }
+    }
+}
+
+#if defined(__wasm_simd128__)
+static void hash_stripes_wasm128(const uint8_t* p, size_t stripes, uint64_t* acc) {
+    const v128_t step = wasm_i64x2_splat((int64_t)HASH_KEY_STEP);
+    const v128_t lo32 = wasm_i64x2_splat(0xFFFFFFFF);
+    v128_t a[4], k[4];
+    for (int j = 0; j < 4; ++j) {
+        a[j] = wasm_v128_load(acc + 2 * j);
+        k[j] = wasm_v128_load(hash_keys + 2 * j);
+    }
+    for (size_t s = 0; s < stripes; ++s, p += 64) {
+        for (int j = 0; j < 4; ++j) {
+            const v128_t d = wasm_v128_load(p + 16 * j);
+            const v128_t dk = wasm_v128_xor(d, k[j]);
+            const v128_t prod = wasm_i64x2_mul(wasm_v128_and(dk, lo32), wasm_u64x2_shr(dk, 32));
+            a[j] = wasm_i64x2_add(a[j], wasm_i64x2_add(prod, d));
+            k[j] = wasm_i64x2_add(k[j], step);
+        }
+    }
+    for (int j = 0; j < 4; ++j) wasm_v128_store(acc + 2 * j, a[j]);
+}
+#endif
+
+#if defined(ASCII_X86_SIMD)
+static void hash_stripes_sse2(const uint8_t* p, size_t stripes, uint64_t* acc) {
+    const __m128i step = _mm_set1_epi64x((long long)HASH_KEY_STEP);
+    __m128i a[4], k[4];
+    for (int j = 0; j < 4; ++j) {
+        a[j] = _mm_loadu_si128((const __m128i*)(acc + 2 * j));
+        k[j] = _mm_load_si128((const __m128i*)(hash_keys + 2 * j));
+    }
+    for (size_t s = 0; s < stripes; ++s, p += 64) {
+        for (int j = 0; j < 4; ++j) {
+            const __m128i d = _mm_loadu_si128((const __m128i*)(p + 16 * j));
+            const __m128i dk = _mm_xor_si128(d, k[j]);
+            const __m128i prod = _mm_mul_epu32(dk, _mm_srli_epi64(dk, 32));
+            a[j] = _mm_add_epi64(a[j], _mm_add_epi64(prod, d));
+            k[j] = _mm_add_epi64(k[j], step);
+        }
+    }
+    for (int j = 0; j < 4; ++j) _mm_storeu_si128((__m128i*)(acc + 2 * j), a[j]);
+}
+
+ASCII_TARGET_AVX2
+static void hash_stripes_avx2(const uint8_t* p, size_t stripes, uint64_t* acc) {
+    const __m256i step = _mm256_set1_epi64x((long long)HASH_KEY_STEP);
+    __m256i a0 = _mm256_loadu_si256((const __m256i*)acc);
+    __m256i a1 = _mm256_loadu_si256((const __m256i*)(acc + 4));
+    __m256i k0 = _mm256_load_si256((const __m256i*)hash_keys);
+    __m256i k1 = _mm256_load_si256((const __m256i*)(hash_keys + 4));
+    for (size_t s = 0; s < stripes; ++s, p += 64) {
+        const __m256i d0 = _mm256_loadu_si256((const __m256i*)p);
+        const __m256i d1 = _mm256_loadu_si256((const __m256i*)(p + 32));
+        const __m256i dk0 = _mm256_xor_si256(d0, k0);
+        const __m256i dk1 = _mm256_xor_si256(d1, k1);
+        a0 = _mm256_add_epi64(a0, _mm256_add_epi64(_mm256_mul_epu32(dk0, _mm256_srli_epi64(dk0, 32)), d0));
+        a1 = _mm256_add_epi64(a1, _mm256_add_epi64(_mm256_mul_epu32(dk1, _mm256_srli_epi64(dk1, 32)), d1));
+        k0 = _mm256_add_epi64(k0, step);
+        k1 = _mm256_add_epi64(k1, step);
+    }
+    _mm256_storeu_si256((__m256i*)acc, a0);
+    _mm256_storeu_si256((__m256i*)(acc + 4), a1);
+}
+#endif
+
+static HashKernel select_hash_kernel(void) {
+    if (!use_simd) return hash_stripes_scalar;
+    switch (simd_kernel) {
+#if defined(__wasm_simd128__)
+    case ASCII_KERNEL_WASM128: return hash_stripes_wasm128;
+#endif
+#if defined(ASCII_X86_SIMD)
+    case ASCII_KERNEL_AVX2:    return hash_stripes_avx2;
+    case ASCII_KERNEL_SSSE3:   return hash_stripes_sse2;
+#endif
+    default:                   return hash_stripes_scalar;
+    }
+}
+
+static uint64_t hash_bytes(const uint8_t* p, size_t n) {
+    uint64_t acc[8] = { 0 };
+    const size_t stripes = n / 64;
+    select_hash_kernel()(p, stripes, acc);
+    uint64_t h = n * HASH_PRIME;
+    for (int i = 0; i < 8; ++i) h = (h ^ hash_mix64(acc[i])) * HASH_PRIME;
+    for (size_t i = stripes * 64; i < n; ++i) h = (h ^ p[i]) * HASH_PRIME;
+    return hash_mix64(h);
+}
+
+// 소스 + 출력에 영향을 주는 상태(팔레트 세대, 크기, 출력 버퍼, 가중 방식, 패킹 형식, 모양 글리프,
+// 서브셀, 디더링, SIMD/다운샘플 커널 선택, 융합 여부, 시간 필터와 여유폭)가 직전 변환과 같으면 true
+// (커널끼리 결과가 같아도 키에 넣음 → 커널을 바꾼 비교/측정이 캐시된 버퍼로 통과하지 않도록)
+// 벤치마크 모드는 매 프레임 측정해야 하므로 항상 false
+static bool check_frame_unchanged(const void* pixels, int bpp, int src_width, int src_height,
+                                  const AsciiCell* out, int ascii_width, int ascii_height) {
+    frame_unchanged = false;
+    if (!use_frame_skip || benchmark_mode) {
+        frame_hash_valid = false;
+        frames_converted++;
+        return false;
+    }
+    uint64_t h = hash_bytes((const uint8_t*)pixels, (size_t)src_width * src_height * bpp);
+    const uint64_t state[] = {
+        ((uint64_t)src_width << 32) | (uint32_t)src_height,
+        ((uint64_t)ascii_width << 32) | (uint32_t)ascii_height,
+        ((uint64_t)bpp << 32) | (bpp == 1 ? pal_generation : 0),
+        (uint64_t)(uintptr_t)out,
+        ((uint64_t)(use_area_weighting ? 1 : 0) << 32) | (uint32_t)packed_format,
+        ((uint64_t)(use_shape ? 1 : 0) << 32) | (uint32_t)shape_threshold,
+        (uint64_t)subcell_mode,
+        ((uint64_t)dither_mode << 32) | (uint32_t)dither_color_levels(),
+        ((uint64_t)(use_simd ? 1 : 0) << 32) | (uint32_t)simd_kernel,
+        ((uint64_t)(use_specialized ? 1 : 0) << 32) | (uint32_t)downsample_request,
+        ((uint64_t)(use_fused ? 1 : 0) << 32) | (uint32_t)(use_temporal ? 1 : 0),
+        ((uint64_t)temporal_lum_margin << 32) | (uint32_t)temporal_color_margin,
+    };
+    for (uint64_t v : state) h = hash_mix64(h ^ v) * HASH_PRIME;
+
+    if (frame_hash_valid && h == frame_hash) {
+        frame_unchanged = true;
+        frames_skipped++;
+        return true;
+    }
+    frame_hash = h;
+    frame_hash_valid = true;
+    frames_converted++;
+    return false;
+}
+
+// ---------- 시간 히스테리시스 (글리프/색 깜빡임 억제) ----------
+// 셀마다 직전에 내보낸 {문자 번호, r, g, b}를 상태로 두고
+//  - 글리프: 새 밝기가 이전 글리프 구간 [lo, hi]를 lum_margin 넘게 벗어날 때만 새 글리프
+//  - 색: 세 채널 모두 color_margin 이내로 움직였으면 이전 색 유지 (출력/감마 뒤 값 기준)
+// 밝기는 출력 색을 역감마 LUT(gamma_inv)로 되돌려 계산 → 변환 커널은 그대로 두고 후처리로 적용
+// 전체 변환 프레임은 SIMD 커널, 증분 프레임은 델타 셀만 스칼라로 처리하고 델타 목록을 다시 추림
+static void build_temporal_tables(void) {
+    int sum[256] = { 0 }, cnt[256] = { 0 };
+    for (int x = 0; x < 256; ++x) {
+        sum[gamma_table[x]] += x;
+        cnt[gamma_table[x]]++;
+    }
+    int last = 0;
+    for (int y = 0; y < 256; ++y) {
+        if (cnt[y]) last = (sum[y] + cnt[y] / 2) / cnt[y];
+        gamma_inv[y] = (uint8_t)last;  // 나오지 않는 값은 아래쪽 이웃으로
+    }
+    for (int k = 0; k < 16; ++k) {
+        int lo = 256, hi = -1;
+        for (int l = 0; l < 256; ++l) {
+            if (idxLUT[l] != k) continue;
+            lo = std::min(lo, l);
+            hi = std::max(hi, l);
+        }
+        if (hi < 0) { lo = 255; hi = 0; }  // 없는 글리프: 항상 새 글리프
+        else { lo -= temporal_lum_margin; hi += temporal_lum_margin; }
+        hold_lo16[k] = (uint8_t)std::max(0, lo);
+        hold_hi16[k] = (uint8_t)std::min(255, hi);
+    }
+    temporal_tables_ready = true;
+}
+
+static inline int temporal_lum(const AsciiCell& c) {
+    return (gamma_inv[c.r] * 299 + gamma_inv[c.g] * 587 + gamma_inv[c.b] * 114) >> 10;
+}
+
+// 상태의 문자 바이트: 램프 문자면 번호, 모양 글리프면 문자 그대로 (항상 ASCII_CHARS_LEN 이상)
+static inline char temporal_code(char c) {
+    const uint8_t idx = glyph_index_lut[(uint8_t)c];
+    return ASCII_CHARS[idx] == c ? (char)idx : c;
+}
+
+static inline char temporal_char(char code) {
+    return (uint8_t)code < ASCII_CHARS_LEN ? ASCII_CHARS[(uint8_t)code] : code;
+}
+
+// 셀 하나: 출력 셀을 돌려주고 상태 갱신
+// 모양 글리프는 잡아두지 않음 (새 모양 글리프는 그대로, 직전이 모양 글리프면 새 램프 문자)
+static inline AsciiCell temporal_cell(AsciiCell v, AsciiCell& s) {
+    const int cm = temporal_color_margin;
+    AsciiCell o = v;
+    if (std::abs(v.r - s.r) <= cm && std::abs(v.g - s.g) <= cm && std::abs(v.b - s.b) <= cm) {
+        o.r = s.r; o.g = s.g; o.b = s.b;
+    }
+    const int p = (uint8_t)s.character;
+    const int code = (uint8_t)temporal_code(v.character);
+    int idx = code;
+    if (p < ASCII_CHARS_LEN && code < ASCII_CHARS_LEN) {
+        const int lum = temporal_lum(v);
+        if (lum >= hold_lo16[p] && lum <= hold_hi16[p]) idx = p;
+    }
+    o.character = temporal_char((char)idx);
+    s = o;
+    s.character = (char)idx;
+    return o;
+}
+
+typedef int (*TemporalKernel)(AsciiCell*, AsciiCell*, int, int);
+
+static int temporal_scalar(AsciiCell* out, AsciiCell* state, int begin, int end) {
+    int held = 0;
+    for (int i = begin; i < end; ++i) {
+        const AsciiCell v = out[i];
+        out[i] = temporal_cell(v, state[i]);
+        held += std::memcmp(&out[i], &v, sizeof(AsciiCell)) != 0;
+    }
+    return held;
+}
+
+#if defined(__wasm_simd128__)
+static int temporal_wasm128(AsciiCell* out, AsciiCell* state, int begin, int end) {
+    const v128_t low8 = wasm_i32x4_splat(0xFF);
+    const v128_t rb_mask = wasm_i32x4_splat(0x00FF00FF);
+    const v128_t coef_rb = wasm_i32x4_splat((114 << 16) | 299);
+    const v128_t coef_g = wasm_i32x4_splat(587);
+    const v128_t cm = wasm_i8x16_splat((int8_t)temporal_color_margin);
+    const v128_t lo_t = wasm_v128_load(hold_lo16);
+    const v128_t hi_t = wasm_v128_load(hold_hi16);
+    const v128_t chars = wasm_v128_load(ascii_chars16);
+    int held = 0;
+    int i = begin;
+    for (; i <= end - 4; i += 4) {
+        const v128_t v = wasm_v128_load(out + i);
+        const v128_t s = wasm_v128_load(state + i);
+        // 색: 채널별 |v - s| <= cm, 셀 단위로 세 채널 모두
+        const v128_t ad = wasm_v128_or(wasm_u8x16_sub_sat(v, s), wasm_u8x16_sub_sat(s, v));
+        const v128_t near = wasm_v128_or(wasm_u8x16_le(ad, cm), low8);
+        const v128_t col_hold = wasm_i32x4_eq(near, wasm_i32x4_splat(-1));
+        // 문자 → 번호
+        v128_t nidx = wasm_i32x4_splat(0);
+        for (int k = 1; k < ASCII_CHARS_LEN; ++k) {
+            nidx = wasm_v128_or(nidx, wasm_v128_and(wasm_i8x16_eq(v, wasm_i8x16_splat(ASCII_CHARS[k])),
+                                                    wasm_i8x16_splat((int8_t)k)));
+        }
+        nidx = wasm_v128_and(nidx, low8);
+        // 밝기 (역감마)
+        const v128_t lin = lut256_wasm128(gamma_inv, v);
+        const v128_t lum = wasm_u32x4_shr(wasm_i32x4_add(
+            wasm_i32x4_dot_i16x8(wasm_v128_and(wasm_u32x4_shr(lin, 8), rb_mask), coef_rb),
+            wasm_i32x4_dot_i16x8(wasm_v128_and(wasm_u32x4_shr(lin, 16), low8), coef_g)), 10);
+        const v128_t pidx = wasm_v128_and(s, low8);
+        const v128_t lo = wasm_v128_and(wasm_i8x16_swizzle(lo_t, pidx), low8);
+        const v128_t hi = wasm_v128_and(wasm_i8x16_swizzle(hi_t, pidx), low8);
+        const v128_t in_band = wasm_v128_and(wasm_i32x4_ge(lum, lo), wasm_i32x4_le(lum, hi));
+        const v128_t idx = wasm_v128_bitselect(pidx, nidx, in_band);
+        const v128_t col = wasm_v128_andnot(wasm_v128_bitselect(s, v, col_hold), low8);
+        const v128_t o = wasm_v128_or(col, wasm_v128_and(wasm_i8x16_swizzle(chars, idx), low8));
+        wasm_v128_store(state + i, wasm_v128_or(col, idx));
+        wasm_v128_store(out + i, o);
+        held += 4 - __builtin_popcount(wasm_i32x4_bitmask(wasm_i32x4_eq(o, v)));
+    }
+    return held + temporal_scalar(out, state, i, end);
+}
+#endif
+
+#if defined(ASCII_X86_SIMD)
+ASCII_TARGET_SSSE3
+static int temporal_ssse3(AsciiCell* out, AsciiCell* state, int begin, int end) {
+    const __m128i low8 = _mm_set1_epi32(0xFF);
+    const __m128i ones = _mm_set1_epi32(-1);
+    const __m128i rb_mask = _mm_set1_epi32(0x00FF00FF);
+    const __m128i coef_rb = _mm_set1_epi32((114 << 16) | 299);
+    const __m128i coef_g = _mm_set1_epi32(587);
+    const __m128i cm = _mm_set1_epi8((char)temporal_color_margin);
+    const __m128i lo_t = _mm_load_si128((const __m128i*)hold_lo16);
+    const __m128i hi_t = _mm_load_si128((const __m128i*)hold_hi16);
+    const __m128i chars = _mm_load_si128((const __m128i*)ascii_chars16);
+    int held = 0;
+    int i = begin;
+    for (; i <= end - 4; i += 4) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(out + i));
+        const __m128i s = _mm_loadu_si128((const __m128i*)(state + i));
+        // 색: 채널별 |v - s| <= cm, 셀 단위로 세 채널 모두
+        const __m128i ad = _mm_or_si128(_mm_subs_epu8(v, s), _mm_subs_epu8(s, v));
+        const __m128i near = _mm_or_si128(_mm_cmpeq_epi8(_mm_subs_epu8(ad, cm), _mm_setzero_si128()), low8);
+        const __m128i col_hold = _mm_cmpeq_epi32(near, ones);
+        // 문자 → 번호
+        __m128i nidx = _mm_setzero_si128();
+        for (int k = 1; k < ASCII_CHARS_LEN; ++k) {
+            nidx = _mm_or_si128(nidx, _mm_and_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(ASCII_CHARS[k])),
+                                                    _mm_set1_epi8((char)k)));
+        }
+        nidx = _mm_and_si128(nidx, low8);
+        // 밝기 (역감마)
+        const __m128i lin = lut256_ssse3(gamma_inv, v);
+        const __m128i lum = _mm_srli_epi32(_mm_add_epi32(
+            _mm_madd_epi16(_mm_and_si128(_mm_srli_epi32(lin, 8), rb_mask), coef_rb),
+            _mm_madd_epi16(_mm_and_si128(_mm_srli_epi32(lin, 16), low8), coef_g)), 10);
+        const __m128i pidx = _mm_and_si128(s, low8);
+        const __m128i lo = _mm_and_si128(_mm_shuffle_epi8(lo_t, pidx), low8);
+        const __m128i hi = _mm_and_si128(_mm_shuffle_epi8(hi_t, pidx), low8);
+        const __m128i out_band = _mm_or_si128(_mm_cmpgt_epi32(lo, lum), _mm_cmpgt_epi32(lum, hi));
+        const __m128i idx = _mm_or_si128(_mm_andnot_si128(out_band, pidx), _mm_and_si128(out_band, nidx));
+        const __m128i col = _mm_andnot_si128(low8, _mm_or_si128(_mm_and_si128(col_hold, s),
+                                                                _mm_andnot_si128(col_hold, v)));
+        const __m128i o = _mm_or_si128(col, _mm_and_si128(_mm_shuffle_epi8(chars, idx), low8));
+        _mm_storeu_si128((__m128i*)(state + i), _mm_or_si128(col, idx));
+        _mm_storeu_si128((__m128i*)(out + i), o);
+        held += 4 - __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(o, v))));
+    }
+    return held + temporal_scalar(out, state, i, end);
+}
+
+ASCII_TARGET_AVX2
+static int temporal_avx2(AsciiCell* out, AsciiCell* state, int begin, int end) {
+    const __m256i low8 = _mm256_set1_epi32(0xFF);
+    const __m256i ones = _mm256_set1_epi32(-1);
+    const __m256i rb_mask = _mm256_set1_epi32(0x00FF00FF);
+    const __m256i coef_rb = _mm256_set1_epi32((114 << 16) | 299);
+    const __m256i coef_g = _mm256_set1_epi32(587);
+    const __m256i cm = _mm256_set1_epi8((char)temporal_color_margin);
+    const __m256i lo_t = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)hold_lo16));
+    const __m256i hi_t = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)hold_hi16));
+    const __m256i chars = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)ascii_chars16));
+    int held = 0;
+    int i = begin;
+    for (; i <= end - 8; i += 8) {
+        const __m256i v = _mm256_loadu_si256((const __m256i*)(out + i));
+        const __m256i s = _mm256_loadu_si256((const __m256i*)(state + i));
+        const __m256i ad = _mm256_or_si256(_mm256_subs_epu8(v, s), _mm256_subs_epu8(s, v));
+        const __m256i near = _mm256_or_si256(
+            _mm256_cmpeq_epi8(_mm256_subs_epu8(ad, cm), _mm256_setzero_si256()), low8);
+        const __m256i col_hold = _mm256_cmpeq_epi32(near, ones);
+        __m256i nidx = _mm256_setzero_si256();
+        for (int k = 1; k < ASCII_CHARS_LEN; ++k) {
+            nidx = _mm256_or_si256(nidx, _mm256_and_si256(
+                _mm256_cmpeq_epi8(v, _mm256_set1_epi8(ASCII_CHARS[k])), _mm256_set1_epi8((char)k)));
+        }
+        nidx = _mm256_and_si256(nidx, low8);
+        const __m256i lin = lut256_avx2(gamma_inv, v);
+        const __m256i lum = _mm256_srli_epi32(_mm256_add_epi32(
+            _mm256_madd_epi16(_mm256_and_si256(_mm256_srli_epi32(lin, 8), rb_mask), coef_rb),
+            _mm256_madd_epi16(_mm256_and_si256(_mm256_srli_epi32(lin, 16), low8), coef_g)), 10);
+        const __m256i pidx = _mm256_and_si256(s, low8);
+        const __m256i lo = _mm256_and_si256(_mm256_shuffle_epi8(lo_t, pidx), low8);
+        const __m256i hi = _mm256_and_si256(_mm256_shuffle_epi8(hi_t, pidx), low8);
+        const __m256i out_band = _mm256_or_si256(_mm256_cmpgt_epi32(lo, lum), _mm256_cmpgt_epi32(lum, hi));
+        const __m256i idx = _mm256_blendv_epi8(pidx, nidx, out_band);
+        const __m256i col = _mm256_andnot_si256(low8, _mm256_blendv_epi8(v, s, col_hold));
+        const __m256i o = _mm256_or_si256(col, _mm256_and_si256(_mm256_shuffle_epi8(chars, idx), low8));
+        _mm256_storeu_si256((__m256i*)(state + i), _mm256_or_si256(col, idx));
+        _mm256_storeu_si256((__m256i*)(out + i), o);
+        held += 8 - __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(o, v))));
+    }
+    return held + temporal_ssse3(out, state, i, end);
+}
+#endif
+
+static TemporalKernel select_temporal_kernel(void) {
+    // SIMD 커널은 상태 바이트를 램프 번호로만 다룸
+    if (!use_simd || use_shape) return temporal_scalar;
+    switch (simd_kernel) {
+#if defined(__wasm_simd128__)
+    case ASCII_KERNEL_WASM128: return temporal_wasm128;
+#endif
+#if defined(ASCII_X86_SIMD)
+    case ASCII_KERNEL_AVX2:    return temporal_avx2;
+    case ASCII_KERNEL_SSSE3:   return temporal_ssse3;
+#endif
+    default:                   return temporal_scalar;
+    }
+}
+
+// 변환 직후, 패킹 전에 호출. 상태가 없거나 (그리드/출력 버퍼가 바뀌면) 이번 출력을 상태로 삼음
+static void apply_temporal(AsciiCell* out, int ascii_width, int ascii_height) {
+    temporal_stabilized = 0;
+    const int total = ascii_width * ascii_height;
+    if (!temporal_tables_ready) build_temporal_tables();
+    if (temporal_capacity < total) {
+        AsciiCell* st = (AsciiCell*)ascii_aligned_alloc(32, sizeof(AsciiCell) * (size_t)total);
+        if (!st) return;
+        ascii_aligned_free(temporal_state);
+        temporal_state = st;
+        temporal_capacity = total;
+        temporal_valid = false;
+    }
+    if (!temporal_valid || temporal_out != out
+     || temporal_w != ascii_width || temporal_h != ascii_height) {
+        for (int i = 0; i < total; ++i) {
+            temporal_state[i] = out[i];
+            temporal_state[i].character = temporal_code(out[i].character);
+        }
+        temporal_out = out;
+        temporal_w = ascii_width;
+        temporal_h = ascii_height;
+        temporal_valid = true;
+        return;
+    }
+
+    if (delta_full) {
+        temporal_stabilized = select_temporal_kernel()(out, temporal_state, 0, total);
+        return;
+    }
+
+    // 증분: 바뀐 셀만 거르고, 결과가 이전 출력과 같아진 셀은 델타에서 뺌
+    int n = 0;
+    for (int k = 0; k < delta_count; ++k) {
+        const uint32_t index = delta_list[k].index;
+        AsciiCell prev = temporal_state[index];
+        prev.character = temporal_char(prev.character);
+        const AsciiCell raw = out[index];
+        const AsciiCell o = temporal_cell(raw, temporal_state[index]);
+        out[index] = o;
+        temporal_stabilized += std::memcmp(&o, &raw, sizeof(AsciiCell)) != 0;
+        if (std::memcmp(&o, &prev, sizeof(AsciiCell)) == 0) continue;
+        delta_list[n].index = index;
+        delta_list[n].cell = o;
+        n++;
+    }
+    delta_count = n;
+}
+
+// ---------- 모양 글리프 (하위 셀 밝기 서명) ----------
+// 셀을 2x2 사분면으로 나눠 사분면별 평균 밝기를 3비트씩 양자화 → 12비트 키 → shape_table 한 번 조회
+// 표는 처음 켤 때 textscreen 8x16 폰트의 사분면 커버리지로 후보 글리프마다 오차 제곱합을 재서 채움
+// 사분면 밝기 차가 shape_threshold 미만이거나 네 사분면이 같은 단계면 패스2의 램프 문자 유지 (색은 그대로)
+// 셀이 소스 1픽셀보다 좁으면 사분면을 이웃 픽셀까지 넓혀 최소 1픽셀씩 읽음
+
+typedef struct {
+    const char *name;
+    const uint8_t *data;
+    unsigned int w;
+    unsigned int h;
+} txt_font_t;
+
+#include "../textscreen/fonts/normal.h"
+
+// 후보: 램프 + 윤곽선에 쓰이는 문장부호/글자
+static constexpr char SHAPE_CHARS[] = "'`,_^\"~;!|/\\()[]{}<>LJTY7VAvrjnuoPbdqpF";
+
+static void build_shape_table(void) {
+    init_luts_once();
+    const txt_font_t& f = normal_font;
+    const int fw = (int)f.w, fh = (int)f.h;
+    auto coverage = [&](uint8_t ch, float cov[4]) {
+        int lit[4] = { 0, 0, 0, 0 };
+        const uint8_t* p = &f.data[(ch * fw * fh) / 8];
+        for (int i = 0; i < fw * fh; ++i) {
+            if (p[i >> 3] & (1 << (i & 7))) lit[((i / fw) * 2 / fh) * 2 + (i % fw) * 2 / fw]++;
+        }
+        for (int q = 0; q < 4; ++q) cov[q] = lit[q] / (float)(fw * fh / 4);
+    };
+
+    struct Candidate { uint8_t ch; float cov[4]; };
+    Candidate cand[ASCII_CHARS_LEN + sizeof(SHAPE_CHARS)];
+    int n = 0;
+    for (int k = 0; k < ASCII_CHARS_LEN; ++k) {
+        cand[n].ch = (uint8_t)ASCII_CHARS[k];
+        coverage(cand[n].ch, cand[n].cov);
+        n++;
+    }
+    const float* dense = cand[ASCII_CHARS_LEN - 1].cov;
+    const float cov_max = (dense[0] + dense[1] + dense[2] + dense[3]) / 4.0f;
+    for (const char* c = SHAPE_CHARS; *c; ++c) {
+        cand[n].ch = (uint8_t)*c;
+        coverage(cand[n].ch, cand[n].cov);
+        // 램프 밖 문자: 패킹(4비트 문자 번호)은 평균 커버리지가 가장 가까운 램프 문자로
+        const float m = (cand[n].cov[0] + cand[n].cov[1] + cand[n].cov[2] + cand[n].cov[3]) / 4.0f;
+        int best = 0;
+        for (int k = 1; k < ASCII_CHARS_LEN; ++k) {
+            const float* ck = cand[k].cov;
+            const float mk = (ck[0] + ck[1] + ck[2] + ck[3]) / 4.0f;
+            const float* cb = cand[best].cov;
+            if (std::fabs(mk - m) < std::fabs((cb[0] + cb[1] + cb[2] + cb[3]) / 4.0f - m)) best = k;
+        }
+        glyph_index_lut[cand[n].ch] = (uint8_t)best;
+        n++;
+    }
+
+    // 키: 사분면(왼위, 오른위, 왼아래, 오른아래)마다 밝기 >> 5. 목표 커버리지 = 단계 중앙 밝기 비례
+    for (int key = 0; key < 4096; ++key) {
+        float t[4];
+        int lo = 7, hi = 0;
+        for (int q = 0; q < 4; ++q) {
+            const int level = (key >> (q * 3)) & 7;
+            lo = std::min(lo, level);
+            hi = std::max(hi, level);
+            t[q] = (level * 32 + 16) / 255.0f * cov_max;
+        }
+        shape_table[key] = 0;
+        if (lo == hi) continue;
+        float best = 1e9f;
+        for (int c = 0; c < n; ++c) {
+            float e = 0.0f;
+            for (int q = 0; q < 4; ++q) e += (cand[c].cov[q] - t[q]) * (cand[c].cov[q] - t[q]);
+            if (e < best) { best = e; shape_table[key] = cand[c].ch; }
+        }
+    }
+    shape_table_ready = true;
+}
+
+// 사분면 경계: 셀 [x0, x1)의 가운데 xm에서 나누고 빈 쪽은 바깥 이웃 픽셀 하나로
+static void build_shape_axis(int src, int dst, int* q) {
+    for (int c = 0; c < dst; ++c) {
+        const int a = (int)((int64_t)c * src / dst);
+        const int b = (int)(((int64_t)(c + 1) * src + dst - 1) / dst);
+        const int m = std::min(src - 1, std::max(1, (int)(((int64_t)(2 * c + 1) * src + dst) / (2 * dst))));
+        q[c * 3 + 0] = std::min(a, m - 1);
+        q[c * 3 + 1] = m;
+        q[c * 3 + 2] = std::max(b, m + 1);
+    }
+}
+
+static bool ensure_shape_plan(int src_w, int src_h, int ascii_w, int ascii_h) {
+    if (!shape_table_ready) build_shape_table();
+    if (src_w < 2 || src_h < 2) return false;
+    if (shape_sw == src_w && shape_sh == src_h && shape_aw == ascii_w && shape_ah == ascii_h) return true;
+
+    free(shape_qx); free(shape_qy); free(shape_prefix);
+    shape_qx = (int*)malloc(sizeof(int) * 3 * ascii_w);
+    shape_qy = (int*)malloc(sizeof(int) * 3 * ascii_h);
+    shape_prefix = (uint32_t*)malloc(sizeof(uint32_t) * 2 * (src_w + 1));
+    build_shape_axis(src_w, ascii_w, shape_qx);
+    build_shape_axis(src_h, ascii_h, shape_qy);
+
+    int max_w = 1, max_h = 1;
+    for (int c = 0; c < ascii_w; ++c) {
+        max_w = std::max(max_w, std::max(shape_qx[c*3+1] - shape_qx[c*3], shape_qx[c*3+2] - shape_qx[c*3+1]));
+    }
+    for (int c = 0; c < ascii_h; ++c) {
+        max_h = std::max(max_h, std::max(shape_qy[c*3+1] - shape_qy[c*3], shape_qy[c*3+2] - shape_qy[c*3+1]));
+    }
+    if (shape_inv_size <= max_w * max_h) {
+        free(shape_inv);
+        shape_inv_size = max_w * max_h + 1;
+        shape_inv = (uint32_t*)malloc(sizeof(uint32_t) * shape_inv_size);
+        shape_inv[0] = 0;
+        for (int a = 1; a < shape_inv_size; ++a) shape_inv[a] = (1u << 16) / (uint32_t)a;
+    }
+    shape_sw = src_w; shape_sh = src_h; shape_aw = ascii_w; shape_ah = ascii_h;
+    return true;
+}
+
+// 셀 행 cy의 [cx0, cx0 + n) 셀 문자를 모양 글리프로 (cells[0]이 cx0). 바꾼 셀 수
+// 위/아래 띠마다 열 합을 한 번 구해 누적 → 사분면 합은 셀당 뺄셈 4번
+template <class Source>
+static int shape_cells(const Source& src, int w, int cy, int cx0, int n, AsciiCell* cells) {
+    const int* qy = shape_qy + cy * 3;
+    const int xa = shape_qx[cx0 * 3], xb = shape_qx[(cx0 + n - 1) * 3 + 2];
+    uint32_t* top = shape_prefix;
+    uint32_t* bot = shape_prefix + (w + 1);
+    for (int x = xa; x < xb; ++x) { top[x + 1] = 0; bot[x + 1] = 0; }
+    for (int band = 0; band < 2; ++band) {
+        uint32_t* col = (band ? bot : top) + 1;
+        int y = qy[band];
+        for (; y + 1 < qy[band + 1]; y += 2) {  // 두 행씩: 열 합 읽고 쓰기 절반
+            const int base = y * w;
+            for (int x = xa; x < xb; ++x) col[x] += src.lum(base + x) + src.lum(base + w + x);
+        }
+        if (y < qy[band + 1]) {
+            const int base = y * w;
+            for (int x = xa; x < xb; ++x) col[x] += src.lum(base + x);
+        }
+    }
+    top[xa] = 0; bot[xa] = 0;
+    for (int x = xa; x < xb; ++x) { top[x + 1] += top[x]; bot[x + 1] += bot[x]; }
+
+    const int h_top = qy[1] - qy[0], h_bot = qy[2] - qy[1];
+    const int threshold = shape_threshold;
+    int matched = 0;
+    for (int k = 0; k < n; ++k) {
+        const int* qx = shape_qx + (cx0 + k) * 3;
+        const int w_l = qx[1] - qx[0], w_r = qx[2] - qx[1];
+        const int q0 = (int)(((top[qx[1]] - top[qx[0]]) * (uint64_t)shape_inv[w_l * h_top]) >> 16);
+        const int q1 = (int)(((top[qx[2]] - top[qx[1]]) * (uint64_t)shape_inv[w_r * h_top]) >> 16);
+        const int q2 = (int)(((bot[qx[1]] - bot[qx[0]]) * (uint64_t)shape_inv[w_l * h_bot]) >> 16);
+        const int q3 = (int)(((bot[qx[2]] - bot[qx[1]]) * (uint64_t)shape_inv[w_r * h_bot]) >> 16);
+        const int lo = std::min(std::min(q0, q1), std::min(q2, q3));
+        const int hi = std::max(std::max(q0, q1), std::max(q2, q3));
+        if (hi - lo < threshold) continue;
+        const int key = (std::min(q0, 255) >> 5) | (std::min(q1, 255) >> 5) << 3
+                      | (std::min(q2, 255) >> 5) << 6 | (std::min(q3, 255) >> 5) << 9;
+        const uint8_t ch = shape_table[key];
+        if (!ch) continue;
+        cells[k].character = (char)ch;
+        matched++;
+    }
+    return matched;
+}
+
+// ---------- 하위 셀 출력 (반 블록/점자) ----------
+// 셀을 하위 픽셀(반 블록 1x2, 점자 2x4)로 나눠 적분영상 박스 합으로 평균 RGB/밝기 → 셀 한 행씩 평면에
+// 반 블록: 위/아래 평균이 곧 전경/배경. 점자: 8개 평균 밝기보다 밝은 점을 켜고 켜진/꺼진 점 평균을 전경/배경으로
+// 하위 픽셀이 소스 1픽셀보다 작으면 (그리드가 소스보다 촘촘하면) 가장 가까운 1픽셀을 읽음
+// 셀 출력(AsciiCell)과 따로 매 변환 프레임마다 전체를 다시 만듦 (증분 프레임이면 적분영상도 여기서)
+
+// 유니코드 점자 점 번호 → 비트: [하위 행][왼쪽/오른쪽 열]
+static constexpr uint8_t BRAILLE_BITS[4][2] = {
+    { 0x01, 0x08 }, { 0x02, 0x10 }, { 0x04, 0x20 }, { 0x40, 0x80 }
+};
+
+static void build_sub_axis(int src, int n, int* q) {
+    for (int i = 0; i < n; ++i) {
+        const int a = (int)((int64_t)i * src / n);
+        const int b = (int)((int64_t)(i + 1) * src / n);
+        q[i * 2 + 0] = a;
+        q[i * 2 + 1] = std::max(b, a + 1);
+    }
+}
+
+static bool ensure_subcell_plan(int mode, int src_w, int src_h, int ascii_w, int ascii_h) {
+    const int cells = ascii_w * ascii_h;
+    if (wide_capacity < cells) {
+        AsciiWideCell* buf = (AsciiWideCell*)ascii_aligned_alloc(32, sizeof(AsciiWideCell) * (size_t)cells);
+        if (!buf) return false;
+        ascii_aligned_free(wide_buffer);
+        wide_buffer = buf;
+        wide_capacity = cells;
+    }
+    if (sub_mode == mode && sub_sw == src_w && sub_sh == src_h &&
+        sub_aw == ascii_w && sub_ah == ascii_h) return true;
+
+    const int kx = mode == ASCII_SUBCELL_BRAILLE ? 2 : 1;
+    const int ky = mode == ASCII_SUBCELL_BRAILLE ? 4 : 2;
+    const int nx = ascii_w * kx, ny = ascii_h * ky;
+    // 평면 16행(하위 행 4 x 채널 4) + 커널 출력 3개
+    const int stride = (nx + 15) & ~15;
+    const int out_stride = (ascii_w + 15) & ~15;
+    void* block = ascii_aligned_alloc(32, sizeof(uint16_t) * 16 * (size_t)stride +
+                                          sizeof(uint32_t) * 3 * (size_t)out_stride);
+    if (!block) return false;
+    ascii_aligned_free(sub_block);
+    sub_block = block;
+    sub_stride = stride;
+    sub_plane = (uint16_t*)block;
+    sub_bits = (uint32_t*)(sub_plane + 16 * (size_t)stride);
+    sub_fg = sub_bits + out_stride;
+    sub_bg = sub_fg + out_stride;
+
+    free(sub_x); free(sub_y);
+    sub_x = (int*)malloc(sizeof(int) * 2 * nx);
+    sub_y = (int*)malloc(sizeof(int) * 2 * ny);
+    build_sub_axis(src_w, nx, sub_x);
+    build_sub_axis(src_h, ny, sub_y);
+
+    int max_w = 1, max_h = 1;
+    for (int i = 0; i < nx; ++i) max_w = std::max(max_w, sub_x[i*2+1] - sub_x[i*2]);
+    for (int i = 0; i < ny; ++i) max_h = std::max(max_h, sub_y[i*2+1] - sub_y[i*2]);
+    if (sub_inv_size <= max_w * max_h) {
+        free(sub_inv);
+        sub_inv_size = max_w * max_h + 1;
+        sub_inv = (uint32_t*)malloc(sizeof(uint32_t) * sub_inv_size);
+        sub_inv[0] = 0;
+        for (int a = 1; a < sub_inv_size; ++a) sub_inv[a] = (1u << 16) / (uint32_t)a;
+    }
+    sub_mode = mode; sub_sw = src_w; sub_sh = src_h; sub_aw = ascii_w; sub_ah = ascii_h;
+    return true;
+}
+
+// 셀 행 cy의 하위 픽셀 rows행 x cols열 → sub_plane (적분영상 박스 합, 정수 평균은 패스1과 같은 방식)
+static void fill_sub_rows(int cy, int rows, int cols) {
+    const int W = I_W;
+    for (int r = 0; r < rows; ++r) {
+        const int* yy = sub_y + (cy * rows + r) * 2;
+        const int h = yy[1] - yy[0];
+        const uint32_t *r0 = I_R + yy[0] * W, *r1 = I_R + yy[1] * W;
+        const uint32_t *g0 = I_G + yy[0] * W, *g1 = I_G + yy[1] * W;
+        const uint32_t *b0 = I_B + yy[0] * W, *b1 = I_B + yy[1] * W;
+        uint16_t* L = sub_plane + (size_t)(r * 4) * sub_stride;
+        uint16_t* R = L + sub_stride;
+        uint16_t* G = R + sub_stride;
+        uint16_t* B = G + sub_stride;
+        for (int j = 0; j < cols; ++j) {
+            const int x0 = sub_x[j * 2], x1 = sub_x[j * 2 + 1];
+            const uint32_t inv = sub_inv[(x1 - x0) * h];
+            const uint32_t rv = ((r1[x1] - r1[x0] - r0[x1] + r0[x0]) * inv) >> 16;
+            const uint32_t gv = ((g1[x1] - g1[x0] - g0[x1] + g0[x0]) * inv) >> 16;
+            const uint32_t bv = ((b1[x1] - b1[x0] - b0[x1] + b0[x0]) * inv) >> 16;
+            L[j] = (uint16_t)((rv * 299 + gv * 587 + bv * 114) >> 10);
+            R[j] = (uint16_t)rv;
+            G[j] = (uint16_t)gv;
+            B[j] = (uint16_t)bv;
+        }
+    }
+}
+
+// 점자 커널: 셀 [begin, end) → 점 비트, 켜진 점 평균색, 꺼진 점 평균색 (0x00RRGGBB, 감마 전)
+// 평균 = (합 + n/2) / max(n, 1). SIMD는 float 나눗셈 후 버림 (합 < 2^12라 정수 나눗셈과 같음)
+typedef void (*BrailleKernel)(const uint16_t* plane, int stride, uint32_t* bits,
+                              uint32_t* fg, uint32_t* bg, int begin, int end);
+
+static void braille_scalar(const uint16_t* plane, int stride, uint32_t* bits,
+                           uint32_t* fg, uint32_t* bg, int begin, int end) {
+    for (int cx = begin; cx < end; ++cx) {
+        int lsum = 0;
+        for (int r = 0; r < 4; ++r) {
+            const uint16_t* L = plane + (size_t)(r * 4) * stride + cx * 2;
+            lsum += L[0] + L[1];
+        }
+        const int t = lsum >> 3;
+        uint32_t b = 0;
+        int n_on = 0, on[3] = { 0, 0, 0 }, all[3] = { 0, 0, 0 };
+        for (int r = 0; r < 4; ++r) {
+            for (int c = 0; c < 2; ++c) {
+                const uint16_t* P = plane + (size_t)(r * 4) * stride + cx * 2 + c;
+                const bool lit = P[0] > t;
+                for (int ch = 0; ch < 3; ++ch) {
+                    const int v = P[(ch + 1) * stride];
+                    all[ch] += v;
+                    if (lit) on[ch] += v;
+                }
+                if (lit) { b |= BRAILLE_BITS[r][c]; n_on++; }
+            }
+        }
+        const int n_off = 8 - n_on;
+        uint32_t f = 0, g = 0;
+        for (int ch = 0; ch < 3; ++ch) {
+            f = (f << 8) | (uint32_t)((on[ch] + n_on / 2) / std::max(n_on, 1));
+            g = (g << 8) | (uint32_t)((all[ch] - on[ch] + n_off / 2) / std::max(n_off, 1));
+        }
+        bits[cx] = b;
+        fg[cx] = f;
+        bg[cx] = g;
+    }
+}
+
+// SIMD 공통: 16비트 레인 하나 = 하위 픽셀 하나, 32비트 레인 하나 = 셀 하나의 왼/오른 열
+//  1) 하위 행 4개 밝기 합 → pair 내적(madd)으로 셀 합 → >> 3 = 임계값을 두 16비트 반쪽에 복제
+//  2) 행마다 비교 마스크로 점 비트/켜진 점 수/켜진 점 RGB 합 누적 (16비트, 최대 4 * 255)
+//  3) pair 내적으로 셀 단위 32비트 합 → 꺼진 점 = 전체 - 켜진 점 → float 나눗셈으로 평균
+#if defined(__wasm_simd128__)
+static inline v128_t braille_mean_wasm128(v128_t sum, v128_t n) {
+    const v128_t num = wasm_i32x4_add(sum, wasm_u32x4_shr(n, 1));
+    const v128_t d = wasm_i32x4_sub(n, wasm_i32x4_eq(n, wasm_i32x4_splat(0)));
+    return wasm_i32x4_trunc_sat_f32x4(wasm_f32x4_div(wasm_f32x4_convert_i32x4(num),
+                                                     wasm_f32x4_convert_i32x4(d)));
+}
+
+static void braille_wasm128(const uint16_t* plane, int stride, uint32_t* bits,
+                            uint32_t* fg, uint32_t* bg, int begin, int end) {
+    const v128_t ones = wasm_i16x8_splat(1);
+    const v128_t eight = wasm_i32x4_splat(8);
+    int cx = begin;
+    for (; cx <= end - 4; cx += 4) {
+        const uint16_t* p = plane + cx * 2;
+        v128_t L[4];
+        v128_t lsum = wasm_i16x8_splat(0);
+        for (int r = 0; r < 4; ++r) {
+            L[r] = wasm_v128_load(p + (size_t)(r * 4) * stride);
+            lsum = wasm_i16x8_add(lsum, L[r]);
+        }
+        const v128_t t32 = wasm_u32x4_shr(wasm_i32x4_dot_i16x8(lsum, ones), 3);
+        const v128_t t = wasm_v128_or(t32, wasm_i32x4_shl(t32, 16));
+        v128_t b = wasm_i16x8_splat(0), cnt = b, on_r = b, on_g = b, on_b = b, all_r = b, all_g = b, all_b = b;
+        for (int r = 0; r < 4; ++r) {
+            const uint16_t* q = p + (size_t)(r * 4) * stride;
+            const v128_t m = wasm_i16x8_gt(L[r], t);
+            const v128_t R = wasm_v128_load(q + stride);
+            const v128_t G = wasm_v128_load(q + 2 * stride);
+            const v128_t B = wasm_v128_load(q + 3 * stride);
+            b = wasm_v128_or(b, wasm_v128_and(m, wasm_i32x4_splat((BRAILLE_BITS[r][1] << 16) | BRAILLE_BITS[r][0])));
+            cnt = wasm_i16x8_sub(cnt, m);
+            on_r = wasm_i16x8_add(on_r, wasm_v128_and(m, R));
+            on_g = wasm_i16x8_add(on_g, wasm_v128_and(m, G));
+            on_b = wasm_i16x8_add(on_b, wasm_v128_and(m, B));
+            all_r = wasm_i16x8_add(all_r, R);
+            all_g = wasm_i16x8_add(all_g, G);
+            all_b = wasm_i16x8_add(all_b, B);
+        }
+        const v128_t n_on = wasm_i32x4_dot_i16x8(cnt, ones);
+        const v128_t n_off = wasm_i32x4_sub(eight, n_on);
+        const v128_t sr = wasm_i32x4_dot_i16x8(on_r, ones);
+        const v128_t sg = wasm_i32x4_dot_i16x8(on_g, ones);
+        const v128_t sb = wasm_i32x4_dot_i16x8(on_b, ones);
+        const v128_t f = wasm_v128_or(wasm_v128_or(
+            wasm_i32x4_shl(braille_mean_wasm128(sr, n_on), 16),
+            wasm_i32x4_shl(braille_mean_wasm128(sg, n_on), 8)), braille_mean_wasm128(sb, n_on));
+        const v128_t g = wasm_v128_or(wasm_v128_or(
+            wasm_i32x4_shl(braille_mean_wasm128(wasm_i32x4_sub(wasm_i32x4_dot_i16x8(all_r, ones), sr), n_off), 16),
+            wasm_i32x4_shl(braille_mean_wasm128(wasm_i32x4_sub(wasm_i32x4_dot_i16x8(all_g, ones), sg), n_off), 8)),
+            braille_mean_wasm128(wasm_i32x4_sub(wasm_i32x4_dot_i16x8(all_b, ones), sb), n_off));
+        wasm_v128_store(bits + cx, wasm_i32x4_dot_i16x8(b, ones));
+        wasm_v128_store(fg + cx, f);
+        wasm_v128_store(bg + cx, g);
+    }
+    braille_scalar(plane, stride, bits, fg, bg, cx, end);
+}
+#endif
+
+#if defined(ASCII_X86_SIMD)
+static inline __m128i braille_mean_sse2(__m128i sum, __m128i n) {
+    const __m128i num = _mm_add_epi32(sum, _mm_srli_epi32(n, 1));
+    const __m128i d = _mm_sub_epi32(n, _mm_cmpeq_epi32(n, _mm_setzero_si128()));
+    return _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(num), _mm_cvtepi32_ps(d)));
+}
+
+static void braille_sse2(const uint16_t* plane, int stride, uint32_t* bits,
+                         uint32_t* fg, uint32_t* bg, int begin, int end) {
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i eight = _mm_set1_epi32(8);
+    int cx = begin;
+    for (; cx <= end - 4; cx += 4) {
+        const uint16_t* p = plane + cx * 2;
+        __m128i L[4];
+        __m128i lsum = _mm_setzero_si128();
+        for (int r = 0; r < 4; ++r) {
+            L[r] = _mm_loadu_si128((const __m128i*)(p + (size_t)(r * 4) * stride));
+            lsum = _mm_add_epi16(lsum, L[r]);
+        }
+        const __m128i t32 = _mm_srli_epi32(_mm_madd_epi16(lsum, ones), 3);
+        const __m128i t = _mm_or_si128(t32, _mm_slli_epi32(t32, 16));
+        __m128i b = _mm_setzero_si128(), cnt = b, on_r = b, on_g = b, on_b = b, all_r = b, all_g = b, all_b = b;
+        for (int r = 0; r < 4; ++r) {
+            const uint16_t* q = p + (size_t)(r * 4) * stride;
+            const __m128i m = _mm_cmpgt_epi16(L[r], t);
+            const __m128i R = _mm_loadu_si128((const __m128i*)(q + stride));
+            const __m128i G = _mm_loadu_si128((const __m128i*)(q + 2 * stride));
+            const __m128i B = _mm_loadu_si128((const __m128i*)(q + 3 * stride));
+            b = _mm_or_si128(b, _mm_and_si128(m, _mm_set1_epi32((BRAILLE_BITS[r][1] << 16) | BRAILLE_BITS[r][0])));
+            cnt = _mm_sub_epi16(cnt, m);
+            on_r = _mm_add_epi16(on_r, _mm_and_si128(m, R));
+            on_g = _mm_add_epi16(on_g, _mm_and_si128(m, G));
+            on_b = _mm_add_epi16(on_b, _mm_and_si128(m, B));
+            all_r = _mm_add_epi16(all_r, R);
+            all_g = _mm_add_epi16(all_g, G);
+            all_b = _mm_add_epi16(all_b, B);
+        }
+        const __m128i n_on = _mm_madd_epi16(cnt, ones);
+        const __m128i n_off = _mm_sub_epi32(eight, n_on);
+        const __m128i sr = _mm_madd_epi16(on_r, ones);
+        const __m128i sg = _mm_madd_epi16(on_g, ones);
+        const __m128i sb = _mm_madd_epi16(on_b, ones);
+        const __m128i f = _mm_or_si128(_mm_or_si128(
+            _mm_slli_epi32(braille_mean_sse2(sr, n_on), 16),
+            _mm_slli_epi32(braille_mean_sse2(sg, n_on), 8)), braille_mean_sse2(sb, n_on));
+        const __m128i g = _mm_or_si128(_mm_or_si128(
+            _mm_slli_epi32(braille_mean_sse2(_mm_sub_epi32(_mm_madd_epi16(all_r, ones), sr), n_off), 16),
+            _mm_slli_epi32(braille_mean_sse2(_mm_sub_epi32(_mm_madd_epi16(all_g, ones), sg), n_off), 8)),
+            braille_mean_sse2(_mm_sub_epi32(_mm_madd_epi16(all_b, ones), sb), n_off));
+        _mm_storeu_si128((__m128i*)(bits + cx), _mm_madd_epi16(b, ones));
+        _mm_storeu_si128((__m128i*)(fg + cx), f);
+        _mm_storeu_si128((__m128i*)(bg + cx), g);
+    }
+    braille_scalar(plane, stride, bits, fg, bg, cx, end);
+}
+
+ASCII_TARGET_AVX2
+static inline __m256i braille_mean_avx2(__m256i sum, __m256i n) {
+    const __m256i num = _mm256_add_epi32(sum, _mm256_srli_epi32(n, 1));
+    const __m256i d = _mm256_max_epi32(n, _mm256_set1_epi32(1));
+    return _mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(num), _mm256_cvtepi32_ps(d)));
+}
+
+ASCII_TARGET_AVX2
+static void braille_avx2(const uint16_t* plane, int stride, uint32_t* bits,
+                         uint32_t* fg, uint32_t* bg, int begin, int end) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256i eight = _mm256_set1_epi32(8);
+    int cx = begin;
+    for (; cx <= end - 8; cx += 8) {
+        const uint16_t* p = plane + cx * 2;
+        __m256i L[4];
+        __m256i lsum = _mm256_setzero_si256();
+        for (int r = 0; r < 4; ++r) {
+            L[r] = _mm256_loadu_si256((const __m256i*)(p + (size_t)(r * 4) * stride));
+            lsum = _mm256_add_epi16(lsum, L[r]);
+        }
+        const __m256i t32 = _mm256_srli_epi32(_mm256_madd_epi16(lsum, ones), 3);
+        const __m256i t = _mm256_or_si256(t32, _mm256_slli_epi32(t32, 16));
+        __m256i b = _mm256_setzero_si256(), cnt = b, on_r = b, on_g = b, on_b = b, all_r = b, all_g = b, all_b = b;
+        for (int r = 0; r < 4; ++r) {
+            const uint16_t* q = p + (size_t)(r * 4) * stride;
+            const __m256i m = _mm256_cmpgt_epi16(L[r], t);
+            const __m256i R = _mm256_loadu_si256((const __m256i*)(q + stride));
+            const __m256i G = _mm256_loadu_si256((const __m256i*)(q + 2 * stride));
+            const __m256i B = _mm256_loadu_si256((const __m256i*)(q + 3 * stride));
+            b = _mm256_or_si256(b, _mm256_and_si256(m, _mm256_set1_epi32((BRAILLE_BITS[r][1] << 16) | BRAILLE_BITS[r][0])));
+            cnt = _mm256_sub_epi16(cnt, m);
+            on_r = _mm256_add_epi16(on_r, _mm256_and_si256(m, R));
+            on_g = _mm256_add_epi16(on_g, _mm256_and_si256(m, G));
+            on_b = _mm256_add_epi16(on_b, _mm256_and_si256(m, B));
+            all_r = _mm256_add_epi16(all_r, R);
+            all_g = _mm256_add_epi16(all_g, G);
+            all_b = _mm256_add_epi16(all_b, B);
+        }
+        const __m256i n_on = _mm256_madd_epi16(cnt, ones);
+        const __m256i n_off = _mm256_sub_epi32(eight, n_on);
+        const __m256i sr = _mm256_madd_epi16(on_r, ones);
+        const __m256i sg = _mm256_madd_epi16(on_g, ones);
+        const __m256i sb = _mm256_madd_epi16(on_b, ones);
+        const __m256i f = _mm256_or_si256(_mm256_or_si256(
+            _mm256_slli_epi32(braille_mean_avx2(sr, n_on), 16),
+            _mm256_slli_epi32(braille_mean_avx2(sg, n_on), 8)), braille_mean_avx2(sb, n_on));
+        const __m256i g = _mm256_or_si256(_mm256_or_si256(
+            _mm256_slli_epi32(braille_mean_avx2(_mm256_sub_epi32(_mm256_madd_epi16(all_r, ones), sr), n_off), 16),
+            _mm256_slli_epi32(braille_mean_avx2(_mm256_sub_epi32(_mm256_madd_epi16(all_g, ones), sg), n_off), 8)),
+            braille_mean_avx2(_mm256_sub_epi32(_mm256_madd_epi16(all_b, ones), sb), n_off));
+        _mm256_storeu_si256((__m256i*)(bits + cx), _mm256_madd_epi16(b, ones));
+        _mm256_storeu_si256((__m256i*)(fg + cx), f);
+        _mm256_storeu_si256((__m256i*)(bg + cx), g);
+    }
+    braille_sse2(plane, stride, bits, fg, bg, cx, end);
+}
+#endif
+
+static BrailleKernel select_braille_kernel(void) {
+    if (!use_simd) return braille_scalar;
+    switch (simd_kernel) {
+#if defined(__wasm_simd128__)
+    case ASCII_KERNEL_WASM128: return braille_wasm128;
+#endif
+#if defined(ASCII_X86_SIMD)
+    case ASCII_KERNEL_AVX2:    return braille_avx2;
+    case ASCII_KERNEL_SSSE3:   return braille_sse2;
+#endif
+    default:                   return braille_scalar;
+    }
+}
+
+static inline void store_wide_cell(AsciiWideCell& c, uint16_t codepoint, uint32_t fg, uint32_t bg) {
+    c.codepoint = codepoint;
+    c.fg_r = gamma_table[fg >> 16];
+    c.fg_g = gamma_table[(fg >> 8) & 0xFF];
+    c.fg_b = gamma_table[fg & 0xFF];
+    c.bg_r = gamma_table[bg >> 16];
+    c.bg_g = gamma_table[(bg >> 8) & 0xFF];
+    c.bg_b = gamma_table[bg & 0xFF];
+}
+
+template <class Source>
+static void convert_subcells(const Source& src, int w, int h, int ascii_w, int ascii_h) {
+    if (!integral_ready) {
+        build_integral_images(src, w, h, h);
+        integral_ready = true;
+    }
+    const bool braille = subcell_mode == ASCII_SUBCELL_BRAILLE;
+    const int rows = braille ? 4 : 2;
+    const int cols = braille ? ascii_w * 2 : ascii_w;
+    const BrailleKernel kernel = select_braille_kernel();
+    const int S = sub_stride;
+
+    for (int cy = 0; cy < ascii_h; ++cy) {
+        fill_sub_rows(cy, rows, cols);
+        AsciiWideCell* dst = wide_buffer + cy * ascii_w;
+        if (braille) {
+            kernel(sub_plane, S, sub_bits, sub_fg, sub_bg, 0, ascii_w);
+            for (int cx = 0; cx < ascii_w; ++cx) {
+                const uint32_t b = sub_bits[cx];
+                store_wide_cell(dst[cx], b ? (uint16_t)(0x2800 + b) : (uint16_t)' ', sub_fg[cx], sub_bg[cx]);
+            }
+            continue;
+        }
+        // 반 블록: 하위 행 0 = 위 (전경), 1 = 아래 (배경)
+        const uint16_t* top = sub_plane;
+        const uint16_t* bot = sub_plane + 4 * S;
+        for (int cx = 0; cx < ascii_w; ++cx) {
+            const uint32_t f = ((uint32_t)top[S + cx] << 16) | ((uint32_t)top[2 * S + cx] << 8) | top[3 * S + cx];
+            const uint32_t g = ((uint32_t)bot[S + cx] << 16) | ((uint32_t)bot[2 * S + cx] << 8) | bot[3 * S + cx];
+            store_wide_cell(dst[cx], f == g ? (uint16_t)' ' : (uint16_t)0x2580, f, g);
+        }
+    }
+}
+
+// ---------- 패스1: 셀 한 행의 RGB 평균 ----------
+// 적분영상에서 박스 합 → 곱셈+시프트로 나눗셈 대체: (sum * inv) >> 16 ≈ sum / cnt
+static void box_average_row(int y, int ascii_w,
+                            uint16_t* dst_r, uint16_t* dst_g, uint16_t* dst_b) {
+    const int W = I_W;
+    const int y0 = Y0[y], y1 = Y1[y];
+    const uint32_t* inv_row = INV_COUNT + y * ascii_w;
+
+    for (int x = 0; x < ascii_w; ++x) {
+        const int x0 = X0[x], x1 = X1[x];
+        const uint32_t inv = inv_row[x];
+
+        const uint32_t rsum = I_R[IIX(x1,y1,W)] - I_R[IIX(x0,y1,W)] - I_R[IIX(x1,y0,W)] + I_R[IIX(x0,y0,W)];
+        const uint32_t gsum = I_G[IIX(x1,y1,W)] - I_G[IIX(x0,y1,W)] - I_G[IIX(x1,y0,W)] + I_G[IIX(x0,y0,W)];
+        const uint32_t bsum = I_B[IIX(x1,y1,W)] - I_B[IIX(x0,y1,W)] - I_B[IIX(x1,y0,W)] + I_B[IIX(x0,y0,W)];
+
+        dst_r[x] = (uint16_t)((rsum * inv) >> 16);
+        dst_g[x] = (uint16_t)((gsum * inv) >> 16);
+        dst_b[x] = (uint16_t)((bsum * inv) >> 16);
+    }
+}
+
+// ---------- 패스1: 다운샘플 커널 ----------
+// 행 평균기: 셀 행 y → dst_r/g/b. 소스는 Source*로 타입 소거, worker는 스크래치 선택용
+//   row_integral          : 정수 경계 박스 평균 (적분영상 필요)
+//   weighted_average_row  : 분수 면적 가중 (플랜 테이블 구동, 범용)
+//   separable_average_row : 가로 16비트 부분합 → 세로 누적 (작업 집합이 셀 몇 행 분량)
+//   spec_average_row      : (소스, 그리드) 해상도 특수화, 풋프린트/가중치 constexpr + 완전 전개
+typedef void (*RowAverager)(const void* src, int w, int y, int ascii_w,
+                            uint16_t* dst_r, uint16_t* dst_g, uint16_t* dst_b, int worker);
+
+static void row_integral(const void*, int, int y, int ascii_w,
+                         uint16_t* dst_r, uint16_t* dst_g, uint16_t* dst_b, int) {
+    box_average_row(y, ascii_w, dst_r, dst_g, dst_b);
+}
+
+// 가중 합 → 평균 (반올림): (sum * round(2^32 / total) + 2^31) >> 32
+static inline uint16_t frac_average(uint32_t sum, uint64_t inv) {
+    return (uint16_t)(((uint64_t)sum * inv + (1ull << 31)) >> 32);
+}
+
+// 셀 (cx, cy)의 분수 면적 가중 합 (범용 커널과 증분 경로 공용)
+template <class Source>
+static inline void weighted_cell_sum(const Source& src, int w, int cx, int cy,
+                                     uint32_t& rsum, uint32_t& gsum, uint32_t& bsum) {
+    const AsciiPlan& p = *cur_plan;
+    const int x0 = p.fx0[cx], x1 = p.fx1[cx];
+    const uint16_t* wx = p.wx + p.wx_off[cx];
+    const uint16_t* wy = p.wy + p.wy_off[cy];
+    rsum = gsum = bsum = 0;
+    for (int sy = p.fy0[cy], k = 0; sy < p.fy1[cy]; ++sy, ++k) {
+        const int base = sy * w;
+        for (int sx = x0; sx < x1; ++sx) {
+            const uint32_t s = src(base + sx);
+            const uint32_t wt = (uint32_t)wx[sx - x0] * wy[k];
+            rsum += wt * ((s>>16)&0xFF);
+            gsum += wt * ((s>> 8)&0xFF);
+            bsum += wt * ((s    )&0xFF);
+        }
+    }
+}
+
+template <class Source>
+static void weighted_average_row(const void* src, int w, int y, int ascii_w,
+                                 uint16_t* dst_r, uint16_t* dst_g, uint16_t* dst_b, int) {
+    const uint64_t inv = cur_plan->frac_inv;
+    for (int x = 0; x < ascii_w; ++x) {
+        uint32_t rsum, gsum, bsum;
+        weighted_cell_sum(*(const Source*)src, w, x, y, rsum, gsum, bsum);
+        dst_r[x] = frac_average(rsum, inv);
+        dst_g[x] = frac_average(gsum, inv);
+        dst_b[x] = frac_average(bsum, inv);
+    }
+}
+
+// 분리형: 소스 행 하나를 셀 열별 부분합으로 줄이고 (가로), 셀 풋프린트 행들을 가중 누적 (세로)
+// 적분영상 3평면((w+1)×(h+1)×4바이트) 대신 셀 한 행 분량만 쓰므로 L1에 머무름
+// 가로 부분합은 uint64 하나에 16비트 레인 3개 (R:32, G:16, B:0) → 픽셀당 곱셈-덧셈 1번
+// (레인 자리올림 없음: 플랜의 sep_ok가 부분합 <= 0xFFFF를 보장)
+static inline uint64_t spread_rgb16(uint32_t s) {
+    return ((uint64_t)(s & 0xFF0000) << 16) | ((s & 0xFF00) << 8) | (s & 0xFF);
+}
+
+template <class Source, bool FRAC>
+static inline void separable_reduce_row(const Source& src, int w, int sy, int ascii_w,
+                                        uint64_t* h) {
+    const AsciiPlan& p = *cur_plan;
+    const int* x0s = FRAC ? p.fx0 : p.x0;
+    const int* x1s = FRAC ? p.fx1 : p.x1;
+    const int base = sy * w;
+    for (int cx = 0; cx < ascii_w; ++cx) {
+        const int x0 = x0s[cx], x1 = x1s[cx];
+        const uint16_t* wx = p.wx + p.wx_off[cx];
+        uint64_t sum = 0;
+        for (int sx = x0; sx < x1; ++sx) {
+            const uint64_t v = spread_rgb16(src(base + sx));
+            sum += FRAC ? wx[sx - x0] * v : v;
+        }
+        h[cx] = sum;
+    }
+}
+
+template <class Source, bool FRAC>
+static void separable_average_row(const void* src_, int w, int y, int ascii_w,
+                                  uint16_t* dst_r, uint16_t* dst_g, uint16_t* dst_b, int worker) {
+    const Source& src = *(const Source*)src_;
+    const AsciiPlan& p = *cur_plan;
+    uint64_t* h = sep_h[worker];
+    uint32_t* const* acc = sep_acc[worker];
+    const int y0 = FRAC ? p.fy0[y] : p.y0[y];
+    const int y1 = FRAC ? p.fy1[y] : p.y1[y];
+    const uint16_t* wy = p.wy + p.wy_off[y];
+
+    for (int sy = y0; sy < y1; ++sy) {
+        // 분수 가중이면 경계 행을 위아래 셀 행이 공유 → 직전에 줄인 행은 다시 쓰기
+        if (sep_row[worker] != sy || sep_row_frame[worker] != sep_frame) {
+            separable_reduce_row<Source, FRAC>(src, w, sy, ascii_w, h);
+            sep_row[worker] = sy;
+            sep_row_frame[worker] = sep_frame;
+        }
+        const uint32_t wt = FRAC ? wy[sy - y0] : 1;
+        uint32_t* ar = acc[0];
+        uint32_t* ag = acc[1];
+        uint32_t* ab = acc[2];
+        if (sy == y0) {
+            for (int cx = 0; cx < ascii_w; ++cx) {
+                const uint64_t v = h[cx];
+                ar[cx] = wt * (uint32_t)((v >> 32) & 0xFFFF);
+                ag[cx] = wt * (uint32_t)((v >> 16) & 0xFFFF);
+                ab[cx] = wt * (uint32_t)( v        & 0xFFFF);
+            }
+        } else {
+            for (int cx = 0; cx < ascii_w; ++cx) {
+                const uint64_t v = h[cx];
+                ar[cx] += wt * (uint32_t)((v >> 32) & 0xFFFF);
+                ag[cx] += wt * (uint32_t)((v >> 16) & 0xFFFF);
+                ab[cx] += wt * (uint32_t)( v        & 0xFFFF);
+            }
+        }
+    }
+
+    if (FRAC) {
+        const uint64_t inv = p.frac_inv;
+        for (int cx = 0; cx < ascii_w; ++cx) {
+            dst_r[cx] = frac_average(acc[0][cx], inv);
+            dst_g[cx] = frac_average(acc[1][cx], inv);
+            dst_b[cx] = frac_average(acc[2][cx], inv);
+        }
+    } else {
+        const uint32_t* inv_row = p.inv_count + y * ascii_w;
+        for (int cx = 0; cx < ascii_w; ++cx) {
+            dst_r[cx] = (uint16_t)((acc[0][cx] * inv_row[cx]) >> 16);
+            dst_g[cx] = (uint16_t)((acc[1][cx] * inv_row[cx]) >> 16);
+            dst_b[cx] = (uint16_t)((acc[2][cx] * inv_row[cx]) >> 16);
+        }
+    }
+}
+
+// 고정 비율 지오메트리: 축마다 P셀이 Q픽셀을 덮는 위상 묶음이 gcd번 반복
+// (320×200→240×80: 가로 3셀/4픽셀, 세로 2셀/5픽셀)
+// FRAC=false면 기존 정수 경계 [j*Q/P, (j+1)*Q/P) + 균등 가중 → 적분영상 경로와 비트 단위로 같음
+template <int SW_, int SH_, int GW_, int GH_, bool FRAC>
+struct CellGeometry {
+    static_assert(SW_ >= GW_ && SH_ >= GH_, "downsampling only");
+    static constexpr int SW = SW_;
+    static constexpr int GX = ascii_gcd(SW_, GW_), GY = ascii_gcd(SH_, GH_);
+    static constexpr int PX = GW_ / GX, QX = SW_ / GX;
+    static constexpr int PY = GH_ / GY, QY = SH_ / GY;
+
+    // 위상 j 셀이 걸치는 픽셀 [lo, hi) (묶음 안 상대 좌표)
+    static constexpr int lo(int j, int p, int q) { return j * q / p; }
+    static constexpr int hi(int j, int p, int q) {
+        return FRAC ? ((j + 1) * q + p - 1) / p : (j + 1) * q / p;
+    }
+    // 픽셀 k와 셀 j의 겹친 길이 (1/p 픽셀 단위)
+    static constexpr int weight(int j, int k, int p, int q) {
+        return !FRAC ? 1
+             : std::min((j + 1) * q, (k + 1) * p) - std::max(j * q, k * p);
+    }
+    static constexpr int x_lo(int j) { return lo(j, PX, QX); }
+    static constexpr int y_lo(int j) { return lo(j, PY, QY); }
+    static constexpr int fw(int j) { return hi(j, PX, QX) - lo(j, PX, QX); }
+    static constexpr int fh(int j) { return hi(j, PY, QY) - lo(j, PY, QY); }
+    static constexpr uint32_t wt(int jx, int jy, int n) {
+        return (uint32_t)weight(jx, x_lo(jx) + n % fw(jx), PX, QX)
+             * (uint32_t)weight(jy, y_lo(jy) + n / fw(jx), PY, QY);
+    }
+
+    static_assert(!FRAC || (int64_t)QX * QY <= ASCII_FRAC_MAX_WEIGHT, "weight sum overflow");
+    static constexpr uint64_t FRAC_INV =
+        ((1ull << 32) + (uint64_t)(QX * QY) / 2) / (uint64_t)(QX * QY);
+
+    static inline uint16_t finish(uint32_t sum, int jx, int jy) {
+        return FRAC ? frac_average(sum, FRAC_INV)
+                    : (uint16_t)((sum * ((1u << 16) / (uint32_t)(fw(jx) * fh(jy)))) >> 16);
+    }
+};
+
+// 셀 하나의 풋프린트 픽셀 N..END 전개 (가중치는 컴파일 타임 상수, FRAC=false면 곱셈 없음)
+template <class Source, class G, int JX, int JY, int N, int END = G::fw(JX) * G::fh(JY)>
+struct SpecPixels {
+    static inline void add(const Source& src, int base,
+                           uint32_t& r, uint32_t& g, uint32_t& b) {
+        constexpr uint32_t wt = G::wt(JX, JY, N);
+        const uint32_t s = src(base + (N / G::fw(JX)) * G::SW + N % G::fw(JX));
+        r += wt * ((s>>16)&0xFF);
+        g += wt * ((s>> 8)&0xFF);
+        b += wt * ((s    )&0xFF);
+        SpecPixels<Source, G, JX, JY, N + 1, END>::add(src, base, r, g, b);
+    }
+};
+template <class Source, class G, int JX, int JY, int END>
+struct SpecPixels<Source, G, JX, JY, END, END> {
+    static inline void add(const Source&, int, uint32_t&, uint32_t&, uint32_t&) {}
+};
+
+// 가로 위상 묶음 하나의 셀 JX..PX-1 전개
+template <class Source, class G, int JY, int JX, int END = G::PX>
+struct SpecCells {
+    static inline void run(const Source& src, int base,
+                           uint16_t* dst_r, uint16_t* dst_g, uint16_t* dst_b) {
+        uint32_t r = 0, g = 0, b = 0;
+        SpecPixels<Source, G, JX, JY, 0>::add(src, base + G::x_lo(JX), r, g, b);
+        dst_r[JX] = G::finish(r, JX, JY);
+        dst_g[JX] = G::finish(g, JX, JY);
+        dst_b[JX] = G::finish(b, JX, JY);
+        SpecCells<Source, G, JY, JX + 1, END>::run(src, base, dst_r, dst_g, dst_b);
+    }
+};
+template <class Source, class G, int JY, int END>
+struct SpecCells<Source, G, JY, END, END> {
+    static inline void run(const Source&, int, uint16_t*, uint16_t*, uint16_t*) {}
+};
+
+// 세로 위상 JY..PY-1 중 y % PY에 맞는 전개본으로 분기
+template <class Source, class G, int JY, int END = G::PY>
+struct SpecPhases {
+    static inline void run(const Source& src, int y,
+                           uint16_t* dst_r, uint16_t* dst_g, uint16_t* dst_b) {
+        if (y % G::PY != JY) {
+            SpecPhases<Source, G, JY + 1, END>::run(src, y, dst_r, dst_g, dst_b);
+            return;
+        }
+        const int row = (y / G::PY) * G::QY + G::y_lo(JY);
+        for (int gx = 0; gx < G::GX; ++gx) {
+            SpecCells<Source, G, JY, 0>::run(src, row * G::SW + gx * G::QX,
+                                             dst_r + gx * G::PX, dst_g + gx * G::PX,
+                                             dst_b + gx * G::PX);
+        }
+    }
+};
+template <class Source, class G, int END>
+struct SpecPhases<Source, G, END, END> {
+    static inline void run(const Source&, int, uint16_t*, uint16_t*, uint16_t*) {}
+};
+
+template <class Source, class G>
+static void spec_average_row(const void* src, int, int y, int,
+                             uint16_t* dst_r, uint16_t* dst_g, uint16_t* dst_b, int) {
+    SpecPhases<Source, G, 0>::run(*(const Source*)src, y, dst_r, dst_g, dst_b);
+}
+
+// 런타임 디스패치 테이블: 자주 쓰는 (소스, 그리드) 조합만 특수화, 나머지는 범용 커널
+struct RowAveragerEntry {
+    int src_w, src_h, ascii_w, ascii_h;
+    RowAverager frac, legacy;
+};
+
+#define ASCII_SPEC_ENTRY(Source, SW, SH, GW, GH)                   \
+    { SW, SH, GW, GH,                                               \
+      spec_average_row<Source, CellGeometry<SW, SH, GW, GH, true> >, \
+      spec_average_row<Source, CellGeometry<SW, SH, GW, GH, false> > }
+
+template <class Source>
+static const RowAveragerEntry* find_specialized(int src_w, int src_h, int ascii_w, int ascii_h) {
+    static const RowAveragerEntry table[] = {
+        ASCII_SPEC_ENTRY(Source, 320, 200, 240, 80),   // 기본 그리드
+        ASCII_SPEC_ENTRY(Source, 320, 200, 160, 50),
+        ASCII_SPEC_ENTRY(Source, 320, 200, 120, 40),
+        ASCII_SPEC_ENTRY(Source, 320, 200,  80, 25),   // 터미널 80×25
+        ASCII_SPEC_ENTRY(Source, 320, 200, 320, 100),
+    };
+    for (const RowAveragerEntry& e : table) {
+        if (e.src_w == src_w && e.src_h == src_h &&
+            e.ascii_w == ascii_w && e.ascii_h == ascii_h) return &e;
+    }
+    return nullptr;
+}
+
+// 현재 플랜/가중 방식에서 쓸 수 있는 커널 (결과는 같은 가중 방식끼리 비트 단위로 같음)
+static bool downsample_eligible(int kernel, bool frac, bool has_spec) {
+    switch (kernel) {
+    case ASCII_DOWNSAMPLE_INTEGRAL:    return !frac;
+    case ASCII_DOWNSAMPLE_WEIGHTED:    return frac;
+    case ASCII_DOWNSAMPLE_SPECIALIZED: return has_spec && use_specialized;
+    case ASCII_DOWNSAMPLE_SEPARABLE:   return cur_plan->sep_ok[frac];
+    default:                           return false;
+    }
+}
+
+// 자동 튜닝: 후보마다 워밍업 + ASCII_TUNE_FRAMES 전체 변환을 돌아가며 재고 가장 빠른 커널로 고정
+// (측정 중인 커널은 tuning_kernel, 측정값은 record_downsample_time으로 플랜에 누적)
+static int tuning_kernel = -1;
+
+static int pick_downsample_kernel(bool frac, bool has_spec) {
+    tuning_kernel = -1;
+    if (downsample_request >= 0 && downsample_eligible(downsample_request, frac, has_spec)) {
+        return downsample_request;
+    }
+    AsciiPlan& p = *cur_plan;
+    if (p.tuned[frac] >= 0 && downsample_eligible(p.tuned[frac], frac, has_spec)) {
+        return p.tuned[frac];
+    }
+
+    int next = -1, best = -1;
+    for (int k = 0; k < ASCII_DOWNSAMPLE_COUNT; ++k) {
+        if (!downsample_eligible(k, frac, has_spec)) continue;
+        const BenchmarkStats& st = p.tune[frac][k];
+        if (st.frame_count < ASCII_TUNE_WARMUP_FRAMES + ASCII_TUNE_FRAMES) {
+            if (next < 0 || st.frame_count < p.tune[frac][next].frame_count) next = k;
+        } else if (best < 0 || st.min_time_ms < p.tune[frac][best].min_time_ms) {
+            // 최솟값 기준: 브라우저 GC/스케줄링 잡음에 덜 흔들림
+            best = k;
+        }
+    }
+    if (next >= 0) {
+        tuning_kernel = next;
+        return next;
+    }
+    p.tuned[frac] = best;
+    return best;
+}
+
+static void record_downsample_time(double elapsed_ms) {
+    if (tuning_kernel < 0) return;
+    BenchmarkStats& st = cur_plan->tune[area_weighted()][tuning_kernel];
+    st.frame_count++;
+    if (st.warmup_count < ASCII_TUNE_WARMUP_FRAMES) {
+        st.warmup_count++;
+        return;
+    }
+    st.total_time_ms += elapsed_ms;
+    st.min_time_ms = std::min(st.min_time_ms, elapsed_ms);
+    st.max_time_ms = std::max(st.max_time_ms, elapsed_ms);
+    st.avg_time_ms = st.total_time_ms / (st.frame_count - ASCII_TUNE_WARMUP_FRAMES);
+}
+
+template <class Source>
+static RowAverager select_row_averager(int src_w, int src_h, int ascii_w, int ascii_h) {
+    const bool frac = area_weighted();
+    const RowAveragerEntry* spec = find_specialized<Source>(src_w, src_h, ascii_w, ascii_h);
+    downsample_kernel = (AsciiDownsampleKernel)pick_downsample_kernel(frac, spec != nullptr);
+
+    switch (downsample_kernel) {
+    case ASCII_DOWNSAMPLE_SPECIALIZED:
+        return frac ? spec->frac : spec->legacy;
+    case ASCII_DOWNSAMPLE_SEPARABLE:
+        return frac ? separable_average_row<Source, true>
+                    : separable_average_row<Source, false>;
+    case ASCII_DOWNSAMPLE_WEIGHTED:
+        return weighted_average_row<Source>;
+    default:
+        return row_integral;
+    }
+}
+
+#undef ASCII_SPEC_ENTRY
+
+// ---------- 증분 변환 ----------
+static void ensure_dirty_rows(int src_h) {
+    if (dirty_rows >= src_h) return;
+    free(dirty_lo); free(dirty_hi); free(live_lo); free(live_hi);
+    dirty_lo = (int*)malloc(sizeof(int)*src_h);
+    dirty_hi = (int*)malloc(sizeof(int)*src_h);
+    live_lo = (int*)malloc(sizeof(int)*src_h);
+    live_hi = (int*)malloc(sizeof(int)*src_h);
+    dirty_rows = src_h;
+}
+
+// 행마다 비교할 구간: 깨끗한 영역 사각형이 남은 구간의 왼쪽/오른쪽 끝에 닿으면 그만큼 잘라냄
+// (가운데에 떠 있는 사각형은 무시 → 그냥 비교). 잘라낸 행이 하나라도 있으면 true
+static bool prepare_live_spans(int w, int h) {
+    for (int y = 0; y < h; ++y) { live_lo[y] = 0; live_hi[y] = w; }
+    if (!use_regions) return false;
+    bool any = false;
+    for (const AsciiRegion& region : regions) {
+        if (region.dirty) continue;
+        for (int i = 0; i < region.count; ++i) {
+            const int* r = region.rects[i];
+            const int x0 = std::max(r[0], 0), x1 = std::min(r[2], w);
+            const int y1 = std::min(r[3], h);
+            if (x0 >= x1) continue;
+            for (int y = std::max(r[1], 0); y < y1; ++y) {
+                if (x0 <= live_lo[y]) live_lo[y] = std::max(live_lo[y], x1);
+                else if (x1 >= live_hi[y]) live_hi[y] = std::min(live_hi[y], x0);
+                else continue;
+                any = true;
+            }
+        }
+    }
+    return any;
+}
+
+// 소스를 사본과 행 단위로 비교 → dirty_lo/hi 채우고 사본 갱신
+// 반환: 바뀐 픽셀 구간 면적, 사본이 이번 프레임과 맞지 않으면(첫 프레임,
+// 해상도/소스/팔레트/출력 버퍼 변경) -1 (사본만 새로 채움)
+template <class Source>
+static long scan_dirty_rows(const Source& src, int w, int h,
+                            const AsciiCell* out, int ascii_w, int ascii_h) {
+    typedef typename std::remove_const<
+        typename std::remove_pointer<decltype(src.pixels)>::type>::type Pixel;
+    const int bpp = (int)sizeof(Pixel);
+    const size_t row_bytes = (size_t)w * bpp;
+    const size_t bytes = row_bytes * h;
+
+    if (!shadow_valid || shadow_w != w || shadow_h != h || shadow_bpp != bpp ||
+        shadow_aw != ascii_w || shadow_ah != ascii_h || shadow_out != out ||
+        shadow_generation != src.generation()) {
+        if (shadow_capacity < bytes) {
+            free(shadow_src);
+            shadow_src = (uint8_t*)malloc(bytes);
+            shadow_capacity = bytes;
+        }
+        std::memcpy(shadow_src, src.pixels, bytes);
+        shadow_w = w; shadow_h = h; shadow_bpp = bpp;
+        shadow_aw = ascii_w; shadow_ah = ascii_h; shadow_out = out;
+        shadow_generation = src.generation();
+        shadow_valid = true;
+        return -1;
+    }
+
+    // 깨끗한 정적 영역은 비교하지 않음 (사본도 그대로 → 영역이 더티가 되면 그때 비교)
+    long area = 0;
+    for (int y = 0; y < h; ++y) {
+        const Pixel* cur  = src.pixels + (size_t)y * w;
+        Pixel*       prev = (Pixel*)shadow_src + (size_t)y * w;
+        const int a = live_lo[y], b = live_hi[y];
+        dirty_lo[y] = w; dirty_hi[y] = 0;
+        if (a >= b || std::memcmp(cur + a, prev + a, (size_t)(b - a) * bpp) == 0) continue;
+
+        int lo = a, hi = b;
+        while (cur[lo] == prev[lo]) ++lo;
+        while (cur[hi - 1] == prev[hi - 1]) --hi;
+        std::memcpy(prev + lo, cur + lo, (size_t)(hi - lo) * bpp);
+        dirty_lo[y] = lo; dirty_hi[y] = hi;
+        area += hi - lo;
+    }
+    return area;
+}
+
+// 풋프린트(모양 글리프면 사분면 이웃 행까지)의 소스 행이 모두 깨끗한 정적 영역인 셀 행은 직전 출력 재사용
+// 전체 변환 커널은 이어진 행 구간을 다루므로 위/아래 끝에서 이어지는 행만 잘라 [cy0, cy1)
+static void live_cell_rows(int ascii_h, bool shape, int& cy0, int& cy1) {
+    const bool frac = area_weighted();
+    const int* FY0 = frac ? cur_plan->fy0 : Y0;
+    const int* FY1 = frac ? cur_plan->fy1 : Y1;
+    auto reusable = [&](int cy) {
+        const int sy0 = shape ? std::min(FY0[cy], shape_qy[cy * 3]) : FY0[cy];
+        const int sy1 = shape ? std::max(FY1[cy], shape_qy[cy * 3 + 2]) : FY1[cy];
+        for (int sy = sy0; sy < sy1; ++sy) {
+            if (live_lo[sy] < live_hi[sy]) return false;
+        }
+        return true;
+    };
+    cy0 = 0; cy1 = ascii_h;
+    while (cy0 < cy1 && reusable(cy0)) ++cy0;
+    while (cy1 > cy0 && reusable(cy1 - 1)) --cy1;
+}
+
+// 바뀐 구간에 걸친 셀만 재계산: 직접 박스 합 → 패스2 → 직전 출력과 비교해 델타 기록
+// (합은 정수라 전체 변환 커널과 결과가 비트 단위로 같음)
+template <class Source>
+static void update_dirty_cells(const Source& src, int w,
+                               AsciiCell* out, int ascii_w, int ascii_h,
+                               Pass2Kernel pass2, bool shape) {
+    delta_count = 0;
+
+    // 셀 풋프린트: 분수 가중이면 걸치는 픽셀 전체 (경계 픽셀은 이웃 셀과 공유)
+    const bool frac = area_weighted();
+    const int* FX0 = frac ? cur_plan->fx0 : X0;
+    const int* FX1 = frac ? cur_plan->fx1 : X1;
+    const int* FY0 = frac ? cur_plan->fy0 : Y0;
+    const int* FY1 = frac ? cur_plan->fy1 : Y1;
+
+    for (int cy = 0; cy < ascii_h; ++cy) {
+        const int y0 = FY0[cy], y1 = FY1[cy];
+        int lo = w, hi = 0;
+        // 모양 글리프 사분면은 풋프린트 밖 이웃 픽셀 하나까지 읽을 수 있음
+        const int sy0 = shape ? std::min(y0, shape_qy[cy * 3]) : y0;
+        const int sy1 = shape ? std::max(y1, shape_qy[cy * 3 + 2]) : y1;
+        for (int sy = sy0; sy < sy1; ++sy) {
+            lo = std::min(lo, dirty_lo[sy]);
+            hi = std::max(hi, dirty_hi[sy]);
+        }
+        if (lo >= hi) continue;
+        if (shape) { lo = std::max(0, lo - 1); hi = std::min(w, hi + 1); }
+
+        // 풋프린트 경계는 단조 증가 → [lo, hi)와 겹치는 셀 구간을 이분 탐색
+        const int cx0 = (int)(std::upper_bound(FX1, FX1 + ascii_w, lo) - FX1);
+        const int cx1 = (int)(std::lower_bound(FX0, FX0 + ascii_w, hi) - FX0);
+        const int n = cx1 - cx0;
+        if (n <= 0) continue;
+
+        const uint32_t* inv_row = INV_COUNT + cy * ascii_w;
+        for (int k = 0; k < n; ++k) {
+            const int cx = cx0 + k;
+            if (frac) {
+                uint32_t rsum, gsum, bsum;
+                weighted_cell_sum(src, w, cx, cy, rsum, gsum, bsum);
+                row_r[k] = frac_average(rsum, cur_plan->frac_inv);
+                row_g[k] = frac_average(gsum, cur_plan->frac_inv);
+                row_b[k] = frac_average(bsum, cur_plan->frac_inv);
+                continue;
+            }
+            const int x0 = X0[cx], x1 = X1[cx];
+            uint32_t rsum = 0, gsum = 0, bsum = 0;
+            for (int sy = y0; sy < y1; ++sy) {
+                const int base = sy * w;
+                for (int sx = x0; sx < x1; ++sx) {
+                    const uint32_t s = src(base + sx);
+                    rsum += (s>>16)&0xFF;
+                    gsum += (s>> 8)&0xFF;
+                    bsum += (s    )&0xFF;
+                }
+            }
+            const uint32_t inv = inv_row[cx];
+            row_r[k] = (uint16_t)((rsum * inv) >> 16);
+            row_g[k] = (uint16_t)((gsum * inv) >> 16);
+            row_b[k] = (uint16_t)((bsum * inv) >> 16);
+        }
+        pass2(row_r, row_g, row_b, row_cells, 0, n, cy * ascii_w + cx0);
+        if (shape) shape_matched += shape_cells(src, w, cy, cx0, n, row_cells);
+
+        AsciiCell* dst = out + cy * ascii_w + cx0;
+        for (int k = 0; k < n; ++k) {
+            if (std::memcmp(&dst[k], &row_cells[k], sizeof(AsciiCell)) == 0) continue;
+            dst[k] = row_cells[k];
+            AsciiCellDelta& d = delta_list[delta_count++];
+            d.index = (uint32_t)(cy * ascii_w + cx0 + k);
+            d.cell  = row_cells[k];
+        }
+    }
+}
+
+// ---------- 메인 변환 ----------
+// 전체 변환: (적분영상) → (융합 | 2-패스) → AsciiCell
+// 적분영상은 정수 경계 박스 평균(row_integral)만 사용, 나머지 커널은 소스를 직접 읽음
+// diffuse가 있으면(오차 확산 디더링) 패스2 대신 행 순서대로 diffuse
+// 셀 행 [cy0, cy1)만 계산 (나머지는 깨끗한 정적 영역 → 직전 출력 그대로, 오차 확산이면 항상 전체)
+template <class Source>
+static void convert_full(const Source& src,
+                         int src_width, int src_height,
+                         AsciiCell* out,
+                         int ascii_width, int ascii_height,
+                         Pass2Kernel pass2, RowAverager average, DiffuseKernel diffuse,
+                         int cy0, int cy1)
+{
+    uint64_t t = stage_clock();
+    if (average == row_integral) {
+        // 적분영상은 위에서부터 누적 → 마지막 셀 행의 아래 경계까지만
+        const int rows = cy1 == ascii_height ? src_height : Y1[cy1 - 1];
+        build_integral_images(src, src_width, src_height, rows);
+        integral_ready = rows == src_height;
+        t = stage_mark(STAGE_INTEGRAL, t);
+    }
+
+    if (use_fused) {
+        // 융합 경로: 셀 한 행씩 평균 → 즉시 문자/감마 → AsciiCell
+        // (행 버퍼는 L1에 머무르므로 temp_r/g/b 전체 평면을 쓰고 다시 읽지 않음)
+        for (int y = cy0; y < cy1; ++y) {
+            average(&src, src_width, y, ascii_width, row_r, row_g, row_b, 0);
+            if (diffuse) {
+                diffuse(row_r, row_g, row_b, out + y * ascii_width, ascii_width);
+                diffuse_next_row(ascii_width);
+            } else {
+                pass2(row_r, row_g, row_b, out + y * ascii_width, 0, ascii_width, y * ascii_width);
+            }
+        }
+        stage_mark(STAGE_CELLS_FUSED, t);
+    } else {
+        // 2-패스 경로 (벤치마크 비교용)
+        // 패스2 SIMD는 정렬 로드 → 시작 셀을 32셀 단위로 내리고 패스1은 그 셀의 행부터
+        const int cell0 = (cy0 * ascii_width) & ~31;
+        const int cell1 = cy1 * ascii_width;
+
+        // 패스1: 셀 RGB 평균 추출 → 임시 버퍼
+        for (int y = cell0 / ascii_width; y < cy1; ++y) {
+            const int row_offset = y * ascii_width;
+            average(&src, src_width, y, ascii_width, temp_r + row_offset,
+                    temp_g + row_offset, temp_b + row_offset, 0);
+        }
+        t = stage_mark(STAGE_PASS1, t);
+
+        // 패스2: 밝기 계산 + 감마 + 문자 결정 (SIMD)
+        if (diffuse) {
+            for (int y = cy0; y < cy1; ++y) {
+                const int row_offset = y * ascii_width;
+                diffuse(temp_r + row_offset, temp_g + row_offset, temp_b + row_offset,
+                        out + row_offset, ascii_width);
+                diffuse_next_row(ascii_width);
+            }
+        } else {
+            pass2(temp_r, temp_g, temp_b, out, cell0, cell1, 0);
+        }
+        stage_mark(STAGE_PASS2, t);
+    }
+}
+
+// ---------- 병렬 전체 변환 ----------
+// 1) 밴드별 적분영상 (밴드 안에서만 누적)          - 병렬
+// 2) 밴드 캐리 = 윗 밴드들 마지막 행의 합           - 직렬 (밴드 수 × I_W)
+// 3) 셀 경계 행(Y0/Y1)에만 캐리 더해 전역 값으로     - 병렬
+// 4) 셀 행 밴드별 패스1/2 (2-패스는 32셀 정렬 구간) - 병렬
+// 박스 합은 경계 행만 읽으므로 나머지 행은 밴드 로컬 값으로 남겨 둠
+// (소스를 직접 읽는 다운샘플 커널이면 1-3 생략)
+struct ParallelFrame {
+    const void* src;     // Source*
+    int w, h;
+    AsciiCell* out;
+    int aw, ah;
+    Pass2Kernel pass2;
+    RowAverager average;
+    int boundary_count;
+    int cy0, cy1;        // 계산할 셀 행 [cy0, cy1)
+};
+
+
+static inline int band_begin(int total, int band, int bands) {
+    return (int)((int64_t)total * band / bands);
+}
+
+template <class Source>
+static void job_integral_bands(int worker, int workers, void* ctx) {
+    const ParallelFrame& f = *(const ParallelFrame*)ctx;
+    build_integral_rows(*(const Source*)f.src, f.w,
+                        band_begin(f.h, worker, workers),
+                        band_begin(f.h, worker + 1, workers), true);
+}
+
+// 밴드 캐리 계산 + 캐리 보정이 필요한 경계 행 목록 (직렬)
+static int prepare_band_carry(int h, int ascii_h, int bands) {
+    const int W = I_W;
+    const int carry_size = bands * 3 * W;
+    if (band_carry_size < carry_size) {
+        free(band_carry);
+        band_carry = (uint32_t*)malloc(sizeof(uint32_t) * carry_size);
+        band_carry_size = carry_size;
+    }
+    uint32_t* const planes[3] = { I_R, I_G, I_B };
+    std::memset(band_carry, 0, sizeof(uint32_t) * 3 * W);  // 밴드 0
+    for (int b = 1; b < bands; ++b) {
+        const int last = band_begin(h, b, bands);  // 밴드 b-1의 마지막 적분영상 행
+        for (int c = 0; c < 3; ++c) {
+            const uint32_t* prev = band_carry + ((b - 1) * 3 + c) * W;
+            const uint32_t* row  = planes[c] + IIX(0, last, W);
+            uint32_t* dst = band_carry + (b * 3 + c) * W;
+            for (int x = 0; x < W; ++x) dst[x] = prev[x] + row[x];
+        }
+    }
+
+    // 셀 경계 행 (정렬 + 중복 제거), 0행과 밴드 0 행은 이미 전역 값
+    if (boundary_rows_size < 2 * ascii_h) {
+        free(boundary_rows); free(boundary_band);
+        boundary_rows = (int*)malloc(sizeof(int) * 2 * ascii_h);
+        boundary_band = (int*)malloc(sizeof(int) * 2 * ascii_h);
+        boundary_rows_size = 2 * ascii_h;
+    }
+    int n = 0;
+    for (int y = 0; y < ascii_h; ++y) {
+        boundary_rows[n++] = Y0[y];
+        boundary_rows[n++] = Y1[y];
+    }
+    std::sort(boundary_rows, boundary_rows + n);
+    n = (int)(std::unique(boundary_rows, boundary_rows + n) - boundary_rows);
+
+    int count = 0, band = 0;
+    for (int i = 0; i < n; ++i) {
+        const int r = boundary_rows[i];   // 적분영상 행 r = 소스 행 r-1까지의 누적
+        while (band + 1 < bands && r - 1 >= band_begin(h, band + 1, bands)) ++band;
+        if (r == 0 || band == 0) continue;
+        boundary_rows[count] = r;
+        boundary_band[count] = band;
+        ++count;
+    }
+    return count;
+}
+
+static void job_carry_fixup(int worker, int workers, void* ctx) {
+    const ParallelFrame& f = *(const ParallelFrame*)ctx;
+    const int W = I_W;
+    uint32_t* const planes[3] = { I_R, I_G, I_B };
+    const int i0 = band_begin(f.boundary_count, worker, workers);
+    const int i1 = band_begin(f.boundary_count, worker + 1, workers);
+    for (int i = i0; i < i1; ++i) {
+        const int r = boundary_rows[i];
+        for (int c = 0; c < 3; ++c) {
+            const uint32_t* carry = band_carry + (boundary_band[i] * 3 + c) * W;
+            uint32_t* row = planes[c] + IIX(0, r, W);
+            for (int x = 0; x < W; ++x) row[x] += carry[x];
+        }
+    }
+}
+
+static void job_cells_fused(int worker, int workers, void* ctx) {
+    const ParallelFrame& f = *(const ParallelFrame*)ctx;
+    uint16_t* const* buf = worker_row[worker];
+    const int y1 = f.cy0 + band_begin(f.cy1 - f.cy0, worker + 1, workers);
+    for (int y = f.cy0 + band_begin(f.cy1 - f.cy0, worker, workers); y < y1; ++y) {
+        f.average(f.src, f.w, y, f.aw, buf[0], buf[1], buf[2], worker);
+        f.pass2(buf[0], buf[1], buf[2], f.out + y * f.aw, 0, f.aw, y * f.aw);
+    }
+}
+
+// 패스1은 패스2 첫 구간(32셀 정렬로 내린 시작 셀)의 행부터
+static void job_pass1_rows(int worker, int workers, void* ctx) {
+    const ParallelFrame& f = *(const ParallelFrame*)ctx;
+    const int row0 = ((f.cy0 * f.aw) & ~31) / f.aw;
+    const int y1 = row0 + band_begin(f.cy1 - row0, worker + 1, workers);
+    for (int y = row0 + band_begin(f.cy1 - row0, worker, workers); y < y1; ++y) {
+        const int row_offset = y * f.aw;
+        f.average(f.src, f.w, y, f.aw, temp_r + row_offset,
+                  temp_g + row_offset, temp_b + row_offset, worker);
+    }
+}
+
+// 패스2 구간 경계를 32셀 단위로 맞춤 (SIMD 정렬 로드)
+static void job_pass2_cells(int worker, int workers, void* ctx) {
+    const ParallelFrame& f = *(const ParallelFrame*)ctx;
+    const int first = (f.cy0 * f.aw) & ~31;
+    const int total = f.cy1 * f.aw - first;
+    const int begin = first + std::min(total, (band_begin(total, worker, workers) + 31) & ~31);
+    const int end = (worker + 1 == workers)
+        ? first + total : first + std::min(total, (band_begin(total, worker + 1, workers) + 31) & ~31);
+    if (begin < end) f.pass2(temp_r, temp_g, temp_b, f.out, begin, end, 0);
+}
+
+template <class Source>
+static void convert_full_parallel(const Source& src,
+                                  int src_width, int src_height,
+                                  AsciiCell* out,
+                                  int ascii_width, int ascii_height,
+                                  Pass2Kernel pass2, RowAverager average, int workers,
+                                  int cy0, int cy1)
+{
+    ParallelFrame f = { &src, src_width, src_height, out,
+                        ascii_width, ascii_height, pass2, average, 0, cy0, cy1 };
+    uint64_t t = stage_clock();
+    if (average == row_integral) {
+        ensure_integral_capacity(src_width, src_height);
+        std::memset(I_R, 0, sizeof(uint32_t)*I_W);
+        std::memset(I_G, 0, sizeof(uint32_t)*I_W);
+        std::memset(I_B, 0, sizeof(uint32_t)*I_W);
+
+        const int bands = std::min(workers, src_height);
+        pool_run(job_integral_bands<Source>, &f, bands);
+        f.boundary_count = prepare_band_carry(src_height, ascii_height, bands);
+        pool_run(job_carry_fixup, &f, workers);
+        t = stage_mark(STAGE_INTEGRAL, t);
+    }
+
+    if (use_fused) {
+        pool_run(job_cells_fused, &f, std::min(workers, cy1 - cy0));
+        stage_mark(STAGE_CELLS_FUSED, t);
+    } else {
+        pool_run(job_pass1_rows, &f, std::min(workers, cy1 - cy0));
+        t = stage_mark(STAGE_PASS1, t);
+        pool_run(job_pass2_cells, &f, workers);
+        stage_mark(STAGE_PASS2, t);
+    }
+}
+
+// 공통 파이프라인: (증분 더티 셀 | 전체 변환) + 벤치마크/프레임 카운터
+template <class Source>
+static void convert_frame(const Source& src,
+                          int src_width, int src_height,
+                          AsciiCell* out,
+                          int ascii_width, int ascii_height)
+{
+    // 초기화 작업 (벤치마크에서 제외, 단계 히스토그램은 setup으로 기록)
+    stage_begin_frame();
+    const uint64_t frame_start = stage_clock();
+    init_luts_once();
+    select_plan(src_width, src_height, ascii_width, ascii_height);
+    ensure_cell_scratch(ascii_width, ascii_height);
+    const Pass2Kernel pass2 = select_pass2_kernel();
+    const RowAverager average = select_row_averager<Source>(src_width, src_height,
+                                                            ascii_width, ascii_height);
+    if (average == row_integral) ensure_integral_capacity(src_width, src_height);
+    const bool shape = use_shape && ensure_shape_plan(src_width, src_height, ascii_width, ascii_height);
+    shape_matched = 0;
+    const bool subcell = subcell_mode != ASCII_SUBCELL_OFF &&
+        ensure_subcell_plan(subcell_mode, src_width, src_height, ascii_width, ascii_height);
+    if (subcell) ensure_integral_capacity(src_width, src_height);
+    integral_ready = false;
+    const DiffuseKernel diffuse = prepare_dither(ascii_width, ascii_height);
+    uint64_t t = stage_mark(STAGE_SETUP, frame_start);
+    
+    // 벤치마크 모드일 때 시간 측정 시작 (실제 변환 작업만 측정)
+    double start_time = 0.0;
+    if (benchmark_mode) {
+        start_time = ascii_now_ms();
+    }
+
+    // 증분 경로: 바뀐 면적이 절반 이하면 더티 셀만 갱신
+    // (벤치마크 모드는 전체 파이프라인 비교를 위해 항상 전체 변환, 오차 확산은 바뀐 셀 밖으로 번지므로 항상 전체)
+    // 직전 출력이 유효하면 깨끗한 정적 영역(상태 표시줄/테두리)의 행은 비교도, 전체 변환도 하지 않음
+    bool updated = false;
+    int cy0 = 0, cy1 = ascii_height;
+    region_rows_reused = 0;
+    if (use_incremental && !benchmark_mode && !diffuse) {
+        ensure_dirty_rows(src_height);
+        const bool regions_clean = prepare_live_spans(src_width, src_height);
+        const long area = scan_dirty_rows(src, src_width, src_height,
+                                          out, ascii_width, ascii_height);
+        t = stage_mark(STAGE_DIRTY_SCAN, t);
+        if (area >= 0 && regions_clean) {
+            live_cell_rows(ascii_height, shape, cy0, cy1);
+            region_rows_reused = ascii_height - (cy1 - cy0);
+        }
+        if (area >= 0 && area * 2 <= (long)src_width * src_height) {
+            update_dirty_cells(src, src_width, out, ascii_width, ascii_height, pass2, shape);
+            stage_mark(STAGE_DIRTY_CELLS, t);
+            delta_full = false;
+            updated = true;
+        }
+    } else {
+        shadow_valid = false;
+    }
+    // 이번 변환이 영역 행을 비교했거나(더티) 전체를 다시 계산했으므로 표시를 비움
+    for (AsciiRegion& region : regions) region.dirty = false;
+
+    if (!updated) {
+        // 큰 그리드/소스만 워커 풀로 (작으면 깨우고 기다리는 비용이 더 큼). 오차 확산은 행 순서라 직렬
+        const bool parallel = !diffuse && worker_count > 1 &&
+            (ascii_width * ascii_height >= ASCII_PARALLEL_MIN_CELLS ||
+             src_width * src_height >= ASCII_PARALLEL_MIN_PIXELS);
+        std::fill(worker_busy_ms, worker_busy_ms + ASCII_MAX_WORKERS, 0.0);
+        ++sep_frame;
+        const double t0 = ascii_now_ms();
+        if (parallel) {
+            convert_full_parallel(src, src_width, src_height, out,
+                                  ascii_width, ascii_height, pass2, average, worker_count,
+                                  cy0, cy1);
+        } else {
+            convert_full(src, src_width, src_height, out, ascii_width, ascii_height,
+                         pass2, average, diffuse, cy0, cy1);
+            worker_busy_ms[0] = ascii_now_ms() - t0;
+        }
+        record_downsample_time(ascii_now_ms() - t0);
+        if (shape) {
+            const uint64_t ts = stage_clock();
+            // 2-패스는 정렬 때문에 cy0 앞 행 일부도 다시 썼으므로 그 행부터
+            const int shape_row0 = use_fused ? cy0 : ((cy0 * ascii_width) & ~31) / ascii_width;
+            for (int cy = shape_row0; cy < cy1; ++cy) {
+                shape_matched += shape_cells(src, src_width, cy, 0, ascii_width,
+                                             out + cy * ascii_width);
+            }
+            stage_mark(STAGE_SHAPE, ts);
+        }
+        std::copy(worker_busy_ms, worker_busy_ms + ASCII_MAX_WORKERS, worker_last_ms);
+        last_frame_parallel = parallel;
+        delta_count = 0;
+        delta_full = true;
+    }
+
+    // 벤치마크 모드일 때 시간 측정 및 통계 업데이트
+    if (benchmark_mode) {
+        double now = ascii_now_ms();
+        double elapsed_ms = now - start_time;
+        // SIMD 켬/끔 x 파이프라인별, 그리고 디더링 방식별
+        BenchmarkStats* const targets[] = {
+            use_simd ? &stats_simd_on[current_pipe()] : &stats_simd_off[current_pipe()],
+            &stats_dither[dither_mode],
+        };
+        for (BenchmarkStats* stats : targets) {
+            stats->frame_count++;
+
+            // 워밍업 프레임은 통계에서 제외
+            if (stats->warmup_count < benchmark_warmup_frames) {
+                stats->warmup_count++;
+            } else {
+                // 실제 측정 시작 (워밍업 이후)
+                stats->total_time_ms += elapsed_ms;
+                uint32_t measured_frames = stats->frame_count - benchmark_warmup_frames;
+                if (measured_frames > 0) {
+                    if (elapsed_ms < stats->min_time_ms) stats->min_time_ms = elapsed_ms;
+                    if (elapsed_ms > stats->max_time_ms) stats->max_time_ms = elapsed_ms;
+                    stats->avg_time_ms = stats->total_time_ms / measured_frames;
+                }
+            }
+        }
+        
+        // 1초 윈도우 FPS 계산
+        if (use_simd) {
+            fps_frame_count_simd_on++;
+            if (fps_window_start_simd_on == 0.0) {
+                fps_window_start_simd_on = now;
+            } else {
+                double window_elapsed = now - fps_window_start_simd_on;
+                if (window_elapsed >= 1000.0) {
+                    current_fps_simd_on = (fps_frame_count_simd_on * 1000.0) / window_elapsed;
+                    fps_frame_count_simd_on = 0;
+                    fps_window_start_simd_on = now;
+                }
+            }
+        } else {
+            fps_frame_count_simd_off++;
+            if (fps_window_start_simd_off == 0.0) {
+                fps_window_start_simd_off = now;
+            } else {
+                double window_elapsed = now - fps_window_start_simd_off;
+                if (window_elapsed >= 1000.0) {
+                    current_fps_simd_off = (fps_frame_count_simd_off * 1000.0) / window_elapsed;
+                    fps_frame_count_simd_off = 0;
+                    fps_window_start_simd_off = now;
+                }
+            }
+        }
+    }
+
+    wide_valid = false;
+    if (subcell) {
+        const uint64_t tw = stage_clock();
+        convert_subcells(src, src_width, src_height, ascii_width, ascii_height);
+        wide_src = out;
+        wide_valid = true;
+        stage_mark(STAGE_SUBCELL, tw);
+    }
+
+    if (use_temporal) {
+        const uint64_t tt = stage_clock();
+        apply_temporal(out, ascii_width, ascii_height);
+        stage_mark(STAGE_TEMPORAL, tt);
+    }
+
+    if (packed_format != ASCII_PACKED_OFF) {
+        const uint64_t tp = stage_clock();
+        pack_output(out, ascii_width, ascii_height);
+        stage_mark(STAGE_PACK, tp);
+    }
+
+    stage_mark(STAGE_TOTAL, frame_start);
+    stage_commit_frame();
+
+    last_out = out;
+    last_out_w = ascii_width;
+    last_out_h = ascii_height;
+    g_ascii_frame_id++;
+    g_ascii_last_ms = ascii_now_ms();
+}
+
+int I_PublishASCIIFrame(int tic)
+{
+    if (!last_out || published_frame_id == g_ascii_frame_id) return 0;
+    const int cells = last_out_w * last_out_h;
+    AsciiFrameSlot& slot = publish_slots[back_slot];
+    if (!ensure_slot_capacity(slot, cells)) return 0;
+
+    std::memcpy(slot.cells, last_out, sizeof(AsciiCell) * (size_t)cells);
+    AsciiFrame& f = slot.frame;
+    f.cells = slot.cells;
+    f.packed = nullptr;
+    f.packed_format = ASCII_PACKED_OFF;
+    f.palette = nullptr;
+    f.palette_count = 0;
+    if (packed_format != ASCII_PACKED_OFF && packed_valid && packed_src == last_out) {
+        std::memcpy(slot.packed, packed_buffer, sizeof(uint16_t) * (size_t)cells);
+        f.packed = slot.packed;
+        f.packed_format = packed_format;
+        if (packed_format == ASCII_PACKED_INDEXED) {
+            std::memcpy(slot.palette, packed_palette, (size_t)packed_palette_count * 3);
+            f.palette = slot.palette;
+            f.palette_count = packed_palette_count;
+        }
+    }
+    f.wide = nullptr;
+    f.subcell_mode = ASCII_SUBCELL_OFF;
+    if (subcell_mode != ASCII_SUBCELL_OFF && wide_valid && wide_src == last_out) {
+        if (slot.wide_capacity < cells) {
+            AsciiWideCell* w = (AsciiWideCell*)ascii_aligned_alloc(32, sizeof(AsciiWideCell) * (size_t)cells);
+            if (w) {
+                ascii_aligned_free(slot.wide);
+                slot.wide = w;
+                slot.wide_capacity = cells;
+            }
+        }
+        if (slot.wide_capacity >= cells) {
+            std::memcpy(slot.wide, wide_buffer, sizeof(AsciiWideCell) * (size_t)cells);
+            f.wide = slot.wide;
+            f.subcell_mode = subcell_mode;
+        }
+    }
+    f.width = last_out_w;
+    f.height = last_out_h;
+    f.sequence = ++publish_sequence;
+    f.frame_id = g_ascii_frame_id;
+    f.tic = tic;
+
+    // release: 슬롯 내용이 번호보다 먼저 보이도록
+    back_slot = (int)(published_slot.exchange((uint32_t)back_slot | PUBLISH_FRESH,
+                                              std::memory_order_acq_rel) & 3);
+    published_frame_id = g_ascii_frame_id;
+    return 1;
+}
+
+int I_AcquireASCIIFrame(AsciiFrame *frame)
+{
+    int fresh = 0;
+    if (published_slot.load(std::memory_order_relaxed) & PUBLISH_FRESH) {
+        front_slot = (int)(published_slot.exchange((uint32_t)front_slot,
+                                                   std::memory_order_acq_rel) & 3);
+        fresh = 1;
+    }
+    if (frame) *frame = publish_slots[front_slot].frame;
+    return fresh;
+}
+
 void I_ConvertRGBAtoASCII(const uint32_t *rgba_buffer,
                           int src_width, int src_height,
                           void *output_buffer,
@@ -252,227 +4167,537 @@ void I_ConvertRGBAtoASCII(const uint32_t *rgba_buffer,
     if (!rgba_buffer || src_width<=0 || src_height<=0 ||
         ascii_width<=0 || ascii_height<=0) return;
 
-    // RGBA 버퍼 포인터 저장 (JS 모드에서 사용)
-    rgba_buffer_ptr = rgba_buffer;
-    rgba_buffer_width = src_width;
-    rgba_buffer_height = src_height;
+    // RGBA 버퍼 포인터 저장 (JS 모드에서 사용)
+    rgba_buffer_ptr = rgba_buffer;
+    rgba_buffer_width = src_width;
+    rgba_buffer_height = src_height;
+
+    // JS 모드일 때는 C++ 변환 스킵 (JS에서 처리)
+    if (js_mode) {
+        return;
+    }
+
+    if (check_frame_unchanged(rgba_buffer, 4, src_width, src_height,
+                              out, ascii_width, ascii_height)) {
+        return;
+    }
+
+    const SourceRGBA32 src = { rgba_buffer };
+    convert_frame(src, src_width, src_height, out, ascii_width, ascii_height);
+}
+
+void I_ConvertPal8toASCII(const uint8_t *pixels,
+                          int src_width, int src_height,
+                          void *output_buffer,
+                          int ascii_width, int ascii_height)
+{
+    AsciiCell* out = (AsciiCell*)output_buffer;
+    if (!pixels || !pal_valid || src_width<=0 || src_height<=0 ||
+        ascii_width<=0 || ascii_height<=0) return;
+
+    // JS 모드는 RGBA 버퍼가 필요 → I_ASCIINeedsRGBA()로 호출측이 판단
+    if (js_mode) {
+        return;
+    }
+
+    if (check_frame_unchanged(pixels, 1, src_width, src_height,
+                              out, ascii_width, ascii_height)) {
+        return;
+    }
+
+    const SourcePal8 src = { pixels, pal_packed };
+    convert_frame(src, src_width, src_height, out, ascii_width, ascii_height);
+}
+
+void I_SetASCIIPalette(const uint8_t *rgb)
+{
+    if (pal_valid && std::memcmp(pal_rgb, rgb, sizeof(pal_rgb)) == 0) {
+        return;
+    }
+    std::memcpy(pal_rgb, rgb, sizeof(pal_rgb));
+    for (int i = 0; i < 256; ++i) {
+        const uint32_t r = rgb[i * 3 + 0];
+        const uint32_t g = rgb[i * 3 + 1];
+        const uint32_t b = rgb[i * 3 + 2];
+        const uint32_t luma = std::min(255u, (r*299 + g*587 + b*114) >> 10);
+        pal_packed[i] = (luma << 24) | (r << 16) | (g << 8) | b;
+    }
+    pal_valid = true;
+    ++pal_generation;
+}
+
+int I_ASCIINeedsRGBA(void)
+{
+    return (js_mode || source_mode == ASCII_SOURCE_RGBA32 || !pal_valid) ? 1 : 0;
+}
+
+int I_InitASCIIQuant(int target)
+{
+    if (target < 0 || target >= ASCII_QUANT_COUNT) return 0;
+    return quant_build(target) ? 1 : 0;
+}
+
+int I_QuantizeASCIIColor(int target, int r, int g, int b)
+{
+    if (!I_InitASCIIQuant(target)) return -1;
+    return quant_lookup(target, r & 0xFF, g & 0xFF, b & 0xFF);
+}
+
+const uint8_t* I_GetASCIIQuantPalette(int target)
+{
+    if (target < 0 || target >= ASCII_QUANT_COUNT) return nullptr;
+    quant_init_palettes();
+    return quant_palette[target];
+}
+
+void I_QuantizeASCIICells(int target, const AsciiCell *cells, int count, uint8_t *out)
+{
+    if (!cells || !out || count <= 0 || !I_InitASCIIQuant(target)) return;
+    detect_simd_kernel();
+    select_quant_kernel()(target, cells, out, count);
+}
+
+void I_SetASCIIRegion(int region, const int *rects, int count)
+{
+    if (region < 0 || region >= ASCII_REGION_COUNT) return;
+    AsciiRegion next = {};
+    next.count = rects ? std::max(0, std::min(count, ASCII_REGION_MAX_RECTS)) : 0;
+    for (int i = 0; i < next.count; ++i) {
+        const int* r = rects + i * 4;
+        next.rects[i][0] = r[0];
+        next.rects[i][1] = r[1];
+        next.rects[i][2] = r[0] + std::max(r[2], 0);
+        next.rects[i][3] = r[1] + std::max(r[3], 0);
+    }
+    // 엔진은 매 프레임 같은 사각형으로 부름 → 바뀔 때만 더티 (새 사각형의 행은 한 번 비교해야 함)
+    AsciiRegion& cur = regions[region];
+    if (cur.count == next.count &&
+        std::memcmp(cur.rects, next.rects, sizeof(next.rects[0]) * next.count) == 0) return;
+    next.dirty = true;
+    cur = next;
+}
+
+void I_MarkASCIIRegionDirty(int region)
+{
+    if (region < 0) {
+        for (AsciiRegion& r : regions) r.dirty = true;
+    } else if (region < ASCII_REGION_COUNT) {
+        regions[region].dirty = true;
+    }
+}
+
+void I_MarkASCIIRect(int x, int y, int w, int h)
+{
+    for (AsciiRegion& region : regions) {
+        for (int i = 0; i < region.count && !region.dirty; ++i) {
+            const int* r = region.rects[i];
+            region.dirty = x < r[2] && r[0] < x + w && y < r[3] && r[1] < y + h;
+        }
+    }
+}
+
+// ---------- Emscripten exports ----------
+extern "C" {
+
+EMSCRIPTEN_KEEPALIVE
+const void* ascii_get_buffer(void) {
+    return I_GetASCIIBuffer();
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_buffer_size(void) {
+    return grid_w * grid_h * (int)sizeof(AsciiCell);
+}
+
+// 그리드 크기 변경 (성공 1). 셀 버퍼 주소가 바뀌므로 ascii_get_buffer를 다시 읽을 것
+EMSCRIPTEN_KEEPALIVE
+int ascii_set_grid(int width, int height) {
+    return I_SetASCIIGrid(width, height);
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_grid_width(void) {
+    return grid_w;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_grid_height(void) {
+    return grid_h;
+}
+
+EMSCRIPTEN_KEEPALIVE
+void ascii_set_simd(int enabled) {
+    use_simd = (enabled != 0);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void ascii_set_source_mode(int mode) {
+    source_mode = (mode == ASCII_SOURCE_RGBA32) ? ASCII_SOURCE_RGBA32 : ASCII_SOURCE_PAL8;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_source_mode(void) {
+    return source_mode;
+}
+
+EMSCRIPTEN_KEEPALIVE
+void ascii_set_sdl_output(int visible) {
+    sdl_output_visible = (visible != 0);
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_sdl_output(void) {
+    return sdl_output_visible ? 1 : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+uint32_t ascii_get_palette_generation(void) {
+    return pal_generation;
+}
+
+EMSCRIPTEN_KEEPALIVE
+void ascii_set_incremental(int enabled) {
+    use_incremental = (enabled != 0);
+    shadow_valid = false;  // 다음 프레임은 전체 변환 (출력 버퍼를 밖에서 고친 경우에도 사용)
+    frame_hash_valid = false;
+    temporal_valid = false;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_incremental(void) {
+    return use_incremental ? 1 : 0;
+}
+
+// 직전 변환의 셀 델타 목록 {index, AsciiCell} (delta_full이면 비어 있음)
+EMSCRIPTEN_KEEPALIVE
+const void* ascii_get_delta_buffer(void) {
+    return delta_list;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_delta_count(void) {
+    return delta_count;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_delta_full(void) {
+    return delta_full ? 1 : 0;
+}
 
-    // JS 모드일 때는 C++ 변환 스킵 (JS에서 처리)
-    if (js_mode) {
-        return;
-    }
+// 정적 영역 재사용 (기본 켜짐). 끄면 영역 행도 매 프레임 비교/변환
+EMSCRIPTEN_KEEPALIVE
+void ascii_set_static_regions(int enabled) {
+    use_regions = (enabled != 0);
+    I_MarkASCIIRegionDirty(-1);  // 켜는 순간 사본이 영역 행과 맞는지 한 번 비교
+    region_rows_reused = 0;
+}
 
-    // 초기화 작업 (벤치마크에서 제외)
-    init_luts_once();
-    ensure_bounds(src_width, src_height, ascii_width, ascii_height);
-    
-    // 벤치마크 모드일 때 시간 측정 시작 (실제 변환 작업만 측정)
-    double start_time = 0.0;
-    if (benchmark_mode) {
-        start_time = emscripten_get_now();
-    }
-    
-    build_integral_images(rgba_buffer, src_width, src_height);
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_static_regions(void) {
+    return use_regions ? 1 : 0;
+}
 
-    const int total_cells = ascii_width * ascii_height;
-    ensure_temp_buffer(total_cells);
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_region_rows_reused(void) {
+    return region_rows_reused;
+}
 
-    // 패스1: 적분영상에서 RGB 평균 추출 → 임시 버퍼 (나눗셈 → 곱셈+시프트)
-    const int W = I_W;
-    for (int y = 0; y < ascii_height; ++y) {
-        const int y0 = Y0[y], y1 = Y1[y];
-        const int row_offset = y * ascii_width;
+EMSCRIPTEN_KEEPALIVE
+void ascii_set_frame_skip(int enabled) {
+    use_frame_skip = (enabled != 0);
+    frame_hash_valid = false;
+}
 
-        for (int x = 0; x < ascii_width; ++x) {
-            const int x0 = X0[x], x1 = X1[x];
-            const uint32_t inv = INV_COUNT[row_offset + x];
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_frame_skip(void) {
+    return use_frame_skip ? 1 : 0;
+}
 
-            const uint32_t rsum = I_R[IIX(x1,y1,W)] - I_R[IIX(x0,y1,W)] - I_R[IIX(x1,y0,W)] + I_R[IIX(x0,y0,W)];
-            const uint32_t gsum = I_G[IIX(x1,y1,W)] - I_G[IIX(x0,y1,W)] - I_G[IIX(x1,y0,W)] + I_G[IIX(x0,y0,W)];
-            const uint32_t bsum = I_B[IIX(x1,y1,W)] - I_B[IIX(x0,y1,W)] - I_B[IIX(x1,y0,W)] + I_B[IIX(x0,y0,W)];
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_frame_unchanged(void) {
+    return frame_unchanged ? 1 : 0;
+}
 
-            // 곱셈+시프트로 나눗셈 대체: (sum * inv) >> 16 ≈ sum / cnt
-            const int idx = row_offset + x;
-            temp_r[idx] = (uint16_t)((rsum * inv) >> 16);
-            temp_g[idx] = (uint16_t)((gsum * inv) >> 16);
-            temp_b[idx] = (uint16_t)((bsum * inv) >> 16);
-        }
-    }
+EMSCRIPTEN_KEEPALIVE
+uint32_t ascii_get_frames_converted(void) {
+    return frames_converted;
+}
 
-    // 패스2: 밝기 계산 + 감마 + 문자 결정 (SIMD)
-#if defined(__wasm_simd128__)
-    if (use_simd) {
-        const v128_t coef_r = wasm_i32x4_splat(299);
-        const v128_t coef_g = wasm_i32x4_splat(587);
-        const v128_t coef_b = wasm_i32x4_splat(114);
-        const v128_t v255 = wasm_i32x4_splat(255);
-        const v128_t v0 = wasm_i32x4_splat(0);
-
-        int i = 0;
-        for (; i <= total_cells - 4; i += 4) {
-            // 4셀 RGB 로드 (uint16 → uint32 확장)
-            v128_t r16 = wasm_v128_load64_zero(&temp_r[i]);
-            v128_t g16 = wasm_v128_load64_zero(&temp_g[i]);
-            v128_t b16 = wasm_v128_load64_zero(&temp_b[i]);
-
-            // uint16 → uint32 직접 확장
-            v128_t r = wasm_u32x4_extend_low_u16x8(r16);
-            v128_t g = wasm_u32x4_extend_low_u16x8(g16);
-            v128_t b = wasm_u32x4_extend_low_u16x8(b16);
-
-            // 밝기 = (r*299 + g*587 + b*114) >> 10
-            v128_t lum = wasm_i32x4_add(
-                wasm_i32x4_add(wasm_i32x4_mul(r, coef_r), wasm_i32x4_mul(g, coef_g)),
-                wasm_i32x4_mul(b, coef_b)
-            );
-            lum = wasm_i32x4_shr(lum, 10);
-
-            // clamp 0-255
-            lum = wasm_i32x4_max(lum, v0);
-            lum = wasm_i32x4_min(lum, v255);
-            r = wasm_i32x4_min(wasm_i32x4_max(r, v0), v255);
-            g = wasm_i32x4_min(wasm_i32x4_max(g, v0), v255);
-            b = wasm_i32x4_min(wasm_i32x4_max(b, v0), v255);
-
-            // 레인 추출 후 LUT/감마 적용 (컴파일 타임 상수 필요)
-            #define EXTRACT_AND_STORE(lane) do { \
-                int lv = wasm_i32x4_extract_lane(lum, lane); \
-                int rv = wasm_i32x4_extract_lane(r, lane); \
-                int gv = wasm_i32x4_extract_lane(g, lane); \
-                int bv = wasm_i32x4_extract_lane(b, lane); \
-                AsciiCell& c = out[i + lane]; \
-                c.character = ASCII_CHARS[idxLUT[lv]]; \
-                c.r = gamma_table[rv]; \
-                c.g = gamma_table[gv]; \
-                c.b = gamma_table[bv]; \
-            } while(0)
-
-            EXTRACT_AND_STORE(0);
-            EXTRACT_AND_STORE(1);
-            EXTRACT_AND_STORE(2);
-            EXTRACT_AND_STORE(3);
-            #undef EXTRACT_AND_STORE
-        }
-
-        // 나머지 스칼라
-        for (; i < total_cells; ++i) {
-            const uint8_t rv = clamp_to_byte(temp_r[i]);
-            const uint8_t gv = clamp_to_byte(temp_g[i]);
-            const uint8_t bv = clamp_to_byte(temp_b[i]);
-            const uint8_t lum = clamp_to_byte((rv*299 + gv*587 + bv*114) >> 10);
-
-            out[i].character = ASCII_CHARS[idxLUT[lum]];
-            out[i].r = gamma_table[rv];
-            out[i].g = gamma_table[gv];
-            out[i].b = gamma_table[bv];
-        }
-    } else
-#endif
-    {
-        // 스칼라 fallback
-        for (int i = 0; i < total_cells; ++i) {
-            const uint8_t rv = clamp_to_byte(temp_r[i]);
-            const uint8_t gv = clamp_to_byte(temp_g[i]);
-            const uint8_t bv = clamp_to_byte(temp_b[i]);
-            const uint8_t lum = clamp_to_byte((rv*299 + gv*587 + bv*114) >> 10);
+EMSCRIPTEN_KEEPALIVE
+uint32_t ascii_get_frames_skipped(void) {
+    return frames_skipped;
+}
 
-            out[i].character = ASCII_CHARS[idxLUT[lum]];
-            out[i].r = gamma_table[rv];
-            out[i].g = gamma_table[gv];
-            out[i].b = gamma_table[bv];
-        }
-    }
+EMSCRIPTEN_KEEPALIVE
+void ascii_reset_frame_counters(void) {
+    frames_converted = 0;
+    frames_skipped = 0;
+}
 
-    // 벤치마크 모드일 때 시간 측정 및 통계 업데이트
-    if (benchmark_mode) {
-        double now = emscripten_get_now();
-        double elapsed_ms = now - start_time;
-        BenchmarkStats* stats = use_simd ? &stats_simd_on : &stats_simd_off;
-        
-        stats->frame_count++;
-        
-        // 워밍업 프레임은 통계에서 제외
-        if (stats->warmup_count < BENCHMARK_WARMUP_FRAMES) {
-            stats->warmup_count++;
-        } else {
-            // 실제 측정 시작 (워밍업 이후)
-            stats->total_time_ms += elapsed_ms;
-            uint32_t measured_frames = stats->frame_count - BENCHMARK_WARMUP_FRAMES;
-            if (measured_frames > 0) {
-                if (elapsed_ms < stats->min_time_ms) stats->min_time_ms = elapsed_ms;
-                if (elapsed_ms > stats->max_time_ms) stats->max_time_ms = elapsed_ms;
-                stats->avg_time_ms = stats->total_time_ms / measured_frames;
-            }
-        }
-        
-        // 1초 윈도우 FPS 계산
-        if (use_simd) {
-            fps_frame_count_simd_on++;
-            if (fps_window_start_simd_on == 0.0) {
-                fps_window_start_simd_on = now;
-            } else {
-                double window_elapsed = now - fps_window_start_simd_on;
-                if (window_elapsed >= 1000.0) {
-                    current_fps_simd_on = (fps_frame_count_simd_on * 1000.0) / window_elapsed;
-                    fps_frame_count_simd_on = 0;
-                    fps_window_start_simd_on = now;
-                }
-            }
-        } else {
-            fps_frame_count_simd_off++;
-            if (fps_window_start_simd_off == 0.0) {
-                fps_window_start_simd_off = now;
-            } else {
-                double window_elapsed = now - fps_window_start_simd_off;
-                if (window_elapsed >= 1000.0) {
-                    current_fps_simd_off = (fps_frame_count_simd_off * 1000.0) / window_elapsed;
-                    fps_frame_count_simd_off = 0;
-                    fps_window_start_simd_off = now;
-                }
-            }
-        }
-    }
+// 시간 히스테리시스 (기본 꺼짐). 켜거나 끌 때 상태를 버리고 다음 프레임부터 다시 쌓음
+EMSCRIPTEN_KEEPALIVE
+void ascii_set_temporal_filter(int enabled) {
+    use_temporal = (enabled != 0);
+    temporal_valid = false;
+    temporal_stabilized = 0;
+    frame_hash_valid = false;
+}
 
-    g_ascii_frame_id++;
-    g_ascii_last_ms = emscripten_get_now();
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_temporal_filter(void) {
+    return use_temporal ? 1 : 0;
 }
 
-} // extern "C"
+// lum_margin: 밝기(0..255) 여유, color_margin: 채널(0..255) 여유. 음수는 그대로 둠
+EMSCRIPTEN_KEEPALIVE
+void ascii_set_temporal_margin(int lum_margin, int color_margin) {
+    if (lum_margin >= 0) temporal_lum_margin = std::min(lum_margin, 255);
+    if (color_margin >= 0) temporal_color_margin = std::min(color_margin, 255);
+    temporal_tables_ready = false;
+}
 
-// ---------- Emscripten exports ----------
-extern "C" {
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_temporal_lum_margin(void) {
+    return temporal_lum_margin;
+}
 
 EMSCRIPTEN_KEEPALIVE
-const void* ascii_get_buffer(void) {
-    return I_GetASCIIBuffer();
+int ascii_get_temporal_color_margin(void) {
+    return temporal_color_margin;
 }
 
 EMSCRIPTEN_KEEPALIVE
-int ascii_get_buffer_size(void) {
-    return CELL_BUFFER_SIZE * (int)sizeof(AsciiCell);
+int ascii_get_temporal_stabilized(void) {
+    return temporal_stabilized;
 }
 
+// 모양 글리프: 사분면 밝기 서명으로 윤곽선 셀에 / \ _ ' 같은 문자 선택
 EMSCRIPTEN_KEEPALIVE
-void ascii_set_simd(int enabled) {
-    use_simd = (enabled != 0);
+void ascii_set_shape_glyphs(int enabled) {
+    use_shape = (enabled != 0);
+    shadow_valid = false;
+    frame_hash_valid = false;
+    temporal_valid = false;
+    shape_matched = 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_shape_glyphs(void) {
+    return use_shape ? 1 : 0;
+}
+
+// 사분면 최대-최소 밝기(0..255)가 이 값 이상인 셀만 모양 글리프 후보
+EMSCRIPTEN_KEEPALIVE
+void ascii_set_shape_threshold(int threshold) {
+    shape_threshold = std::max(0, std::min(threshold, 255));
+    shadow_valid = false;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_shape_threshold(void) {
+    return shape_threshold;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_shape_matched(void) {
+    return shape_matched;
+}
+
+// 하위 셀 출력 모드 (ASCII_SUBCELL_OFF | HALF | BRAILLE). 셀 그리드는 그대로 같이 만듦
+EMSCRIPTEN_KEEPALIVE
+void ascii_set_subcell_mode(int mode) {
+    if (mode < ASCII_SUBCELL_OFF || mode > ASCII_SUBCELL_BRAILLE) return;
+    subcell_mode = mode;
+    wide_valid = false;
+    frame_hash_valid = false;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_subcell_mode(void) {
+    return subcell_mode;
+}
+
+EMSCRIPTEN_KEEPALIVE
+const AsciiWideCell* ascii_get_wide_buffer(void) {
+    return subcell_mode != ASCII_SUBCELL_OFF && wide_valid ? wide_buffer : nullptr;
+}
+
+// 디더링 방식 (ASCII_DITHER_OFF | BAYER | FLOYD | ATKINSON)
+EMSCRIPTEN_KEEPALIVE
+void ascii_set_dither(int mode) {
+    if (mode < ASCII_DITHER_OFF || mode >= ASCII_DITHER_COUNT) return;
+    dither_mode = mode;
+    shadow_valid = false;
+    frame_hash_valid = false;
+    temporal_valid = false;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_dither(void) {
+    return dither_mode;
+}
+
+EMSCRIPTEN_KEEPALIVE
+const char* ascii_get_dither_name(void) {
+    static const char* const names[ASCII_DITHER_COUNT] = { "off", "bayer", "floyd", "atkinson" };
+    return names[dither_mode];
+}
+
+// 채널별 색 단계 수 (2..256). 0이면 자동: 패킹 출력이면 16 (RGB444와 같은 격자), 아니면 문자만 디더링
+EMSCRIPTEN_KEEPALIVE
+void ascii_set_dither_levels(int levels) {
+    dither_levels = levels <= 0 ? 0 : std::max(2, std::min(levels, 256));
+    frame_hash_valid = false;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_dither_levels(void) {
+    return dither_levels;
+}
+
+// 워커 수 (0: 자동, 1: 끔). 스레드 없는 빌드는 항상 1
+EMSCRIPTEN_KEEPALIVE
+void ascii_set_workers(int count) {
+    worker_request = std::max(0, count);
+    if (ascii_initialized) update_worker_count();
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_workers(void) {
+    return worker_count;
+}
+
+// 직전 전체 변환에서 워커 i가 일한 시간 (ms, 워커 0 = 호출 스레드)
+EMSCRIPTEN_KEEPALIVE
+double ascii_get_worker_time(int worker) {
+    if (worker < 0 || worker >= ASCII_MAX_WORKERS) return 0.0;
+    return worker_last_ms[worker];
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_last_frame_parallel(void) {
+    return last_frame_parallel ? 1 : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+void ascii_set_fused(int enabled) {
+    use_fused = (enabled != 0);
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_fused(void) {
+    return use_fused ? 1 : 0;
+}
+
+// 분수 면적 가중 on/off (off: 기존 정수 경계 박스 평균)
+EMSCRIPTEN_KEEPALIVE
+void ascii_set_area_weighting(int enabled) {
+    use_area_weighting = (enabled != 0);
+    shadow_valid = false;  // 같은 소스라도 셀 값이 달라짐
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_area_weighting(void) {
+    return use_area_weighting ? 1 : 0;
+}
+
+// 다운샘플 커널 고정 (-1: 지오메트리별 자동 튜닝, 0 integral, 1 weighted, 2 specialized, 3 separable)
+// 현재 지오메트리/가중 방식에서 쓸 수 없는 커널이면 자동으로 돌아감
+EMSCRIPTEN_KEEPALIVE
+void ascii_set_downsample_kernel(int kernel) {
+    downsample_request = (kernel >= 0 && kernel < ASCII_DOWNSAMPLE_COUNT) ? kernel : -1;
+}
+
+// 해상도 특수화 커널 on/off (off: 범용 커널, 결과는 같음)
+EMSCRIPTEN_KEEPALIVE
+void ascii_set_specialized(int enabled) {
+    use_specialized = (enabled != 0);
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_specialized(void) {
+    return use_specialized ? 1 : 0;
+}
+
+// 16비트 패킹 출력 형식 (ASCII_PACKED_*). 바꾸면 다음 변환에서 전체 다시 패킹
+EMSCRIPTEN_KEEPALIVE
+void ascii_set_packed_format(int format) {
+    packed_format = (format == ASCII_PACKED_RGB444 || format == ASCII_PACKED_INDEXED)
+                  ? format : ASCII_PACKED_OFF;
+    packed_valid = false;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_packed_format(void) {
+    return packed_format;
+}
+
+EMSCRIPTEN_KEEPALIVE
+const uint16_t* ascii_get_packed_buffer(void) {
+    return packed_format != ASCII_PACKED_OFF && packed_valid ? packed_buffer : nullptr;
+}
+
+EMSCRIPTEN_KEEPALIVE
+const uint8_t* ascii_get_packed_palette(void) {
+    return packed_palette;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_packed_palette_count(void) {
+    return packed_palette_count;
+}
+
+// 직전 변환의 다운샘플 커널: "integral" | "weighted" | "specialized" | "separable"
+EMSCRIPTEN_KEEPALIVE
+const char* ascii_get_downsample_kernel(void) {
+    static const char* const names[] = { "integral", "weighted", "specialized", "separable" };
+    return names[downsample_kernel];
 }
 
 EMSCRIPTEN_KEEPALIVE
 int ascii_get_simd(void) {
-#if defined(__wasm_simd128__)
+    detect_simd_kernel();
+    if (simd_kernel_best == ASCII_KERNEL_SCALAR) {
+        return -1; // 빌드/CPU가 SIMD 미지원
+    }
     return use_simd ? 1 : 0;
-#else
-    return -1; // 빌드가 SIMD 미지원
-#endif
 }
 
 EMSCRIPTEN_KEEPALIVE
 int ascii_simd_supported(void) {
-#if defined(__wasm_simd128__)
+    detect_simd_kernel();
+    return simd_kernel_best != ASCII_KERNEL_SCALAR ? 1 : 0;
+}
+
+// SIMD 켜짐일 때 쓸 커널을 낮춰 고정 (벤치마크용). NULL/"auto"면 감지 결과로 되돌림
+// CPU/빌드가 지원하지 않는 커널이면 0
+EMSCRIPTEN_KEEPALIVE
+int ascii_set_simd_kernel(const char* name) {
+    detect_simd_kernel();
+    AsciiSimdKernel k;
+    if (!name || std::strcmp(name, "auto") == 0)  k = simd_kernel_best;
+    else if (std::strcmp(name, "scalar") == 0)     k = ASCII_KERNEL_SCALAR;
+    else if (std::strcmp(name, "wasm-simd128") == 0 &&
+             simd_kernel_best == ASCII_KERNEL_WASM128) k = ASCII_KERNEL_WASM128;
+    else if (std::strcmp(name, "ssse3") == 0 &&
+             (simd_kernel_best == ASCII_KERNEL_SSSE3 ||
+              simd_kernel_best == ASCII_KERNEL_AVX2)) k = ASCII_KERNEL_SSSE3;
+    else if (std::strcmp(name, "avx2") == 0 &&
+             simd_kernel_best == ASCII_KERNEL_AVX2) k = ASCII_KERNEL_AVX2;
+    else return 0;
+    simd_kernel = k;
     return 1;
-#else
-    return 0;
-#endif
+}
+
+EMSCRIPTEN_KEEPALIVE
+const char* ascii_get_simd_kernel(void) {
+    detect_simd_kernel();
+    switch (simd_kernel) {
+    case ASCII_KERNEL_WASM128: return "wasm-simd128";
+    case ASCII_KERNEL_SSSE3:   return "ssse3";
+    case ASCII_KERNEL_AVX2:    return "avx2";
+    default:                   return "scalar";
+    }
 }
 
 EMSCRIPTEN_KEEPALIVE
@@ -481,13 +4706,56 @@ uint32_t ascii_get_frame_id(void) { return g_ascii_frame_id; }
 EMSCRIPTEN_KEEPALIVE
 double ascii_get_last_ms(void) { return g_ascii_last_ms; }
 
+// JS용 발행 프레임 조회: ascii_acquire_frame() 후 ascii_get_acquired_*로 읽음
+// (포인터는 다음 ascii_acquire_frame까지 유효)
+static AsciiFrame acquired_frame;
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_acquire_frame(void) { return I_AcquireASCIIFrame(&acquired_frame); }
+
+EMSCRIPTEN_KEEPALIVE
+const AsciiCell* ascii_get_acquired_cells(void) { return acquired_frame.cells; }
+
+EMSCRIPTEN_KEEPALIVE
+const uint16_t* ascii_get_acquired_packed(void) { return acquired_frame.packed; }
+
+EMSCRIPTEN_KEEPALIVE
+const uint8_t* ascii_get_acquired_palette(void) { return acquired_frame.palette; }
+
+EMSCRIPTEN_KEEPALIVE
+const AsciiWideCell* ascii_get_acquired_wide(void) { return acquired_frame.wide; }
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_acquired_palette_count(void) { return acquired_frame.palette_count; }
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_acquired_width(void) { return acquired_frame.width; }
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_acquired_height(void) { return acquired_frame.height; }
+
+EMSCRIPTEN_KEEPALIVE
+uint32_t ascii_get_acquired_sequence(void) { return acquired_frame.sequence; }
+
+EMSCRIPTEN_KEEPALIVE
+uint32_t ascii_get_acquired_frame_id(void) { return acquired_frame.frame_id; }
+
+EMSCRIPTEN_KEEPALIVE
+int ascii_get_acquired_tic(void) { return acquired_frame.tic; }
+
 EMSCRIPTEN_KEEPALIVE
 void ascii_set_benchmark_mode(int enabled) {
     benchmark_mode = (enabled != 0);
     if (benchmark_mode) {
         // 통계 리셋 (워밍업 포함)
-        stats_simd_on = {0, 0, 0.0, 1e9, 0.0, 0.0};
-        stats_simd_off = {0, 0, 0.0, 1e9, 0.0, 0.0};
+        for (int p = 0; p < PIPE_COUNT; ++p) {
+            stats_simd_on[p] = EMPTY_STATS;
+            stats_simd_off[p] = EMPTY_STATS;
+        }
+        std::fill(stats_dither, stats_dither + ASCII_DITHER_COUNT, EMPTY_STATS);
+        // 다운샘플 커널도 벤치마크 조건(증분 끔)에서 다시 측정
+        for (int i = 0; i < ASCII_PLAN_CACHE; ++i) reset_plan_tuning(&plan_cache[i]);
+        reset_stage_stats();
         // FPS 윈도우 리셋
         fps_window_start_simd_on = 0.0;
         fps_window_start_simd_off = 0.0;
@@ -505,8 +4773,13 @@ int ascii_get_benchmark_mode(void) {
 
 EMSCRIPTEN_KEEPALIVE
 void ascii_reset_benchmark_stats(void) {
-    stats_simd_on = {0, 0, 0.0, 1e9, 0.0, 0.0};
-    stats_simd_off = {0, 0, 0.0, 1e9, 0.0, 0.0};
+    for (int p = 0; p < PIPE_COUNT; ++p) {
+        stats_simd_on[p] = EMPTY_STATS;
+        stats_simd_off[p] = EMPTY_STATS;
+    }
+    std::fill(stats_dither, stats_dither + ASCII_DITHER_COUNT, EMPTY_STATS);
+    for (int i = 0; i < ASCII_PLAN_CACHE; ++i) reset_plan_tuning(&plan_cache[i]);
+    reset_stage_stats();
     // FPS 윈도우 리셋
     fps_window_start_simd_on = 0.0;
     fps_window_start_simd_off = 0.0;
@@ -517,26 +4790,128 @@ void ascii_reset_benchmark_stats(void) {
 }
 
 EMSCRIPTEN_KEEPALIVE
-double ascii_get_benchmark_frame_count_simd_on(void) { return (double)stats_simd_on.frame_count; }
+double ascii_get_benchmark_frame_count_simd_on(void) { return (double)stats_simd_on[current_pipe()].frame_count; }
+EMSCRIPTEN_KEEPALIVE
+double ascii_get_benchmark_total_time_simd_on(void) { return stats_simd_on[current_pipe()].total_time_ms; }
+EMSCRIPTEN_KEEPALIVE
+double ascii_get_benchmark_min_time_simd_on(void) { return stats_simd_on[current_pipe()].min_time_ms; }
+EMSCRIPTEN_KEEPALIVE
+double ascii_get_benchmark_max_time_simd_on(void) { return stats_simd_on[current_pipe()].max_time_ms; }
+EMSCRIPTEN_KEEPALIVE
+double ascii_get_benchmark_avg_time_simd_on(void) { return stats_simd_on[current_pipe()].avg_time_ms; }
+
+EMSCRIPTEN_KEEPALIVE
+double ascii_get_benchmark_frame_count_simd_off(void) { return (double)stats_simd_off[current_pipe()].frame_count; }
+EMSCRIPTEN_KEEPALIVE
+double ascii_get_benchmark_total_time_simd_off(void) { return stats_simd_off[current_pipe()].total_time_ms; }
+EMSCRIPTEN_KEEPALIVE
+double ascii_get_benchmark_min_time_simd_off(void) { return stats_simd_off[current_pipe()].min_time_ms; }
+EMSCRIPTEN_KEEPALIVE
+double ascii_get_benchmark_max_time_simd_off(void) { return stats_simd_off[current_pipe()].max_time_ms; }
+EMSCRIPTEN_KEEPALIVE
+double ascii_get_benchmark_avg_time_simd_off(void) { return stats_simd_off[current_pipe()].avg_time_ms; }
+
+// 현재 지오메트리/가중 방식에서 다운샘플 커널별 튜닝 측정값 (전체 변환 ms, 미측정이면 0)
+EMSCRIPTEN_KEEPALIVE
+double ascii_get_benchmark_avg_time_downsample(int kernel) {
+    if (!cur_plan || kernel < 0 || kernel >= ASCII_DOWNSAMPLE_COUNT) return 0.0;
+    return cur_plan->tune[area_weighted()][kernel].avg_time_ms;
+}
+
+// 디더링 방식별 (SIMD/파이프라인 구분 없이 그 방식으로 돈 벤치마크 프레임)
 EMSCRIPTEN_KEEPALIVE
-double ascii_get_benchmark_total_time_simd_on(void) { return stats_simd_on.total_time_ms; }
+double ascii_get_benchmark_avg_time_dither(int mode) {
+    if (mode < 0 || mode >= ASCII_DITHER_COUNT) return 0.0;
+    return stats_dither[mode].avg_time_ms;
+}
+
 EMSCRIPTEN_KEEPALIVE
-double ascii_get_benchmark_min_time_simd_on(void) { return stats_simd_on.min_time_ms; }
+double ascii_get_benchmark_frame_count_dither(int mode) {
+    if (mode < 0 || mode >= ASCII_DITHER_COUNT) return 0.0;
+    return (double)stats_dither[mode].frame_count;
+}
+
+// 워밍업 프레임 수 (벤치마크 통계와 단계 히스토그램 공통, 바꾸면 둘 다 리셋)
 EMSCRIPTEN_KEEPALIVE
-double ascii_get_benchmark_max_time_simd_on(void) { return stats_simd_on.max_time_ms; }
+void ascii_set_benchmark_warmup(int frames) {
+    benchmark_warmup_frames = (uint32_t)std::max(0, frames);
+    ascii_reset_benchmark_stats();
+}
+
 EMSCRIPTEN_KEEPALIVE
-double ascii_get_benchmark_avg_time_simd_on(void) { return stats_simd_on.avg_time_ms; }
+int ascii_get_benchmark_warmup(void) {
+    return (int)benchmark_warmup_frames;
+}
 
+// 단계 히스토그램 켜기/끄기 (끄면 프레임당 시계 호출도 없음)
 EMSCRIPTEN_KEEPALIVE
-double ascii_get_benchmark_frame_count_simd_off(void) { return (double)stats_simd_off.frame_count; }
+void ascii_set_stage_timing(int enabled) {
+    stage_timing = (enabled != 0);
+}
+
 EMSCRIPTEN_KEEPALIVE
-double ascii_get_benchmark_total_time_simd_off(void) { return stats_simd_off.total_time_ms; }
+int ascii_get_stage_timing(void) {
+    return stage_timing ? 1 : 0;
+}
+
 EMSCRIPTEN_KEEPALIVE
-double ascii_get_benchmark_min_time_simd_off(void) { return stats_simd_off.min_time_ms; }
+void ascii_reset_stage_stats(void) {
+    reset_stage_stats();
+}
+
+// 단계별 지연 분포를 JSON으로 (단위 µs, 기록이 없는 단계는 생략)
+// 반환 버퍼는 다음 호출까지 유효
 EMSCRIPTEN_KEEPALIVE
-double ascii_get_benchmark_max_time_simd_off(void) { return stats_simd_off.max_time_ms; }
+const char* ascii_get_stage_stats_json(void) {
+    static char json[4096];
+    const size_t cap = sizeof(json);
+    size_t n = 0;
+    auto us = [](uint64_t ns) { return (double)ns / 1000.0; };
+
+    n += snprintf(json + n, cap - n,
+                  "{\"unit\":\"us\",\"warmup_frames\":%u,\"frames\":%llu,"
+                  "\"simd_kernel\":\"%s\",\"downsample_kernel\":\"%s\","
+                  "\"fused\":%d,\"incremental\":%d,\"workers\":%d,"
+                  "\"grid\":[%d,%d],\"frames_converted\":%u,\"frames_skipped\":%u,"
+                  "\"temporal\":%d,\"temporal_stabilized\":%d,"
+                  "\"shape\":%d,\"shape_matched\":%d,\"subcell\":%d,"
+                  "\"dither\":\"%s\",\"dither_levels\":%d,"
+                  "\"static_regions\":%d,\"region_rows_reused\":%d,"
+                  "\"stages\":{",
+                  benchmark_warmup_frames, (unsigned long long)stage_frames,
+                  ascii_get_simd_kernel(), ascii_get_downsample_kernel(),
+                  use_fused ? 1 : 0, use_incremental ? 1 : 0, ascii_get_workers(),
+                  grid_w, grid_h, frames_converted, frames_skipped,
+                  use_temporal ? 1 : 0, temporal_stabilized,
+                  use_shape ? 1 : 0, shape_matched, subcell_mode,
+                  ascii_get_dither_name(), dither_color_levels(),
+                  use_regions ? 1 : 0, region_rows_reused);
+
+    bool first = true;
+    for (int s = 0; s < STAGE_COUNT && n < cap; ++s) {
+        const LatencyHistogram& h = stage_hist[s];
+        if (h.count == 0) continue;
+        n += snprintf(json + n, cap - n,
+                      "%s\"%s\":{\"count\":%llu,\"mean\":%.3f,\"min\":%.3f,"
+                      "\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,\"p999\":%.3f,"
+                      "\"max\":%.3f}",
+                      first ? "" : ",", stage_names[s], (unsigned long long)h.count,
+                      us(h.sum_ns) / (double)h.count, us(h.min_ns),
+                      us(hist_percentile(h, 0.50)), us(hist_percentile(h, 0.90)),
+                      us(hist_percentile(h, 0.99)), us(hist_percentile(h, 0.999)),
+                      us(h.max_ns));
+        first = false;
+    }
+    if (n < cap) snprintf(json + n, cap - n, "}}");
+    return json;
+}
+
+// 파이프라인 지정 조회 (fused: 1=융합, 0=2-패스)
 EMSCRIPTEN_KEEPALIVE
-double ascii_get_benchmark_avg_time_simd_off(void) { return stats_simd_off.avg_time_ms; }
+double ascii_get_benchmark_avg_time_pipeline(int fused, int simd) {
+    const int p = fused ? PIPE_FUSED : PIPE_TWO_PASS;
+    return simd ? stats_simd_on[p].avg_time_ms : stats_simd_off[p].avg_time_ms;
+}
 
 EMSCRIPTEN_KEEPALIVE
 double ascii_get_current_fps_simd_on(void) { return current_fps_simd_on; }
@@ -575,5 +4950,3 @@ int ascii_get_rgba_height(void) {
 }
 
 } // extern "C"
-
-#endif // __EMSCRIPTEN__
\ No newline at end of file
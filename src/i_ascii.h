@@ -5,7 +5,7 @@
 extern "C" {
 #endif
 
-// 문자 그리드 해상도 (웹/JS와 반드시 일치)
+// 기본 문자 그리드 해상도 (런타임에 I_SetASCIIGrid / ascii_set_grid로 변경 가능)
 #ifndef ASCII_WIDTH
 #define ASCII_WIDTH  240
 #endif
@@ -13,28 +13,257 @@ extern "C" {
 #define ASCII_HEIGHT 80
 #endif
 
+// 문자 램프 (어두움 → 밝음). 패킹 출력의 문자 번호는 이 문자열의 인덱스
+#define ASCII_GLYPHS " .:-=+*#%@"
+
 typedef struct {
     char    character;
     uint8_t r, g, b;
 } AsciiCell;
 
+// 하위 셀 출력 셀: 유니코드 한 글자 + 전경/배경색 (반 블록/점자 모드)
+typedef struct {
+    uint16_t codepoint;         // BMP 코드포인트: ' ', U+2580(▀), U+2800..28FF(점자)
+    uint8_t  fg_r, fg_g, fg_b;  // 글리프(윗 절반/켜진 점) 색
+    uint8_t  bg_r, bg_g, bg_b;  // 셀 나머지 색
+} AsciiWideCell;
+
+// 셀 델타: 직전 프레임 대비 바뀐 셀 (index = y * ascii_width + x)
+typedef struct {
+    uint32_t  index;
+    AsciiCell cell;
+} AsciiCellDelta;
+
 // 초기화/종료
 void I_InitASCII(void);
 void I_ShutdownASCII(void);
 
-// RGBA32(0xAARRGGBB) → ASCII 셀 버퍼 변환
+// RGBA32(0xAARRGGBB) → ASCII 셀 버퍼 변환 (Emscripten/네이티브 공통)
 void I_ConvertRGBAtoASCII(const uint32_t *rgba_buffer,
                           int src_width, int src_height,
                           void *output_buffer,
                           int ascii_width, int ascii_height);
 
+// 8비트 팔레트 버퍼(I_VideoBuffer) → ASCII 셀 버퍼 변환
+// RGBA32 경로와 결과가 같고, 소스 대역폭은 1/4
+void I_ConvertPal8toASCII(const uint8_t *pixels,
+                          int src_width, int src_height,
+                          void *output_buffer,
+                          int ascii_width, int ascii_height);
+
+// 발행된 프레임 (트리플 버퍼). 포인터는 같은 소비자가 다음 I_AcquireASCIIFrame을 부를 때까지 유효
+typedef struct {
+    const AsciiCell *cells;     // width * height
+    const uint16_t  *packed;    // 패킹 출력 (꺼져 있으면 NULL)
+    const uint8_t   *palette;   // ASCII_PACKED_INDEXED 팔레트 {r,g,b} * palette_count
+    const AsciiWideCell *wide;  // 하위 셀 출력 (꺼져 있으면 NULL)
+    int      subcell_mode;
+    int      packed_format;
+    int      palette_count;
+    int      width, height;
+    uint32_t sequence;          // 발행 번호 (1부터, 건너뛴 프레임은 번호 차이로 알 수 있음)
+    uint32_t frame_id;          // ascii_get_frame_id() 값 (델타 목록이 이 프레임 것인지 비교용)
+    int      tic;               // 생산자가 넘긴 게임 틱
+} AsciiFrame;
+
+// 직전 변환 결과를 발행 (셀/패킹 버퍼를 복사한 뒤 원자 교환). 새 변환이 없으면 0
+// 생산자 한 스레드, 소비자 한 스레드. 어느 쪽도 기다리지 않음
+int  I_PublishASCIIFrame(int tic);
+// 가장 최근에 완성된 프레임. 직전 호출 뒤 새로 발행된 게 있으면 1 (없으면 0, frame은 이전 것)
+int  I_AcquireASCIIFrame(AsciiFrame *frame);
+
+// 팔레트 설정 (256 * {r,g,b}, 화면 감마 적용 후 값). 바뀐 경우에만 테이블 재생성
+void I_SetASCIIPalette(const uint8_t *rgb);
+
+// 이번 프레임에 RGBA32 버퍼가 필요한지 (JS 모드, RGBA 소스 모드, 팔레트 미설정)
+int  I_ASCIINeedsRGBA(void);
+
+// 입력 소스 모드
+#define ASCII_SOURCE_RGBA32 0
+#define ASCII_SOURCE_PAL8   1
+
 // 버퍼 포인터/크기
 const void* I_GetASCIIBuffer(void);
 
+// 문자 그리드 크기 (1..2048 x 1..2048). 셀 버퍼를 새로 잡으므로 I_GetASCIIBuffer를 다시 읽을 것
+// 경계/역수 LUT 플랜은 (소스, 그리드) 해상도별로 캐시됨
+int  I_SetASCIIGrid(int width, int height);
+int  I_GetASCIIWidth(void);
+int  I_GetASCIIHeight(void);
+
 // 런타임 토글/상태
+int  ascii_set_grid(int width, int height);
+int  ascii_get_grid_width(void);
+int  ascii_get_grid_height(void);
 void ascii_set_simd(int enabled);
 int  ascii_get_simd(void);
 int  ascii_simd_supported(void);
+const char* ascii_get_simd_kernel(void);  // "avx2" | "ssse3" | "wasm-simd128" | "scalar"
+int  ascii_set_simd_kernel(const char* name);  // 같은 이름 또는 "auto", 지원 안 하면 0
+void ascii_set_source_mode(int mode);  // ASCII_SOURCE_RGBA32 | ASCII_SOURCE_PAL8(기본)
+int  ascii_get_source_mode(void);
+void ascii_set_sdl_output(int visible); // 0이면 SDL 텍스처 갱신/표시 생략 (웹: 숨김 캔버스)
+int  ascii_get_sdl_output(void);
+uint32_t ascii_get_palette_generation(void);
+void ascii_set_fused(int enabled);  // 1: 융합 행 타일 경로(기본), 0: 2-패스 경로
+int  ascii_get_fused(void);
+void ascii_set_area_weighting(int enabled);  // 1: 분수 면적 가중(기본), 0: 정수 경계 박스 평균
+int  ascii_get_area_weighting(void);
+void ascii_set_specialized(int enabled);     // 0이면 해상도 특수화 커널 대신 범용 커널
+int  ascii_get_specialized(void);
+// 다운샘플 커널: 기본은 (소스, 그리드)별로 후보를 재서 가장 빠른 것을 고름 (벤치마크 모드 켜면 다시 측정)
+void ascii_set_downsample_kernel(int kernel);   // -1 자동 | 0 integral | 1 weighted | 2 specialized | 3 separable
+const char* ascii_get_downsample_kernel(void);  // 직전 변환: "integral" | "weighted" | "specialized" | "separable"
+double ascii_get_benchmark_avg_time_downsample(int kernel);  // 튜닝 측정값 (ms)
+
+// 단계별 지연 히스토그램 (setup/dirty_scan/dirty_cells/integral/cells_fused/pass1/pass2/total)
+// 워밍업 프레임은 벤치마크 통계와 공통. JSON 버퍼는 다음 호출까지 유효
+void ascii_set_benchmark_warmup(int frames);  // 기본 3, 바꾸면 통계 리셋
+int  ascii_get_benchmark_warmup(void);
+void ascii_set_stage_timing(int enabled);     // 기본 켜짐
+int  ascii_get_stage_timing(void);
+void ascii_reset_stage_stats(void);
+const char* ascii_get_stage_stats_json(void); // {"unit":"us",...,"stages":{"total":{"p50":..}}}
+
+// 16비트 패킹 출력: 셀당 2바이트 = (문자 번호 << 12) | 12비트 색 (AsciiCell의 절반)
+// 변환마다 셀 버퍼와 같이 갱신됨. 꺼져 있거나 아직 변환 전이면 버퍼는 NULL
+#define ASCII_PACKED_OFF     0
+#define ASCII_PACKED_RGB444  1  // 색 = R4 G4 B4 (채널 반올림)
+#define ASCII_PACKED_INDEXED 2  // 색 = 프레임별 적응 팔레트 번호 (최대 4096색)
+void ascii_set_packed_format(int format);
+int  ascii_get_packed_format(void);
+const uint16_t* ascii_get_packed_buffer(void);  // uint16[grid_w * grid_h]
+const uint8_t*  ascii_get_packed_palette(void); // INDEXED: {r,g,b} * count
+int  ascii_get_packed_palette_count(void);
+
+// 패킹 값 풀기 (palette는 INDEXED일 때만 사용)
+static inline int ascii_packed_glyph(uint16_t p) { return p >> 12; }
+static inline char ascii_packed_char(uint16_t p) { return ASCII_GLYPHS[(p >> 12) % (sizeof(ASCII_GLYPHS) - 1)]; }
+static inline void ascii_unpack_cell(uint16_t p, int format, const uint8_t *palette,
+                                     AsciiCell *cell)
+{
+    const int c = p & 0x0FFF;
+    cell->character = ascii_packed_char(p);
+    if (format == ASCII_PACKED_INDEXED) {
+        cell->r = palette[c * 3 + 0];
+        cell->g = palette[c * 3 + 1];
+        cell->b = palette[c * 3 + 2];
+    } else {
+        cell->r = (uint8_t)((c >> 8) * 17);
+        cell->g = (uint8_t)(((c >> 4) & 15) * 17);
+        cell->b = (uint8_t)((c & 15) * 17);
+    }
+}
+
+// 증분 변환: 바뀐 소스 구간에 걸친 셀만 재계산하고 델타 목록을 남김 (기본 켜짐)
+// 델타는 frame_id - 1 프레임 위에 적용됨. delta_full이면 전체 버퍼를 다시 그려야 함
+// 출력 버퍼를 밖에서 고쳤다면 ascii_set_incremental(1)로 다음 프레임을 전체 변환시킬 것
+void ascii_set_incremental(int enabled);
+int  ascii_get_incremental(void);
+const void* ascii_get_delta_buffer(void);  // AsciiCellDelta[delta_count]
+int  ascii_get_delta_count(void);
+int  ascii_get_delta_full(void);
+
+// 정적 화면 영역: 엔진이 "소유 서브시스템이 다시 그리기 전까지 그대로"인 소스 사각형을 등록 (상태 표시줄, 화면 테두리)
+// 깨끗한 영역은 증분 변환의 행 비교에서 빠지고, 전체 변환은 깨끗한 영역에만 걸친 셀 행을 직전 출력에서 재사용
+// 영역 안 픽셀을 바꾸는 쪽은 반드시 I_MarkASCIIRect로 알려야 함 (V_MarkRect가 대신 호출)
+// 행 비교는 행의 왼쪽/오른쪽 끝에 붙은 사각형만 잘라냄 (가운데 사각형은 그냥 비교)
+#define ASCII_REGION_STATUSBAR 0
+#define ASCII_REGION_BORDER    1
+#define ASCII_REGION_COUNT     2
+#define ASCII_REGION_MAX_RECTS 4
+void I_SetASCIIRegion(int region, const int *rects, int count);  // rects: {x, y, w, h} * count (0이면 해제). 바뀌면 한 번 더티
+void I_MarkASCIIRegionDirty(int region);            // -1이면 전부
+void I_MarkASCIIRect(int x, int y, int w, int h);   // 겹치는 영역을 더티로
+void ascii_set_static_regions(int enabled);  // 기본 켜짐
+int  ascii_get_static_regions(void);
+int  ascii_get_region_rows_reused(void);     // 직전 프레임에서 직전 출력을 재사용한 셀 행 수
+
+// 같은 프레임 건너뛰기: 소스 버퍼의 64비트 내용 해시(+팔레트 세대, 크기, 가중 방식, 패킹 형식)가
+// 직전 변환과 같으면 변환을 생략. frame_id/발행 번호/델타/패킹 버퍼는 직전 프레임 그대로
+void ascii_set_frame_skip(int enabled);  // 기본 켜짐 (벤치마크 모드에서는 항상 변환)
+int  ascii_get_frame_skip(void);
+int  ascii_get_frame_unchanged(void);    // 직전 변환 호출이 생략됐으면 1
+uint32_t ascii_get_frames_converted(void);
+uint32_t ascii_get_frames_skipped(void);
+void ascii_reset_frame_counters(void);
+
+// 시간 히스테리시스: 셀마다 직전 글리프/색을 기억해 경계 근처의 깜빡임을 억제
+// 글리프는 밝기가 이전 글리프 구간을 lum_margin 넘게 벗어날 때만, 색은 채널 차이가 color_margin을 넘을 때만 바뀜
+// 증분 프레임에서는 결과가 이전 출력과 같아진 셀을 델타에서 뺌 (패킹/발행도 거른 결과 기준)
+void ascii_set_temporal_filter(int enabled);  // 기본 꺼짐
+int  ascii_get_temporal_filter(void);
+void ascii_set_temporal_margin(int lum_margin, int color_margin);  // 기본 6, 8. 음수는 유지
+int  ascii_get_temporal_lum_margin(void);
+int  ascii_get_temporal_color_margin(void);
+int  ascii_get_temporal_stabilized(void);  // 직전 프레임에서 변환 결과 대신 이전 값을 낸 셀 수
+
+// 모양 글리프: 셀 2x2 사분면 밝기 서명 → 12비트 키 → 표 조회로 윤곽선 셀에 / \ _ ' ( ) 등 선택
+// 사분면 밝기 차가 임계값 미만인 셀은 램프 문자 유지, 색은 바꾸지 않음
+void ascii_set_shape_glyphs(int enabled);       // 기본 꺼짐
+int  ascii_get_shape_glyphs(void);
+void ascii_set_shape_threshold(int threshold);  // 0..255, 기본 40
+int  ascii_get_shape_threshold(void);
+int  ascii_get_shape_matched(void);  // 직전 프레임에서 모양 글리프로 바꾼 셀 수
+
+// 하위 셀 출력: 셀 그리드와 함께 셀마다 유니코드 글자 + 전경/배경색 두 가지를 만듦
+// 셀 수는 그대로 두고 반 블록은 세로 2배, 점자는 가로 2배 x 세로 4배 해상도. 터미널은 UTF-8로 내보냄
+// 하위 픽셀 평균은 적분영상의 박스 합, 점자 임계값(하위 픽셀 8개 평균 밝기)과 전경/배경 평균은 SIMD
+#define ASCII_SUBCELL_OFF     0
+#define ASCII_SUBCELL_HALF    1  // ▀: 전경 = 위 절반, 배경 = 아래 절반 (같으면 공백)
+#define ASCII_SUBCELL_BRAILLE 2  // 2x4 점: 평균보다 밝은 점 = 전경, 나머지 = 배경 (켜진 점이 없으면 공백)
+void ascii_set_subcell_mode(int mode);
+int  ascii_get_subcell_mode(void);
+const AsciiWideCell* ascii_get_wide_buffer(void);  // AsciiWideCell[grid_w * grid_h], 꺼져 있으면 NULL
+
+// 디더링: 램프 문자 번호와 색 단계 사이의 밝기/색을 이웃 셀에 나눠 띠(밴딩)를 줄임
+// BAYER는 셀 좌표에 고정된 8x8 임계값 행렬 → 같은 화면이면 같은 무늬 (움직여도 노이즈가 기어다니지 않음)
+// FLOYD/ATKINSON은 오차를 행 순서로 퍼뜨림 → 매 프레임 전체 변환, 워커 풀 안 씀
+// 색은 감마 보정 값을 단계 수만큼 나눈 격자로 디더링 (단계 0: 자동 - 패킹 출력이면 16단계, 아니면 문자만)
+#define ASCII_DITHER_OFF      0
+#define ASCII_DITHER_BAYER    1
+#define ASCII_DITHER_FLOYD    2  // Floyd-Steinberg
+#define ASCII_DITHER_ATKINSON 3
+#define ASCII_DITHER_COUNT    4
+void ascii_set_dither(int mode);           // 기본 꺼짐
+int  ascii_get_dither(void);
+const char* ascii_get_dither_name(void);   // "off" | "bayer" | "floyd" | "atkinson"
+void ascii_set_dither_levels(int levels);  // 채널별 색 단계 2..256, 0: 자동(기본)
+int  ascii_get_dither_levels(void);
+double ascii_get_benchmark_avg_time_dither(int mode);     // 벤치마크 모드: 디더링 방식별 평균 (ms)
+double ascii_get_benchmark_frame_count_dither(int mode);
+
+// 터미널 색 양자화: 감마 보정된 셀 RGB → xterm 256색(16..255: 6x6x6 큐브 + 회색 24단계) / ANSI 16색 번호
+// 채널 상위 6비트로 찾는 64x64x64 큐브를 한 번 만들어 셀마다 조회 한 번. 칸 안 색이 모두 같은 최근접이면 그 번호,
+// 경계가 지나는 칸(Doom 화면 셀의 약 6~8%)만 정확히 계산 → 결과는 전체 탐색과 같음
+#define ASCII_QUANT_XTERM256 0
+#define ASCII_QUANT_ANSI16   1
+#define ASCII_QUANT_COUNT    2
+#define ASCII_QUANT_BITS     6
+int  I_InitASCIIQuant(int target);  // 큐브 만들기 (처음 한 번, 10~20 ms). 할당 실패면 0
+int  I_QuantizeASCIIColor(int target, int r, int g, int b);
+const uint8_t* I_GetASCIIQuantPalette(int target);  // 색 번호 → {r,g,b} (XTERM256: 256색, ANSI16: 16색)
+// 프레임 전체: out[i] = cells[i] 색 번호 (AVX2는 gather, 변환기의 SIMD 선택을 따름)
+void I_QuantizeASCIICells(int target, const AsciiCell *cells, int count, uint8_t *out);
+
+// 워커 풀: 큰 그리드/소스의 전체 변환을 행 밴드로 나눠 병렬 처리 (결과는 워커 수와 무관)
+void   ascii_set_workers(int count);  // 0: 자동(기본), 1: 끔, n: 호출 스레드 포함 n개
+int    ascii_get_workers(void);
+double ascii_get_worker_time(int worker);  // 직전 전체 변환의 워커별 작업 시간 (ms)
+int    ascii_get_last_frame_parallel(void);
+
+// 발행 프레임 JS 조회: ascii_acquire_frame() 후 getter로 읽음
+int  ascii_acquire_frame(void);
+const AsciiCell* ascii_get_acquired_cells(void);
+const uint16_t*  ascii_get_acquired_packed(void);
+const uint8_t*   ascii_get_acquired_palette(void);
+const AsciiWideCell* ascii_get_acquired_wide(void);
+int  ascii_get_acquired_palette_count(void);
+int  ascii_get_acquired_width(void);
+int  ascii_get_acquired_height(void);
+uint32_t ascii_get_acquired_sequence(void);
+uint32_t ascii_get_acquired_frame_id(void);
+int  ascii_get_acquired_tic(void);
 
 // (선택) 엔진 FPS/지연 측정용 카운터 getter
 uint32_t ascii_get_frame_id(void);
@@ -42,4 +271,4 @@ double   ascii_get_last_ms(void);
 
 #ifdef __cplusplus
 }
-#endif
\ No newline at end of file
+#endif
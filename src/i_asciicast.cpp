@@ -0,0 +1,387 @@
+#include "config.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// 소켓은 POSIX 전용 (Emscripten/Windows는 시작 실패로 처리)
+#if !defined(__EMSCRIPTEN__) && !defined(_WIN32)
+#define ASCII_HAVE_CAST 1
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#include "i_ascii.h"
+#include "i_asciicast.h"
+
+#if defined(MSG_NOSIGNAL)
+#define CAST_SEND_FLAGS MSG_NOSIGNAL  // 끊긴 구독자에 쓸 때 SIGPIPE 대신 EPIPE
+#else
+#define CAST_SEND_FLAGS 0             // macOS: 소켓마다 SO_NOSIGPIPE
+#endif
+
+static constexpr int CAST_MERGE_GAP = 1;      // 안 바뀐 셀 1개(4바이트) < 런 헤더(6바이트) → 런을 이어 붙임
+static constexpr int CAST_MAX_RUN   = 65535;  // uint16 개수
+static constexpr int CAST_BACKLOG   = 64;
+
+// ===== 링 =====
+// 슬롯 = 프레임 하나의 인코딩 결과. 델타는 방송할 때 한 번, 키프레임은 필요한 구독자가 생기면 한 번
+struct CastSlot {
+    uint64_t seq = 0;
+    int      w = 0, h = 0;
+    std::vector<uint8_t> delta;  // 메시지 전체 (헤더 포함). 비어 있으면 델타 없음 (첫 프레임/크기 변경)
+    std::vector<uint8_t> key;    // 비어 있으면 아직 인코딩 안 함
+};
+
+struct CastClient {
+    int      fd = -1;
+    uint64_t next_seq = 0;       // 다음에 보낼 프레임
+    bool     need_key = true;    // 새 구독자 / 링을 놓침
+    const uint8_t* msg = nullptr;  // 보내는 중인 메시지 (링 슬롯 또는 tail)
+    size_t   msg_size = 0, msg_off = 0;
+    uint64_t msg_seq = 0;
+    std::vector<uint8_t> tail;   // 보내는 도중 링에서 덮어쓴 메시지의 나머지
+};
+
+// ===== 상태 =====
+static bool cast_active = false;
+#ifdef ASCII_HAVE_CAST
+static int  listen_fd = -1;
+static std::string unix_path;    // 종료 시 지울 소켓 파일
+#endif
+static CastSlot ring[ASCII_CAST_RING];
+static uint64_t newest_seq = 0;  // 0: 아직 프레임 없음
+static std::vector<CastClient> clients;
+static std::vector<AsciiCell> shown;  // 직전 방송 프레임 (델타 기준)
+static int shown_w = 0, shown_h = 0;
+static AsciiCastStats stats;
+
+static inline double cast_now_ms(void) {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+// ---------- 인코딩 ----------
+static inline void put_u16(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_u32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+
+static void put_header(std::vector<uint8_t>& msg, char type, uint64_t seq, int w, int h) {
+    uint8_t* p = msg.data();
+    std::memcpy(p, ASCII_CAST_MAGIC, 4);
+    p[4] = (uint8_t)type; p[5] = p[6] = p[7] = 0;
+    put_u32(p + 8, (uint32_t)seq);
+    put_u16(p + 12, (uint32_t)w);
+    put_u16(p + 14, (uint32_t)h);
+    put_u32(p + 16, (uint32_t)(msg.size() - ASCII_CAST_HEADER_SIZE));
+}
+
+// 키프레임: 현재 프레임(shown) 그대로
+static void encode_key(CastSlot& s) {
+    const size_t cells = (size_t)s.w * s.h;
+    s.key.resize(ASCII_CAST_HEADER_SIZE + cells * sizeof(AsciiCell));
+    std::memcpy(s.key.data() + ASCII_CAST_HEADER_SIZE, shown.data(), cells * sizeof(AsciiCell));
+    put_header(s.key, ASCII_CAST_KEY, s.seq, s.w, s.h);
+    stats.keyframes++;
+    stats.encoded_bytes += s.key.size();
+}
+
+static inline bool same_cell(const AsciiCell* a, const AsciiCell* b) {
+    return std::memcmp(a, b, sizeof(AsciiCell)) == 0;
+}
+
+// 델타: shown과 다른 셀의 런. 8바이트(2셀)씩 비교해 안 바뀐 구간을 빨리 건너뜀. shown도 함께 갱신
+static void encode_delta(CastSlot& s, const AsciiCell* cells) {
+    const int n = s.w * s.h;
+    AsciiCell* prev = shown.data();
+    std::vector<uint8_t>& msg = s.delta;
+    msg.resize(ASCII_CAST_HEADER_SIZE);
+
+    int i = 0;
+    while (i < n) {
+        while (i + 2 <= n && std::memcmp(prev + i, cells + i, 2 * sizeof(AsciiCell)) == 0) i += 2;
+        while (i < n && same_cell(prev + i, cells + i)) ++i;
+        if (i >= n) break;
+
+        int end = i + 1;
+        for (int j = i + 1; j < n && j - end <= CAST_MERGE_GAP && end - i < CAST_MAX_RUN; ++j) {
+            if (!same_cell(prev + j, cells + j)) end = j + 1;
+        }
+        const int count = std::min(end - i, CAST_MAX_RUN);
+        const size_t at = msg.size();
+        msg.resize(at + 6 + (size_t)count * sizeof(AsciiCell));
+        put_u32(msg.data() + at, (uint32_t)i);
+        put_u16(msg.data() + at + 4, (uint32_t)count);
+        std::memcpy(msg.data() + at + 6, cells + i, (size_t)count * sizeof(AsciiCell));
+        std::memcpy(prev + i, cells + i, (size_t)count * sizeof(AsciiCell));
+        i += count;
+    }
+    put_header(msg, ASCII_CAST_DELTA, s.seq, s.w, s.h);
+    stats.encoded_bytes += msg.size();
+}
+
+// ---------- 구독자 ----------
+#ifdef ASCII_HAVE_CAST
+static bool set_nonblocking(int fd) {
+    const int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static void close_client(CastClient& c) {
+    if (c.fd >= 0) close(c.fd);
+    c.fd = -1;
+}
+
+static void accept_clients(void) {
+    for (;;) {
+        const int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) return;  // EAGAIN, 또는 fd 한도 (다음 펌프에서 다시)
+        if (!set_nonblocking(fd)) { close(fd); continue; }
+        const int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));  // 유닉스 소켓이면 무시됨
+#ifdef SO_NOSIGPIPE
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+        CastClient c;
+        c.fd = fd;
+        clients.push_back(std::move(c));
+        stats.accepted++;
+    }
+}
+
+// 다음 메시지 고르기. 보낼 것이 없으면 false
+static bool next_message(CastClient& c) {
+    if (newest_seq == 0) return false;
+    const uint64_t kept = std::min<uint64_t>(newest_seq, ASCII_CAST_RING);
+    if (!c.need_key && c.next_seq + kept <= newest_seq) {
+        c.need_key = true;  // 링에서 밀려남: 남은 델타는 버리고 최신 키프레임으로
+        stats.drops++;
+    }
+
+    const CastSlot* s;
+    if (c.need_key) {
+        CastSlot& newest = ring[newest_seq % ASCII_CAST_RING];
+        if (newest.key.empty()) encode_key(newest);
+        c.need_key = false;
+        c.msg = newest.key.data();
+        c.msg_size = newest.key.size();
+        s = &newest;
+    } else {
+        if (c.next_seq > newest_seq) return false;
+        s = &ring[c.next_seq % ASCII_CAST_RING];
+        const std::vector<uint8_t>& m = s->delta.empty() ? s->key : s->delta;
+        c.msg = m.data();
+        c.msg_size = m.size();
+    }
+    c.msg_seq = s->seq;
+    c.msg_off = 0;
+    return true;
+}
+
+// 쓸 수 있는 만큼 씀. 연결이 끊겼으면 false
+static bool flush_client(CastClient& c) {
+    for (;;) {
+        if (!c.msg && !next_message(c)) return true;
+        const ssize_t r = send(c.fd, c.msg + c.msg_off, c.msg_size - c.msg_off, CAST_SEND_FLAGS);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        c.msg_off += (size_t)r;
+        stats.sent_bytes += (uint64_t)r;
+        if (c.msg_off < c.msg_size) continue;
+        c.next_seq = c.msg_seq + 1;
+        c.msg = nullptr;
+        c.tail.clear();
+    }
+}
+
+// 슬롯을 덮어쓰기 전에, 그 슬롯을 보내는 중인 구독자에게 나머지를 따로 복사
+static void detach_slot(const CastSlot& s) {
+    if (s.seq == 0) return;
+    for (CastClient& c : clients) {
+        if (!c.msg || c.msg_seq != s.seq || !c.tail.empty()) continue;
+        c.tail.assign(c.msg + c.msg_off, c.msg + c.msg_size);
+        c.msg = c.tail.data();
+        c.msg_size = c.tail.size();
+        c.msg_off = 0;
+    }
+}
+#endif
+
+static void pump(void) {
+#ifdef ASCII_HAVE_CAST
+    const double t0 = cast_now_ms();
+    accept_clients();
+
+    // poll 한 번으로 끊긴 구독자(POLLIN/오류)와 쓸 수 있는 구독자를 가림
+    static std::vector<struct pollfd> pfd;
+    pfd.resize(clients.size());
+    for (size_t i = 0; i < clients.size(); ++i) {
+        pfd[i].fd = clients[i].fd;
+        pfd[i].events = POLLIN | POLLOUT;
+        pfd[i].revents = 0;
+    }
+    if (!pfd.empty()) poll(pfd.data(), (nfds_t)pfd.size(), 0);
+
+    size_t live = 0;
+    for (size_t i = 0; i < clients.size(); ++i) {
+        CastClient& c = clients[i];
+        bool ok = !(pfd[i].revents & (POLLERR | POLLHUP | POLLNVAL));
+        if (ok && (pfd[i].revents & POLLIN)) {
+            char junk[256];  // 구독자가 보내는 것은 읽고 버림. 0이면 연결 종료
+            const ssize_t r = recv(c.fd, junk, sizeof(junk), 0);
+            ok = r > 0 || (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR));
+        }
+        if (ok && (pfd[i].revents & POLLOUT)) ok = flush_client(c);
+        if (!ok) { close_client(c); continue; }
+        if (live != i) clients[live] = std::move(c);
+        ++live;
+    }
+    clients.resize(live);
+    stats.clients = (int)live;
+    stats.send_ms += cast_now_ms() - t0;
+#endif
+}
+
+// ---------- API ----------
+int I_StartASCIICast(const char *address) {
+#ifdef ASCII_HAVE_CAST
+    I_StopASCIICast();
+    if (!address || !*address) return 0;
+
+    int fd = -1;
+    if (!std::strncmp(address, "unix:", 5)) {
+        struct sockaddr_un sa;
+        std::memset(&sa, 0, sizeof(sa));
+        sa.sun_family = AF_UNIX;
+        if (std::strlen(address + 5) >= sizeof(sa.sun_path)) return 0;
+        std::strcpy(sa.sun_path, address + 5);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return 0;
+        unlink(sa.sun_path);  // 이전 실행이 남긴 소켓 파일
+        if (bind(fd, (struct sockaddr*)&sa, sizeof(sa)) != 0) { close(fd); return 0; }
+        unix_path = sa.sun_path;
+    } else {
+        // "호스트:포트" 또는 "포트"
+        std::string host, port = address;
+        const size_t colon = port.rfind(':');
+        if (colon != std::string::npos) {
+            host = port.substr(0, colon);
+            port = port.substr(colon + 1);
+        }
+        struct addrinfo hints, *res = nullptr;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE;
+        if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &res) != 0) return 0;
+        for (struct addrinfo* ai = res; ai && fd < 0; ai = ai->ai_next) {
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd < 0) continue;
+            const int one = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            if (bind(fd, ai->ai_addr, ai->ai_addrlen) != 0) { close(fd); fd = -1; }
+        }
+        freeaddrinfo(res);
+        if (fd < 0) return 0;
+    }
+    if (listen(fd, CAST_BACKLOG) != 0 || !set_nonblocking(fd)) {
+        close(fd);
+        if (!unix_path.empty()) unlink(unix_path.c_str());
+        unix_path.clear();
+        return 0;
+    }
+
+    listen_fd = fd;
+    cast_active = true;
+    newest_seq = 0;
+    shown_w = shown_h = 0;
+    std::memset(&stats, 0, sizeof(stats));
+    return 1;
+#else
+    (void)address;
+    return 0;
+#endif
+}
+
+void I_StopASCIICast(void) {
+#ifdef ASCII_HAVE_CAST
+    if (!cast_active) return;
+    for (CastClient& c : clients) close_client(c);
+    clients.clear();
+    close(listen_fd);
+    listen_fd = -1;
+    if (!unix_path.empty()) unlink(unix_path.c_str());
+    unix_path.clear();
+    cast_active = false;
+
+    for (CastSlot& s : ring) {
+        s.seq = 0;
+        std::vector<uint8_t>().swap(s.delta);
+        std::vector<uint8_t>().swap(s.key);
+    }
+    std::vector<AsciiCell>().swap(shown);
+    shown_w = shown_h = 0;
+#endif
+}
+
+int I_ASCIICastActive(void) {
+    return cast_active ? 1 : 0;
+}
+
+void I_BroadcastASCIIFrame(const AsciiCell *cells, int width, int height) {
+    if (!cast_active || !cells || width <= 0 || height <= 0) return;
+    if (width > 0xFFFF || height > 0xFFFF) return;
+
+    const double t0 = cast_now_ms();
+    const uint64_t seq = newest_seq + 1;
+    CastSlot& s = ring[seq % ASCII_CAST_RING];
+#ifdef ASCII_HAVE_CAST
+    detach_slot(s);
+#endif
+    s.seq = seq;
+    s.w = width;
+    s.h = height;
+    s.key.clear();
+    if (shown_w != width || shown_h != height) {
+        // 델타 기준이 없음: 키프레임만 (모든 구독자가 이 프레임에서 다시 맞춰짐)
+        shown.assign(cells, cells + (size_t)width * height);
+        shown_w = width;
+        shown_h = height;
+        s.delta.clear();
+        encode_key(s);
+    } else {
+        encode_delta(s, cells);
+    }
+    newest_seq = seq;
+    stats.frames++;
+    stats.encode_ms += cast_now_ms() - t0;
+
+    pump();
+}
+
+void I_PumpASCIICast(void) {
+    if (cast_active) pump();
+}
+
+void I_GetASCIICastStats(AsciiCastStats *out) {
+    *out = stats;
+    out->clients = (int)clients.size();
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <stdint.h>
+
+#include "i_ascii.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 관전 방송 서버: 변환된 AsciiCell 프레임을 한 번만 인코딩해서 여러 구독자(TCP/유닉스 소켓)에게 보냄
+// 인코딩 결과는 공유 링(최근 ASCII_CAST_RING 프레임)에 두고, 구독자마다 링 위치만 따로 가짐
+// 쓰기는 논블로킹. 링을 따라오지 못한 구독자는 밀린 델타를 버리고 최신 키프레임부터 다시 받음
+// (네이티브 POSIX 전용)
+//
+// 메시지 형식 (리틀 엔디언):
+//   헤더 20바이트  "ACST" + uint8 종류 + uint8 0 x3 + uint32 순번 + uint16 가로 + uint16 세로
+//                  + uint32 본문 바이트
+//   'K' 키프레임  가로 * 세로 * {문자, r, g, b}
+//   'D' 델타      순번 - 1 프레임 위에 적용: {uint32 시작 셀, uint16 개수, 개수 * {문자, r, g, b}} 반복
+// 구독자의 첫 메시지와 밀린 뒤의 첫 메시지는 항상 키프레임
+
+#define ASCII_CAST_MAGIC       "ACST"
+#define ASCII_CAST_HEADER_SIZE 20
+#define ASCII_CAST_KEY         'K'
+#define ASCII_CAST_DELTA       'D'
+#define ASCII_CAST_RING        32    // 프레임 (35fps 기준 약 0.9초)
+
+// 주소: "unix:/경로", "호스트:포트", "포트" (모든 인터페이스). 실패하면 0
+int  I_StartASCIICast(const char *address);
+void I_StopASCIICast(void);
+int  I_ASCIICastActive(void);
+
+// 새 프레임을 인코딩해 링에 넣고 구독자에게 보냄 (프레임당 한 번)
+void I_BroadcastASCIIFrame(const AsciiCell *cells, int width, int height);
+// 새 프레임 없이 접속 수락/밀린 데이터 전송만 (같은 프레임을 건너뛴 경우)
+void I_PumpASCIICast(void);
+
+typedef struct {
+    int      clients;          // 현재 구독자 수
+    uint64_t frames;           // 방송한 프레임 수
+    uint64_t keyframes;        // 인코딩한 키프레임 수 (구독자 수와 무관)
+    uint64_t encoded_bytes;    // 인코딩한 바이트 (델타 + 키프레임)
+    uint64_t sent_bytes;       // 모든 구독자에게 보낸 바이트 합
+    uint64_t drops;            // 밀려서 키프레임으로 건너뛴 횟수
+    uint64_t accepted;         // 누적 접속 수
+    double   encode_ms;        // 누적 인코딩 시간
+    double   send_ms;          // 누적 전송(수락 + 쓰기) 시간
+} AsciiCastStats;
+
+void I_GetASCIICastStats(AsciiCastStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
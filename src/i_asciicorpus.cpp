@@ -0,0 +1,207 @@
+#include "config.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+
+#include "i_asciicorpus.h"
+
+static constexpr char     CORPUS_MAGIC[8] = { 'A','S','C','I','I','C','R','P' };
+static constexpr uint32_t CORPUS_VERSION  = 1;
+static constexpr int      CORPUS_MAX_DIM  = 4096;  // 읽을 때 손상된 레코드 거르기
+
+// ===== 캡처 =====
+static FILE*    capture_file = nullptr;
+static uint32_t capture_frames = 0;
+static uint8_t  capture_pal[256 * 3];
+static bool     capture_pal_valid = false;
+static bool     capture_pal_written = false;  // 현재 팔레트가 파일에 있는지
+static std::vector<uint8_t> capture_scratch;  // RGBA32 → 리틀 엔디언 바이트
+
+static bool write_record_header(char type, int width, int height) {
+    const uint8_t h[6] = {
+        (uint8_t)type, 0,
+        (uint8_t)(width & 0xff), (uint8_t)(width >> 8),
+        (uint8_t)(height & 0xff), (uint8_t)(height >> 8)
+    };
+    return fwrite(h, 1, sizeof(h), capture_file) == sizeof(h);
+}
+
+static void capture_failed(void) {
+    fprintf(stderr, "I_ASCIICapture: write failed, capture stopped after %u frames\n",
+            capture_frames);
+    I_StopASCIICapture();
+}
+
+static void write_palette(void) {
+    if (!write_record_header('P', 0, 0)
+     || fwrite(capture_pal, 1, sizeof(capture_pal), capture_file) != sizeof(capture_pal)) {
+        capture_failed();
+        return;
+    }
+    capture_pal_written = true;
+}
+
+int I_StartASCIICapture(const char *path) {
+    I_StopASCIICapture();
+    capture_file = fopen(path, "wb");
+    if (!capture_file) return 0;
+
+    uint8_t h[12];
+    std::memcpy(h, CORPUS_MAGIC, 8);
+    for (int i = 0; i < 4; ++i) h[8 + i] = (uint8_t)(CORPUS_VERSION >> (8 * i));
+    if (fwrite(h, 1, sizeof(h), capture_file) != sizeof(h)) {
+        fclose(capture_file);
+        capture_file = nullptr;
+        return 0;
+    }
+    capture_frames = 0;
+    capture_pal_written = false;
+    return 1;
+}
+
+void I_StopASCIICapture(void) {
+    if (!capture_file) return;
+    fclose(capture_file);
+    capture_file = nullptr;
+    std::vector<uint8_t>().swap(capture_scratch);
+}
+
+int I_ASCIICaptureActive(void) {
+    return capture_file != nullptr;
+}
+
+uint32_t I_GetASCIICaptureFrames(void) {
+    return capture_frames;
+}
+
+void I_CaptureASCIIPalette(const uint8_t *rgb) {
+    if (capture_pal_valid && std::memcmp(capture_pal, rgb, sizeof(capture_pal)) == 0) {
+        return;
+    }
+    std::memcpy(capture_pal, rgb, sizeof(capture_pal));
+    capture_pal_valid = true;
+    capture_pal_written = false;
+}
+
+void I_CaptureASCIIPal8(const uint8_t *pixels, int width, int height) {
+    if (!capture_file) return;
+    // 팔레트는 바뀐 뒤 첫 8비트 프레임 직전에만 기록
+    if (capture_pal_valid && !capture_pal_written) {
+        write_palette();
+        if (!capture_file) return;
+    }
+    const size_t n = (size_t)width * height;
+    if (!write_record_header('8', width, height)
+     || fwrite(pixels, 1, n, capture_file) != n) {
+        capture_failed();
+        return;
+    }
+    capture_frames++;
+}
+
+void I_CaptureASCIIRGBA(const uint32_t *pixels, int width, int height) {
+    if (!capture_file) return;
+    const size_t n = (size_t)width * height;
+    capture_scratch.resize(n * 4);
+    uint8_t* d = capture_scratch.data();
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t p = pixels[i];
+        d[i*4 + 0] = (uint8_t)p;
+        d[i*4 + 1] = (uint8_t)(p >> 8);
+        d[i*4 + 2] = (uint8_t)(p >> 16);
+        d[i*4 + 3] = (uint8_t)(p >> 24);
+    }
+    if (!write_record_header('R', width, height)
+     || fwrite(d, 1, n * 4, capture_file) != n * 4) {
+        capture_failed();
+        return;
+    }
+    capture_frames++;
+}
+
+// ===== 읽기 =====
+struct CorpusFrame {
+    int type, width, height;
+    int palette;                  // corpus_palettes 인덱스 (-1: 없음)
+    std::vector<uint32_t> pixels; // 8비트는 바이트 단위로 앞쪽만 사용
+};
+
+static std::vector<CorpusFrame> corpus_frames;
+static std::vector<std::vector<uint8_t>> corpus_palettes;
+
+int I_LoadASCIICorpus(const char *path, int max_frames) {
+    I_FreeASCIICorpus();
+    FILE* f = fopen(path, "rb");
+    if (!f) return -1;
+
+    uint8_t h[12];
+    if (fread(h, 1, sizeof(h), f) != sizeof(h) || std::memcmp(h, CORPUS_MAGIC, 8) != 0) {
+        fclose(f);
+        return -1;
+    }
+    const uint32_t version = h[8] | (h[9] << 8) | (h[10] << 16) | ((uint32_t)h[11] << 24);
+    if (version != CORPUS_VERSION) {
+        fclose(f);
+        return -1;
+    }
+
+    int palette = -1;
+    uint8_t r[6];
+    while ((max_frames <= 0 || (int)corpus_frames.size() < max_frames)
+        && fread(r, 1, sizeof(r), f) == sizeof(r)) {
+        const int w = r[2] | (r[3] << 8);
+        const int hgt = r[4] | (r[5] << 8);
+        if (r[0] == 'P') {
+            std::vector<uint8_t> pal(256 * 3);
+            if (fread(pal.data(), 1, pal.size(), f) != pal.size()) break;
+            corpus_palettes.push_back(std::move(pal));
+            palette = (int)corpus_palettes.size() - 1;
+            continue;
+        }
+        if ((r[0] != '8' && r[0] != 'R') || w <= 0 || hgt <= 0
+         || w > CORPUS_MAX_DIM || hgt > CORPUS_MAX_DIM) {
+            break;  // 손상/잘린 꼬리: 앞쪽 프레임만 사용
+        }
+
+        CorpusFrame fr;
+        fr.type = (r[0] == '8') ? ASCII_CORPUS_PAL8 : ASCII_CORPUS_RGBA32;
+        fr.width = w;
+        fr.height = hgt;
+        fr.palette = (fr.type == ASCII_CORPUS_PAL8) ? palette : -1;
+        const size_t n = (size_t)w * hgt;
+        fr.pixels.resize(fr.type == ASCII_CORPUS_PAL8 ? (n + 3) / 4 : n);
+        if (fr.type == ASCII_CORPUS_PAL8) {
+            if (fread(fr.pixels.data(), 1, n, f) != n) break;
+            if (fr.palette < 0) continue;  // 팔레트 전 프레임은 재생 불가
+        } else {
+            std::vector<uint8_t> bytes(n * 4);
+            if (fread(bytes.data(), 1, bytes.size(), f) != bytes.size()) break;
+            for (size_t i = 0; i < n; ++i) {
+                fr.pixels[i] = bytes[i*4] | (bytes[i*4 + 1] << 8) | (bytes[i*4 + 2] << 16)
+                             | ((uint32_t)bytes[i*4 + 3] << 24);
+            }
+        }
+        corpus_frames.push_back(std::move(fr));
+    }
+    fclose(f);
+    return (int)corpus_frames.size();
+}
+
+int I_GetASCIICorpusFrame(int index, AsciiCorpusFrame *frame) {
+    if (index < 0 || index >= (int)corpus_frames.size()) return 0;
+    const CorpusFrame& fr = corpus_frames[index];
+    frame->type = fr.type;
+    frame->width = fr.width;
+    frame->height = fr.height;
+    frame->pixels = fr.pixels.data();
+    frame->palette = fr.palette >= 0 ? corpus_palettes[fr.palette].data() : nullptr;
+    return 1;
+}
+
+void I_FreeASCIICorpus(void) {
+    std::vector<CorpusFrame>().swap(corpus_frames);
+    std::vector<std::vector<uint8_t>>().swap(corpus_palettes);
+}
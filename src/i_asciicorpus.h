@@ -0,0 +1,45 @@
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ASCII 변환 입력 코퍼스: 게임 실행 중 변환기에 들어간 프레임/팔레트를 그대로 저장하고
+// asciibench가 다시 읽어 커널별로 재생함
+//
+// 파일 형식 (리틀 엔디언):
+//   헤더   "ASCIICRP" + uint32 버전(1)
+//   레코드 uint8 종류 + uint8 0 + uint16 가로 + uint16 세로 + 본문
+//     'P' 팔레트  256 * {r,g,b} (가로/세로 0, 이후 8비트 프레임에 적용)
+//     '8' 8비트   가로 * 세로 바이트 (I_VideoBuffer)
+//     'R' RGBA32  가로 * 세로 * 4바이트 (argbbuffer, 0xAARRGGBB)
+
+#define ASCII_CORPUS_PAL8   0
+#define ASCII_CORPUS_RGBA32 1
+
+// ---------- 캡처 (게임) ----------
+int  I_StartASCIICapture(const char *path);  // 실패하면 0
+void I_StopASCIICapture(void);
+int  I_ASCIICaptureActive(void);
+void I_CaptureASCIIPalette(const uint8_t *rgb);  // 캡처 전에도 불러 둘 것 (시작 시 첫 레코드)
+void I_CaptureASCIIPal8(const uint8_t *pixels, int width, int height);
+void I_CaptureASCIIRGBA(const uint32_t *pixels, int width, int height);
+uint32_t I_GetASCIICaptureFrames(void);
+
+// ---------- 읽기 (벤치마크) ----------
+typedef struct {
+    int type;                // ASCII_CORPUS_PAL8 | ASCII_CORPUS_RGBA32
+    int width, height;
+    const void *pixels;
+    const uint8_t *palette;  // 8비트 프레임에 적용되는 팔레트 (RGBA32는 NULL)
+} AsciiCorpusFrame;
+
+// 파일 전체를 메모리로 읽음 (max_frames > 0이면 앞에서부터 그만큼). 프레임 수, 실패하면 -1
+int  I_LoadASCIICorpus(const char *path, int max_frames);
+int  I_GetASCIICorpusFrame(int index, AsciiCorpusFrame *frame);
+void I_FreeASCIICorpus(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,408 @@
+#include "config.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#else
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+#if !defined(__EMSCRIPTEN__) && \
+    (defined(__x86_64__) || defined(_M_X64) || \
+     ((defined(__i386__) || defined(_M_IX86)) && defined(__SSE2__)))
+#define ASCII_X86_SIMD 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define ASCII_TARGET_AVX2  __attribute__((target("avx2")))
+#else
+#define ASCII_TARGET_AVX2
+#endif
+#endif
+
+#ifdef HAVE_LIBPNG
+#include <png.h>
+#endif
+
+#include "i_asciiraster.h"
+
+// textscreen 폰트 (txt_sdl.c와 같은 구조체로 읽음)
+typedef struct {
+    const char *name;
+    const uint8_t *data;
+    unsigned int w;
+    unsigned int h;
+} txt_font_t;
+
+#include "../textscreen/fonts/small.h"
+#include "../textscreen/fonts/normal.h"
+#include "../textscreen/fonts/large.h"
+
+static const txt_font_t* const raster_fonts[] = { &small_font, &normal_font, &large_font };
+// 램프 밖 문자(모양 글리프)도 그리도록 출력 가능한 ASCII 전체를 구움
+static constexpr int FIRST_GLYPH = 32;
+static constexpr int NUM_GLYPHS = 127 - FIRST_GLYPH;
+static constexpr uint32_t RASTER_ALPHA = 0xFF000000u;  // 바이트 순서 R,G,B,A의 A
+static constexpr uint32_t KEY_BLANK = 0xFFFFFFFFu;     // 공백: 색과 무관하게 검은 셀
+
+// ===== 아틀라스 =====
+// 글리프마다 fw * fh 픽셀 마스크 (켜진 픽셀 0x00FFFFFF, 꺼진 픽셀 0). 행 단위로 연속
+static int raster_font = ASCII_RASTER_FONT_NORMAL;
+static int cell_w = 0, cell_h = 0;
+static std::vector<uint32_t> atlas;
+static uint8_t glyph_slot[256];  // 문자 → 아틀라스 번호 (출력 불가 문자는 '@')
+
+static void bake_atlas(void) {
+    const txt_font_t* f = raster_fonts[raster_font];
+    cell_w = (int)f->w;
+    cell_h = (int)f->h;
+    const int n = cell_w * cell_h;
+    atlas.assign((size_t)NUM_GLYPHS * n, 0);
+
+    std::memset(glyph_slot, '@' - FIRST_GLYPH, sizeof(glyph_slot));
+    for (int g = 0; g < NUM_GLYPHS; ++g) {
+        const uint8_t ch = (uint8_t)(FIRST_GLYPH + g);
+        glyph_slot[ch] = (uint8_t)g;
+
+        // txt_sdl.c DrawChar와 같은 비트 순서: 글리프 시작 바이트부터 LSB 먼저, 행 사이 패딩 없음
+        const uint8_t* p = &f->data[(ch * f->w * f->h) / 8];
+        uint32_t* m = &atlas[(size_t)g * n];
+        for (int i = 0; i < n; ++i) {
+            m[i] = (p[i >> 3] & (1 << (i & 7))) ? 0x00FFFFFFu : 0;
+        }
+    }
+}
+
+// ===== 블릿 커널 =====
+// 셀 하나: out = (mask & fg) | A. cell_w는 4의 배수 (4/8/16)
+typedef void (*blit_fn)(uint32_t* dst, int pitch, const uint32_t* mask, uint32_t fg, int w, int h);
+
+static void blit_scalar(uint32_t* dst, int pitch, const uint32_t* mask, uint32_t fg, int w, int h) {
+    for (int y = 0; y < h; ++y, dst += pitch, mask += w) {
+        for (int x = 0; x < w; ++x) dst[x] = (mask[x] & fg) | RASTER_ALPHA;
+    }
+}
+
+static void fill_scalar(uint32_t* dst, int pitch, uint32_t v, int w, int h) {
+    for (int y = 0; y < h; ++y, dst += pitch) {
+        for (int x = 0; x < w; ++x) dst[x] = v;
+    }
+}
+
+#ifdef ASCII_X86_SIMD
+static void blit_sse2(uint32_t* dst, int pitch, const uint32_t* mask, uint32_t fg, int w, int h) {
+    const __m128i vfg = _mm_set1_epi32((int)fg);
+    const __m128i va  = _mm_set1_epi32((int)RASTER_ALPHA);
+    for (int y = 0; y < h; ++y, dst += pitch, mask += w) {
+        for (int x = 0; x < w; x += 4) {
+            const __m128i m = _mm_loadu_si128((const __m128i*)(mask + x));
+            _mm_storeu_si128((__m128i*)(dst + x), _mm_or_si128(_mm_and_si128(m, vfg), va));
+        }
+    }
+}
+
+ASCII_TARGET_AVX2
+static void blit_avx2(uint32_t* dst, int pitch, const uint32_t* mask, uint32_t fg, int w, int h) {
+    if (w & 7) {  // small 폰트(4픽셀)는 SSE2 폭
+        blit_sse2(dst, pitch, mask, fg, w, h);
+        return;
+    }
+    const __m256i vfg = _mm256_set1_epi32((int)fg);
+    const __m256i va  = _mm256_set1_epi32((int)RASTER_ALPHA);
+    for (int y = 0; y < h; ++y, dst += pitch, mask += w) {
+        for (int x = 0; x < w; x += 8) {
+            const __m256i m = _mm256_loadu_si256((const __m256i*)(mask + x));
+            _mm256_storeu_si256((__m256i*)(dst + x), _mm256_or_si256(_mm256_and_si256(m, vfg), va));
+        }
+    }
+}
+#endif
+
+#if defined(__wasm_simd128__)
+static void blit_wasm128(uint32_t* dst, int pitch, const uint32_t* mask, uint32_t fg, int w, int h) {
+    const v128_t vfg = wasm_i32x4_splat((int)fg);
+    const v128_t va  = wasm_i32x4_splat((int)RASTER_ALPHA);
+    for (int y = 0; y < h; ++y, dst += pitch, mask += w) {
+        for (int x = 0; x < w; x += 4) {
+            const v128_t m = wasm_v128_load(mask + x);
+            wasm_v128_store(dst + x, wasm_v128_or(wasm_v128_and(m, vfg), va));
+        }
+    }
+}
+#endif
+
+// 변환기의 SIMD 선택(토글/강제 지정 포함)을 그대로 따름
+static blit_fn select_blit(void) {
+    if (!ascii_get_simd()) return blit_scalar;
+    const char* k = ascii_get_simd_kernel();
+#ifdef ASCII_X86_SIMD
+    if (std::strcmp(k, "avx2") == 0) return blit_avx2;
+    if (std::strcmp(k, "scalar") != 0) return blit_sse2;
+#endif
+#if defined(__wasm_simd128__)
+    if (std::strcmp(k, "wasm-simd128") == 0) return blit_wasm128;
+#endif
+    (void)k;
+    return blit_scalar;
+}
+
+// ===== 이미지 =====
+static std::vector<uint32_t> image;       // 바이트 순서 R,G,B,A
+static std::vector<uint32_t> drawn_keys;  // 셀별로 그려 둔 (글리프, 색). KEY_BLANK = 공백
+static int image_grid_w = 0, image_grid_h = 0;
+static bool raster_valid = false;
+static int dirty_x0 = 0, dirty_y0 = 0, dirty_x1 = 0, dirty_y1 = 0;  // 셀 단위 [x0,x1) x [y0,y1)
+
+static inline uint32_t cell_key(const AsciiCell& c) {
+    if (c.character == ' ') return KEY_BLANK;
+    return ((uint32_t)glyph_slot[(uint8_t)c.character] << 24)
+         | c.r | ((uint32_t)c.g << 8) | ((uint32_t)c.b << 16);
+}
+
+void I_SetASCIIRasterFont(int font) {
+    if (font < ASCII_RASTER_FONT_SMALL || font > ASCII_RASTER_FONT_LARGE) return;
+    if (font == raster_font && !atlas.empty()) return;
+    raster_font = font;
+    atlas.clear();
+    raster_valid = false;
+}
+
+int I_GetASCIIRasterFont(void) { return raster_font; }
+int I_GetASCIIRasterCellWidth(void) { return (int)raster_fonts[raster_font]->w; }
+int I_GetASCIIRasterCellHeight(void) { return (int)raster_fonts[raster_font]->h; }
+
+void I_InvalidateASCIIRaster(void) {
+    raster_valid = false;
+}
+
+int I_RasterizeASCII(const AsciiCell *cells, int width, int height) {
+    if (!cells || width <= 0 || height <= 0) return 0;
+    if (atlas.empty()) bake_atlas();
+
+    if (!raster_valid || width != image_grid_w || height != image_grid_h
+     || image.size() != (size_t)width * cell_w * height * cell_h) {
+        const size_t cells_n = (size_t)width * height;
+        const size_t pixels = cells_n * cell_w * cell_h;
+        if (image.size() != pixels) {
+            std::vector<uint32_t>().swap(image);
+            image.resize(pixels);
+            if (image.size() != pixels) return -1;
+        }
+        drawn_keys.resize(cells_n);
+        image_grid_w = width;
+        image_grid_h = height;
+    }
+
+    const int pitch = width * cell_w;
+    const int glyph_px = cell_w * cell_h;
+    const blit_fn blit = select_blit();
+    const bool full = !raster_valid;
+    int x0 = width, y0 = height, x1 = 0, y1 = 0;
+    int redrawn = 0;
+
+    for (int cy = 0; cy < height; ++cy) {
+        const AsciiCell* row = cells + (size_t)cy * width;
+        uint32_t* keys = &drawn_keys[(size_t)cy * width];
+        uint32_t* dst_row = &image[(size_t)cy * cell_h * pitch];
+        for (int cx = 0; cx < width; ++cx) {
+            const uint32_t key = cell_key(row[cx]);
+            if (!full && keys[cx] == key) continue;
+            keys[cx] = key;
+
+            uint32_t* dst = dst_row + (size_t)cx * cell_w;
+            if (key == KEY_BLANK) {
+                fill_scalar(dst, pitch, RASTER_ALPHA, cell_w, cell_h);
+            } else {
+                const uint32_t fg = key & 0x00FFFFFFu;
+                blit(dst, pitch, &atlas[(size_t)(key >> 24) * glyph_px], fg, cell_w, cell_h);
+            }
+            redrawn++;
+            if (cx < x0) x0 = cx;
+            if (cx >= x1) x1 = cx + 1;
+            if (cy < y0) y0 = cy;
+            y1 = cy + 1;
+        }
+    }
+
+    raster_valid = true;
+    if (redrawn == 0) {
+        dirty_x0 = dirty_y0 = dirty_x1 = dirty_y1 = 0;
+    } else {
+        dirty_x0 = x0; dirty_y0 = y0; dirty_x1 = x1; dirty_y1 = y1;
+    }
+    return redrawn;
+}
+
+void I_ShutdownASCIIRaster(void) {
+    I_StopASCIIRasterY4M();
+    std::vector<uint32_t>().swap(image);
+    std::vector<uint32_t>().swap(drawn_keys);
+    std::vector<uint32_t>().swap(atlas);
+    image_grid_w = image_grid_h = 0;
+    raster_valid = false;
+}
+
+const uint8_t *I_GetASCIIRasterBuffer(void) {
+    return image.empty() ? nullptr : (const uint8_t*)image.data();
+}
+
+int I_GetASCIIRasterWidth(void) { return image.empty() ? 0 : image_grid_w * cell_w; }
+int I_GetASCIIRasterHeight(void) { return image.empty() ? 0 : image_grid_h * cell_h; }
+
+int I_GetASCIIRasterDirty(int *x, int *y, int *w, int *h) {
+    const int dw = (dirty_x1 - dirty_x0) * cell_w;
+    const int dh = (dirty_y1 - dirty_y0) * cell_h;
+    if (x) *x = dirty_x0 * cell_w;
+    if (y) *y = dirty_y0 * cell_h;
+    if (w) *w = dw;
+    if (h) *h = dh;
+    return dw > 0 && dh > 0;
+}
+
+// ===== PNG =====
+#ifdef HAVE_LIBPNG
+static void raster_png_error(png_structp p, png_const_charp s) {
+    (void)p;
+    printf("libpng error: %s\n", s);
+}
+
+static void raster_png_warning(png_structp p, png_const_charp s) {
+    (void)p;
+    printf("libpng warning: %s\n", s);
+}
+#endif
+
+int I_WriteASCIIRasterPNG(const char *path) {
+#ifdef HAVE_LIBPNG
+    if (image.empty()) return 0;
+    FILE* handle = fopen(path, "wb");
+    if (!handle) return 0;
+
+    png_structp ppng = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL,
+                                               raster_png_error, raster_png_warning);
+    if (!ppng) {
+        fclose(handle);
+        return 0;
+    }
+    png_infop pinfo = png_create_info_struct(ppng);
+    if (!pinfo) {
+        png_destroy_write_struct(&ppng, NULL);
+        fclose(handle);
+        return 0;
+    }
+
+    const int w = I_GetASCIIRasterWidth();
+    const int h = I_GetASCIIRasterHeight();
+    png_init_io(ppng, handle);
+    // 알파는 항상 불투명이라 RGB로 저장 (필러 바이트 버림)
+    png_set_IHDR(ppng, pinfo, w, h, 8, PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE,
+                 PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    png_write_info(ppng, pinfo);
+    png_set_filler(ppng, 0, PNG_FILLER_AFTER);
+
+    const uint8_t* src = (const uint8_t*)image.data();
+    for (int y = 0; y < h; ++y) {
+        png_write_row(ppng, (png_bytep)(src + (size_t)y * w * 4));
+    }
+    png_write_end(ppng, pinfo);
+    png_destroy_write_struct(&ppng, &pinfo);
+    fclose(handle);
+    return 1;
+#else
+    (void)path;
+    return 0;
+#endif
+}
+
+// ===== Y4M =====
+// 4:4:4 BT.601 제한 범위. 해상도가 바뀌면 새 헤더를 쓸 수 없으므로 녹화 중단
+static FILE* y4m_file = nullptr;
+static int   y4m_fps = 35;
+static int   y4m_w = 0, y4m_h = 0;
+static std::vector<uint8_t> y4m_planes;
+
+int I_StartASCIIRasterY4M(const char *path, int fps) {
+    I_StopASCIIRasterY4M();
+    y4m_file = fopen(path, "wb");
+    if (!y4m_file) return 0;
+    y4m_fps = fps > 0 ? fps : 35;
+    y4m_w = y4m_h = 0;
+    return 1;
+}
+
+void I_StopASCIIRasterY4M(void) {
+    if (!y4m_file) return;
+    fclose(y4m_file);
+    y4m_file = nullptr;
+    std::vector<uint8_t>().swap(y4m_planes);
+}
+
+int I_ASCIIRasterY4MActive(void) {
+    return y4m_file != nullptr;
+}
+
+int I_WriteASCIIRasterY4MFrame(void) {
+    if (!y4m_file || image.empty()) return 0;
+    const int w = I_GetASCIIRasterWidth();
+    const int h = I_GetASCIIRasterHeight();
+    if (y4m_w == 0) {
+        y4m_w = w;
+        y4m_h = h;
+        if (fprintf(y4m_file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", w, h, y4m_fps) < 0) {
+            I_StopASCIIRasterY4M();
+            return 0;
+        }
+    } else if (w != y4m_w || h != y4m_h) {
+        fprintf(stderr, "I_WriteASCIIRasterY4MFrame: size changed %dx%d -> %dx%d, recording stopped\n",
+                y4m_w, y4m_h, w, h);
+        I_StopASCIIRasterY4M();
+        return 0;
+    }
+
+    const size_t n = (size_t)w * h;
+    y4m_planes.resize(n * 3);
+    uint8_t* py = y4m_planes.data();
+    uint8_t* pu = py + n;
+    uint8_t* pv = pu + n;
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t p = image[i];
+        const int r = p & 0xff, g = (p >> 8) & 0xff, b = (p >> 16) & 0xff;
+        py[i] = (uint8_t)(16  + (( 66*r + 129*g +  25*b + 128) >> 8));
+        pu[i] = (uint8_t)(128 + ((-38*r -  74*g + 112*b + 128) >> 8));
+        pv[i] = (uint8_t)(128 + ((112*r -  94*g -  18*b + 128) >> 8));
+    }
+    if (fputs("FRAME\n", y4m_file) < 0
+     || fwrite(y4m_planes.data(), 1, y4m_planes.size(), y4m_file) != y4m_planes.size()) {
+        fprintf(stderr, "I_WriteASCIIRasterY4MFrame: write failed, recording stopped\n");
+        I_StopASCIIRasterY4M();
+        return 0;
+    }
+    return 1;
+}
+
+// ===== JS =====
+extern "C" {
+EMSCRIPTEN_KEEPALIVE int ascii_raster_cells(const AsciiCell* cells, int width, int height) {
+    return I_RasterizeASCII(cells, width, height);
+}
+EMSCRIPTEN_KEEPALIVE void ascii_set_raster_font(int font) { I_SetASCIIRasterFont(font); }
+EMSCRIPTEN_KEEPALIVE int ascii_get_raster_font(void) { return I_GetASCIIRasterFont(); }
+EMSCRIPTEN_KEEPALIVE int ascii_get_raster_cell_width(void) { return I_GetASCIIRasterCellWidth(); }
+EMSCRIPTEN_KEEPALIVE int ascii_get_raster_cell_height(void) { return I_GetASCIIRasterCellHeight(); }
+EMSCRIPTEN_KEEPALIVE void ascii_invalidate_raster(void) { I_InvalidateASCIIRaster(); }
+EMSCRIPTEN_KEEPALIVE const uint8_t* ascii_get_raster_buffer(void) { return I_GetASCIIRasterBuffer(); }
+EMSCRIPTEN_KEEPALIVE int ascii_get_raster_width(void) { return I_GetASCIIRasterWidth(); }
+EMSCRIPTEN_KEEPALIVE int ascii_get_raster_height(void) { return I_GetASCIIRasterHeight(); }
+EMSCRIPTEN_KEEPALIVE int ascii_get_raster_dirty_x(void) { return dirty_x0 * cell_w; }
+EMSCRIPTEN_KEEPALIVE int ascii_get_raster_dirty_y(void) { return dirty_y0 * cell_h; }
+EMSCRIPTEN_KEEPALIVE int ascii_get_raster_dirty_w(void) { return (dirty_x1 - dirty_x0) * cell_w; }
+EMSCRIPTEN_KEEPALIVE int ascii_get_raster_dirty_h(void) { return (dirty_y1 - dirty_y0) * cell_h; }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <stdint.h>
+
+#include "i_ascii.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 글리프 아틀라스 래스터라이저: AsciiCell 그리드 → RGBA 이미지
+// textscreen 비트맵 폰트(CP437)에서 문자 램프 글리프만 미리 구워 두고 셀마다 전경색으로 칠함
+// 직전 이미지와 비교해 바뀐 셀만 다시 그리고, 바뀐 픽셀 사각형을 알려 줌 (웹: putImageData 한 번)
+
+// 폰트 (셀 크기)
+#define ASCII_RASTER_FONT_SMALL  0  // 4x8
+#define ASCII_RASTER_FONT_NORMAL 1  // 8x16 (기본)
+#define ASCII_RASTER_FONT_LARGE  2  // 16x32
+
+void I_SetASCIIRasterFont(int font);  // 바꾸면 다음 래스터화는 전체 다시 그림
+int  I_GetASCIIRasterFont(void);
+int  I_GetASCIIRasterCellWidth(void);
+int  I_GetASCIIRasterCellHeight(void);
+
+// 그리드 → 이미지. 다시 그린 셀 수, 메모리 부족이면 -1
+int  I_RasterizeASCII(const AsciiCell *cells, int width, int height);
+void I_InvalidateASCIIRaster(void);   // 다음 래스터화는 전체 다시 그림
+void I_ShutdownASCIIRaster(void);
+
+// 이미지: 바이트 순서 R,G,B,A (캔버스 ImageData와 같음), 행 간격 = 가로 * 4
+const uint8_t *I_GetASCIIRasterBuffer(void);
+int  I_GetASCIIRasterWidth(void);
+int  I_GetASCIIRasterHeight(void);
+// 직전 래스터화에서 바뀐 픽셀 사각형. 바뀐 셀이 없으면 0
+int  I_GetASCIIRasterDirty(int *x, int *y, int *w, int *h);
+
+// 네이티브 출력
+int  I_WriteASCIIRasterPNG(const char *path);      // libpng 없으면 0
+int  I_StartASCIIRasterY4M(const char *path, int fps);
+int  I_WriteASCIIRasterY4MFrame(void);             // 현재 이미지를 한 프레임으로 (C444)
+void I_StopASCIIRasterY4M(void);
+int  I_ASCIIRasterY4MActive(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,477 @@
+#include "config.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#else
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+
+#include "i_ascii.h"
+#include "i_asciisession.h"
+
+static constexpr char     SESSION_MAGIC[8] = { 'A','S','C','I','I','R','E','C' };
+static constexpr char     SESSION_TAIL[8]  = { 'A','R','E','C','T','A','I','L' };
+static constexpr char     SESSION_INDEX[4] = { 'A','I','D','X' };
+static constexpr uint32_t SESSION_VERSION  = 1;
+static constexpr int      SESSION_HEADER_SIZE = 16;
+static constexpr int      SESSION_FRAME_HEADER_SIZE = 14;
+static constexpr int      SESSION_MAX_DIM  = 4096;  // 읽을 때 손상된 레코드 거르기
+
+struct SessionKey {
+    uint32_t frame;
+    uint32_t tic;
+    uint64_t offset;
+};
+
+static inline double session_now_ms(void) {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+static inline void put_u16(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8);
+}
+static inline void put_u32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+static inline void put_u64(uint8_t* p, uint64_t v) {
+    put_u32(p, (uint32_t)v); put_u32(p + 4, (uint32_t)(v >> 32));
+}
+static inline uint32_t get_u16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static inline uint32_t get_u32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+static inline uint64_t get_u64(const uint8_t* p) {
+    return get_u32(p) | ((uint64_t)get_u32(p + 4) << 32);
+}
+
+static inline uint8_t* put_varint(uint8_t* p, uint32_t v) {
+    while (v >= 0x80) { *p++ = (uint8_t)(v | 0x80); v >>= 7; }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+// 셀 = 4바이트 단어. memcpy로 읽고 쓰므로 XOR 결과의 바이트 순서는 셀 바이트 순서 그대로
+static inline uint32_t load_word(const AsciiCell* c) {
+    uint32_t w;
+    std::memcpy(&w, c, 4);
+    return w;
+}
+
+// ---------- 인코딩 ----------
+// ref가 없으면(키프레임) 왼쪽 셀이 기준. 0 단어 하나라도 리터럴을 끊음 (varint 2바이트 < 단어 4바이트)
+static inline uint32_t ref_word(const AsciiCell* cur, const AsciiCell* ref, int k) {
+    return ref ? load_word(ref + k) : (k ? load_word(cur + k - 1) : 0);
+}
+
+static uint8_t* encode_cells(uint8_t* p, const AsciiCell* cur, const AsciiCell* ref, int n) {
+    int i = 0;
+    while (i < n) {
+        int z = i;
+        if (ref) {
+            while (z + 2 <= n && std::memcmp(cur + z, ref + z, 8) == 0) z += 2;
+        }
+        while (z < n && load_word(cur + z) == ref_word(cur, ref, z)) ++z;
+        int end = z;
+        while (end < n && load_word(cur + end) != ref_word(cur, ref, end)) ++end;
+        p = put_varint(p, (uint32_t)(z - i));
+        p = put_varint(p, (uint32_t)(end - z));
+        for (int k = z; k < end; ++k) {
+            const uint32_t x = load_word(cur + k) ^ ref_word(cur, ref, k);
+            std::memcpy(p, &x, 4);
+            p += 4;
+        }
+        i = end;
+    }
+    return p;
+}
+
+// ---------- 디코딩 ----------
+static inline bool get_varint(const uint8_t*& p, const uint8_t* end, uint32_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (p >= end) return false;
+        const uint8_t b = *p++;
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+// 키프레임이면 cells를 새로 채우고, 델타면 cells(직전 프레임) 위에 적용
+static bool decode_cells(const uint8_t* p, const uint8_t* end, AsciiCell* cells, int n, bool key) {
+    int i = 0;
+    while (i < n) {
+        uint32_t zeros, lits;
+        if (!get_varint(p, end, zeros) || !get_varint(p, end, lits)) return false;
+        if (zeros > (uint32_t)(n - i) || lits > (uint32_t)(n - i) - zeros) return false;
+        if ((size_t)(end - p) < (size_t)lits * 4) return false;
+        if (key) {
+            uint32_t left = i ? load_word(cells + i - 1) : 0;
+            for (uint32_t k = 0; k < zeros; ++k) std::memcpy(cells + i + k, &left, 4);
+        }
+        i += (int)zeros;
+        for (uint32_t k = 0; k < lits; ++k, ++i, p += 4) {
+            uint32_t x;
+            std::memcpy(&x, p, 4);
+            x ^= key ? (i ? load_word(cells + i - 1) : 0) : load_word(cells + i);
+            std::memcpy(cells + i, &x, 4);
+        }
+    }
+    return p == end;
+}
+
+// ===== 녹화 =====
+static FILE*    rec_file = nullptr;
+static int      rec_interval = ASCII_SESSION_KEY_INTERVAL;
+static uint32_t rec_since_key = 0;
+static uint32_t rec_last_tic = 0;
+static std::vector<AsciiCell>  rec_prev;   // 델타 기준
+static int      rec_w = 0, rec_h = 0;
+static std::vector<uint8_t>    rec_buf;    // 프레임 하나 (최악 크기로 잡아 둠)
+static std::vector<SessionKey> rec_keys;
+static AsciiSessionStats rec_stats;
+
+static void session_failed(void) {
+    fprintf(stderr, "I_WriteASCIISessionFrame: write failed, recording stopped after %u frames\n",
+            rec_stats.frames);
+    fclose(rec_file);
+    rec_file = nullptr;
+}
+
+int I_StartASCIISession(const char *path, int key_interval) {
+    I_StopASCIISession();
+    rec_file = fopen(path, "wb");
+    if (!rec_file) return 0;
+
+    rec_interval = key_interval > 0 ? key_interval : ASCII_SESSION_KEY_INTERVAL;
+    uint8_t h[SESSION_HEADER_SIZE];
+    std::memcpy(h, SESSION_MAGIC, 8);
+    put_u32(h + 8, SESSION_VERSION);
+    put_u32(h + 12, (uint32_t)rec_interval);
+    if (fwrite(h, 1, sizeof(h), rec_file) != sizeof(h)) {
+        fclose(rec_file);
+        rec_file = nullptr;
+        return 0;
+    }
+    std::memset(&rec_stats, 0, sizeof(rec_stats));
+    rec_stats.bytes = sizeof(h);
+    rec_keys.clear();
+    rec_w = rec_h = 0;
+    rec_since_key = 0;
+    return 1;
+}
+
+void I_WriteASCIISessionFrame(const AsciiCell *cells, int width, int height, int tic) {
+    if (!rec_file || !cells || width <= 0 || height <= 0) return;
+    if (width > SESSION_MAX_DIM || height > SESSION_MAX_DIM) return;
+    const double t0 = session_now_ms();
+
+    const int n = width * height;
+    const bool key = width != rec_w || height != rec_h || rec_since_key >= (uint32_t)rec_interval;
+    // 최악: 셀마다 {0, 1, 단어} = 1 + 1 + 4바이트 (varint는 셀 수 한도 안에서 최대 3바이트)
+    const size_t worst = SESSION_FRAME_HEADER_SIZE + (size_t)n * 6 + 16;
+    if (rec_buf.size() < worst) rec_buf.resize(worst);
+
+    uint8_t* p = rec_buf.data();
+    uint8_t* body = p + SESSION_FRAME_HEADER_SIZE;
+    uint8_t* end = encode_cells(body, cells, key ? nullptr : rec_prev.data(), n);
+    p[0] = (uint8_t)(key ? 'K' : 'D');
+    p[1] = 0;
+    put_u16(p + 2, (uint32_t)width);
+    put_u16(p + 4, (uint32_t)height);
+    put_u32(p + 6, (uint32_t)tic);
+    put_u32(p + 10, (uint32_t)(end - body));
+
+    const size_t size = (size_t)(end - p);
+    if (key) rec_keys.push_back({ rec_stats.frames, (uint32_t)tic, rec_stats.bytes });
+    if (fwrite(p, 1, size, rec_file) != size) {
+        session_failed();
+        return;
+    }
+    if (key) {
+        rec_prev.assign(cells, cells + n);
+        rec_w = width;
+        rec_h = height;
+        rec_since_key = 0;
+        rec_stats.keyframes++;
+    } else {
+        std::memcpy(rec_prev.data(), cells, sizeof(AsciiCell) * (size_t)n);
+    }
+    rec_since_key++;
+    rec_last_tic = (uint32_t)tic;
+    rec_stats.frames++;
+    rec_stats.bytes += size;
+    rec_stats.encode_ms += session_now_ms() - t0;
+}
+
+void I_StopASCIISession(void) {
+    if (!rec_file) return;
+
+    // 색인 + 꼬리
+    std::vector<uint8_t> idx(16 + rec_keys.size() * 16 + 16);
+    uint8_t* p = idx.data();
+    std::memcpy(p, SESSION_INDEX, 4);
+    put_u32(p + 4, (uint32_t)rec_keys.size());
+    put_u32(p + 8, rec_stats.frames);
+    put_u32(p + 12, rec_last_tic);
+    p += 16;
+    for (const SessionKey& k : rec_keys) {
+        put_u32(p, k.frame);
+        put_u32(p + 4, k.tic);
+        put_u64(p + 8, k.offset);
+        p += 16;
+    }
+    put_u64(p, rec_stats.bytes);
+    std::memcpy(p + 8, SESSION_TAIL, 8);
+    if (fwrite(idx.data(), 1, idx.size(), rec_file) != idx.size()) {
+        fprintf(stderr, "I_StopASCIISession: failed to write the frame index\n");
+    }
+    fclose(rec_file);
+    rec_file = nullptr;
+
+    std::vector<AsciiCell>().swap(rec_prev);
+    std::vector<uint8_t>().swap(rec_buf);
+    std::vector<SessionKey>().swap(rec_keys);
+    rec_w = rec_h = 0;
+}
+
+int I_ASCIISessionActive(void) {
+    return rec_file != nullptr;
+}
+
+void I_GetASCIISessionStats(AsciiSessionStats *stats) {
+    *stats = rec_stats;
+}
+
+// ===== 재생 =====
+static FILE*    play_file = nullptr;
+static std::vector<SessionKey> play_keys;
+static uint32_t play_frames = 0;
+static uint32_t play_last_tic = 0;
+static uint64_t play_end = 0;       // 프레임 영역 끝 (색인 위치 또는 마지막 온전한 프레임 뒤)
+static uint64_t play_next = 0;      // 다음 프레임 위치
+static int      play_frame = -1;    // 현재 프레임 번호
+static std::vector<AsciiCell> play_cells;
+static int      play_w = 0, play_h = 0;
+static uint32_t play_tic = 0;
+static std::vector<uint8_t> play_buf;
+
+static bool seek_file(uint64_t offset) {
+#if defined(_WIN32)
+    return _fseeki64(play_file, (long long)offset, SEEK_SET) == 0;
+#else
+    return fseeko(play_file, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+static bool read_frame_header(uint8_t h[SESSION_FRAME_HEADER_SIZE]) {
+    if (fread(h, 1, SESSION_FRAME_HEADER_SIZE, play_file) != SESSION_FRAME_HEADER_SIZE) return false;
+    const int w = (int)get_u16(h + 2), ht = (int)get_u16(h + 4);
+    return (h[0] == 'K' || h[0] == 'D') && w > 0 && ht > 0
+        && w <= SESSION_MAX_DIM && ht <= SESSION_MAX_DIM;
+}
+
+// play_next의 프레임을 읽어 현재 프레임으로. 키프레임이 아닌데 기준이 없으면 실패
+static bool read_frame(void) {
+    if (play_next >= play_end || !seek_file(play_next)) return false;
+    uint8_t h[SESSION_FRAME_HEADER_SIZE];
+    if (!read_frame_header(h)) return false;
+    const bool key = h[0] == 'K';
+    const int w = (int)get_u16(h + 2), ht = (int)get_u16(h + 4);
+    const uint32_t size = get_u32(h + 10);
+    if (play_next + SESSION_FRAME_HEADER_SIZE + size > play_end) return false;
+    if (!key && (play_frame < 0 || w != play_w || ht != play_h)) return false;
+
+    play_buf.resize(size);
+    if (size && fread(play_buf.data(), 1, size, play_file) != size) return false;
+    if (key) {
+        play_cells.resize((size_t)w * ht);
+        play_w = w;
+        play_h = ht;
+    }
+    if (!decode_cells(play_buf.data(), play_buf.data() + size, play_cells.data(), w * ht, key)) {
+        return false;
+    }
+    play_tic = get_u32(h + 6);
+    play_next += SESSION_FRAME_HEADER_SIZE + size;
+    play_frame++;
+    return true;
+}
+
+// 꼬리/색인 읽기. 없거나 깨졌으면 false
+static bool load_index(uint64_t file_size) {
+    if (file_size < SESSION_HEADER_SIZE + 32) return false;
+    uint8_t tail[16];
+    if (!seek_file(file_size - 16) || fread(tail, 1, 16, play_file) != 16) return false;
+    if (std::memcmp(tail + 8, SESSION_TAIL, 8) != 0) return false;
+    const uint64_t at = get_u64(tail);
+    if (at < SESSION_HEADER_SIZE || at + 16 > file_size - 16) return false;
+
+    uint8_t h[16];
+    if (!seek_file(at) || fread(h, 1, 16, play_file) != 16) return false;
+    if (std::memcmp(h, SESSION_INDEX, 4) != 0) return false;
+    const uint32_t count = get_u32(h + 4);
+    if (at + 16 + (uint64_t)count * 16 != file_size - 16) return false;
+
+    std::vector<uint8_t> raw((size_t)count * 16);
+    if (count && fread(raw.data(), 1, raw.size(), play_file) != raw.size()) return false;
+    play_keys.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint8_t* e = raw.data() + (size_t)i * 16;
+        play_keys[i] = { get_u32(e), get_u32(e + 4), get_u64(e + 8) };
+    }
+    play_frames = get_u32(h + 8);
+    play_last_tic = get_u32(h + 12);
+    play_end = at;
+    return true;
+}
+
+// 색인이 없으면 프레임 헤더만 훑어서 만듦 (마지막 온전한 프레임까지)
+static void scan_index(uint64_t file_size) {
+    play_keys.clear();
+    play_frames = 0;
+    uint64_t at = SESSION_HEADER_SIZE;
+    uint8_t h[SESSION_FRAME_HEADER_SIZE];
+    while (seek_file(at) && read_frame_header(h)) {
+        const uint64_t next = at + SESSION_FRAME_HEADER_SIZE + get_u32(h + 10);
+        if (next > file_size) break;
+        if (h[0] == 'K') play_keys.push_back({ play_frames, get_u32(h + 6), at });
+        play_last_tic = get_u32(h + 6);
+        play_frames++;
+        at = next;
+    }
+    play_end = at;
+}
+
+int I_OpenASCIIReplay(const char *path) {
+    I_CloseASCIIReplay();
+    play_file = fopen(path, "rb");
+    if (!play_file) return -1;
+
+    uint8_t h[SESSION_HEADER_SIZE];
+    if (fread(h, 1, sizeof(h), play_file) != sizeof(h)
+     || std::memcmp(h, SESSION_MAGIC, 8) != 0 || get_u32(h + 8) != SESSION_VERSION
+     || fseek(play_file, 0, SEEK_END) != 0) {
+        I_CloseASCIIReplay();
+        return -1;
+    }
+#if defined(_WIN32)
+    const uint64_t file_size = (uint64_t)_ftelli64(play_file);
+#else
+    const uint64_t file_size = (uint64_t)ftello(play_file);
+#endif
+    if (!load_index(file_size)) scan_index(file_size);
+
+    play_next = SESSION_HEADER_SIZE;
+    play_frame = -1;
+    if (play_keys.empty() || !read_frame()) {
+        I_CloseASCIIReplay();
+        return -1;
+    }
+    return (int)play_frames;
+}
+
+void I_CloseASCIIReplay(void) {
+    if (play_file) fclose(play_file);
+    play_file = nullptr;
+    std::vector<SessionKey>().swap(play_keys);
+    std::vector<AsciiCell>().swap(play_cells);
+    std::vector<uint8_t>().swap(play_buf);
+    play_frames = 0;
+    play_frame = -1;
+    play_w = play_h = 0;
+}
+
+int I_GetASCIIReplayFrameCount(void) {
+    return (int)play_frames;
+}
+
+int I_GetASCIIReplayFirstTic(void) {
+    return play_keys.empty() ? 0 : (int)play_keys[0].tic;
+}
+
+int I_GetASCIIReplayLastTic(void) {
+    return (int)play_last_tic;
+}
+
+int I_NextASCIIReplayFrame(void) {
+    return play_file && read_frame() ? 1 : 0;
+}
+
+int I_SeekASCIIReplay(int tic) {
+    if (!play_file || play_keys.empty()) return 0;
+    const uint32_t target = (uint32_t)std::max(tic, 0);
+
+    // tic 이하인 마지막 키프레임 (첫 키프레임보다 앞이면 첫 키프레임)
+    auto it = std::upper_bound(play_keys.begin(), play_keys.end(), target,
+                               [](uint32_t t, const SessionKey& k) { return t < k.tic; });
+    const SessionKey& k = it == play_keys.begin() ? *it : *(it - 1);
+
+    // 지금 위치가 그 키프레임과 목표 사이면 이어서 감
+    if (play_frame < 0 || (uint32_t)play_frame < k.frame || play_tic > target) {
+        play_next = k.offset;
+        play_frame = (int)k.frame - 1;
+        if (!read_frame()) return 0;
+    }
+
+    // 다음 프레임 tic이 목표를 넘지 않는 동안 진행 (헤더만 먼저 봄)
+    uint8_t h[SESSION_FRAME_HEADER_SIZE];
+    while (play_next < play_end && seek_file(play_next) && read_frame_header(h)
+        && get_u32(h + 6) <= target) {
+        if (!read_frame()) return 0;
+    }
+    return 1;
+}
+
+const AsciiCell *I_GetASCIIReplayCells(void) {
+    return play_cells.empty() ? nullptr : play_cells.data();
+}
+
+int I_GetASCIIReplayWidth(void) {
+    return play_w;
+}
+
+int I_GetASCIIReplayHeight(void) {
+    return play_h;
+}
+
+int I_GetASCIIReplayTic(void) {
+    return (int)play_tic;
+}
+
+int I_GetASCIIReplayFrame(void) {
+    return play_frame;
+}
+
+// ===== JS =====
+// 브라우저: 녹화는 MEMFS 파일로 쓰고 멈춘 뒤 FS.readFile로 내려받음, 재생은 FS.writeFile한 파일을 엶
+extern "C" {
+EMSCRIPTEN_KEEPALIVE int ascii_session_start(const char* path, int key_interval) {
+    return I_StartASCIISession(path, key_interval);
+}
+EMSCRIPTEN_KEEPALIVE void ascii_session_stop(void) { I_StopASCIISession(); }
+EMSCRIPTEN_KEEPALIVE int ascii_session_active(void) { return I_ASCIISessionActive(); }
+EMSCRIPTEN_KEEPALIVE uint32_t ascii_session_frames(void) { return rec_stats.frames; }
+EMSCRIPTEN_KEEPALIVE double ascii_session_bytes(void) { return (double)rec_stats.bytes; }
+EMSCRIPTEN_KEEPALIVE double ascii_session_encode_ms(void) { return rec_stats.encode_ms; }
+EMSCRIPTEN_KEEPALIVE int ascii_replay_open(const char* path) { return I_OpenASCIIReplay(path); }
+EMSCRIPTEN_KEEPALIVE void ascii_replay_close(void) { I_CloseASCIIReplay(); }
+EMSCRIPTEN_KEEPALIVE int ascii_replay_next(void) { return I_NextASCIIReplayFrame(); }
+EMSCRIPTEN_KEEPALIVE int ascii_replay_seek(int tic) { return I_SeekASCIIReplay(tic); }
+EMSCRIPTEN_KEEPALIVE const AsciiCell* ascii_replay_cells(void) { return I_GetASCIIReplayCells(); }
+EMSCRIPTEN_KEEPALIVE int ascii_replay_width(void) { return play_w; }
+EMSCRIPTEN_KEEPALIVE int ascii_replay_height(void) { return play_h; }
+EMSCRIPTEN_KEEPALIVE int ascii_replay_tic(void) { return (int)play_tic; }
+EMSCRIPTEN_KEEPALIVE int ascii_replay_frame(void) { return play_frame; }
+EMSCRIPTEN_KEEPALIVE int ascii_replay_first_tic(void) { return I_GetASCIIReplayFirstTic(); }
+EMSCRIPTEN_KEEPALIVE int ascii_replay_last_tic(void) { return (int)play_last_tic; }
+}
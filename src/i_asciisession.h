@@ -0,0 +1,62 @@
+#pragma once
+#include <stdint.h>
+
+#include "i_ascii.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ASCII 세션 녹화/재생: 변환된 AsciiCell 그리드를 tic과 함께 파일로 저장하고 아무 tic으로나 빠르게 이동
+// 캔버스 화면 녹화 대신 사용. 같은 프레임(변환 생략)은 기록하지 않으므로 재생은 tic으로 시간을 맞춤
+//
+// 파일 형식 (리틀 엔디언):
+//   헤더   "ASCIIREC" + uint32 버전(1) + uint32 키프레임 간격
+//   프레임 uint8 종류 + uint8 0 + uint16 가로 + uint16 세로 + uint32 tic + uint32 본문 바이트 + 본문
+//     본문은 셀(4바이트 단어) XOR 스트림: {varint 0 단어 수, varint 리터럴 수, 리터럴 * 4바이트} 반복
+//     'K' 키프레임  기준 = 왼쪽 셀 (첫 셀은 0) → 같은 셀이 이어지면 0 단어
+//     'D' 델타      기준 = 직전 프레임 같은 위치 → 안 바뀐 셀이 0 단어
+//   색인   "AIDX" + uint32 키프레임 수 + uint32 전체 프레임 수 + uint32 마지막 tic
+//          + 키프레임마다 {uint32 프레임 번호, uint32 tic, uint64 파일 위치}
+//   꼬리   uint64 색인 위치 + "ARECTAIL"
+// 꼬리가 없으면(녹화 중 종료) 열 때 프레임을 훑어 색인을 다시 만듦
+
+#define ASCII_SESSION_KEY_INTERVAL 70  // 기본 키프레임 간격 (프레임, 35fps 기준 2초)
+
+// ---------- 녹화 ----------
+int  I_StartASCIISession(const char *path, int key_interval);  // 0이면 기본 간격. 실패하면 0
+void I_WriteASCIISessionFrame(const AsciiCell *cells, int width, int height, int tic);
+void I_StopASCIISession(void);   // 색인/꼬리를 쓰고 닫음
+int  I_ASCIISessionActive(void);
+
+typedef struct {
+    uint32_t frames;
+    uint32_t keyframes;
+    uint64_t bytes;       // 파일 크기 (헤더 포함, 색인 제외)
+    double   encode_ms;   // 누적 인코딩 + 쓰기 시간
+} AsciiSessionStats;
+
+void I_GetASCIISessionStats(AsciiSessionStats *stats);
+
+// ---------- 재생 ----------
+int  I_OpenASCIIReplay(const char *path);  // 프레임 수, 실패하면 -1. 첫 프레임이 현재 프레임
+void I_CloseASCIIReplay(void);
+int  I_GetASCIIReplayFrameCount(void);
+int  I_GetASCIIReplayFirstTic(void);
+int  I_GetASCIIReplayLastTic(void);
+
+// 다음 프레임으로. 끝이면 0
+int  I_NextASCIIReplayFrame(void);
+// tic 이하인 마지막 프레임으로 (가장 가까운 앞 키프레임부터 델타 적용). 실패하면 0
+int  I_SeekASCIIReplay(int tic);
+
+// 현재 프레임 (다음 Next/Seek까지 유효)
+const AsciiCell *I_GetASCIIReplayCells(void);
+int  I_GetASCIIReplayWidth(void);
+int  I_GetASCIIReplayHeight(void);
+int  I_GetASCIIReplayTic(void);
+int  I_GetASCIIReplayFrame(void);  // 0부터
+
+#ifdef __cplusplus
+}
+#endif
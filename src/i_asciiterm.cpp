@@ -0,0 +1,413 @@
+#include "config.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+// 터미널 출력은 POSIX write()/ioctl 기반 (Emscripten/Windows는 초기화 실패로 처리)
+#if !defined(__EMSCRIPTEN__) && !defined(_WIN32)
+#define ASCII_HAVE_TERM 1
+#include <cerrno>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#endif
+
+#include "i_ascii.h"
+#include "i_asciiterm.h"
+
+// ===== 상태 =====
+static bool term_active = false;
+static int  term_fd = -1;
+static int  term_mode = ASCII_TERM_TRUECOLOR;
+static int  term_budget = 0;   // 프레임당 바이트 상한 (0: 무제한)
+static int  term_quant_target = ASCII_QUANT_XTERM256;  // 256/16색 양자화 대상
+static uint8_t* term_quant = nullptr;       // 프레임 셀별 색 번호
+static int term_quant_capacity = 0;
+
+// 화면에 보이는 셀 키: (색 << 8) | 문자. 공백은 색과 무관하게 ' '
+// (색 = truecolor면 0xRRGGBB, 256/16색이면 팔레트 번호)
+// 하위 셀 출력이면 (코드포인트 << 48) | (전경 << 24) | 배경, 공백은 전경 0
+static uint64_t* shown = nullptr;
+static int shown_w = 0, shown_h = 0;
+static bool shown_wide = false;  // shown이 하위 셀 키인지 (바뀌면 화면을 지우고 다시 그림)
+
+// 출력 버퍼 (크기 바뀔 때만 재할당)
+static char*  out_buf = nullptr;
+static size_t out_capacity = 0;
+
+// 커서/SGR 추적 (-1: 모름 → 절대 위치 이동)
+static int cur_x = -1, cur_y = -1;
+static int64_t cur_color = -1;
+static int64_t cur_bg = -1;  // 하위 셀 출력만 배경색을 씀
+
+// 측정
+static uint32_t last_bytes = 0;
+static uint64_t total_bytes = 0;
+static uint64_t total_syscalls = 0;
+static uint64_t total_frames = 0;
+
+// 셀 하나의 최대 바이트: 커서 이동(ESC[yyyy;xxxxH) + SGR(ESC[38;2;255;255;255m) + 문자
+static constexpr int TERM_MAX_CELL_BYTES = 12 + 19 + 1;
+// 하위 셀: 커서 이동 + SGR(ESC[38;2;255;255;255;48;2;255;255;255m) + UTF-8 3바이트
+static constexpr int TERM_MAX_WIDE_CELL_BYTES = 12 + 36 + 3;
+static constexpr int TERM_MAX_MERGE_GAP = 3;  // 이 폭 이하의 안 바뀐 틈은 커서 이동 대신 다시 씀
+
+// ---------- 색 양자화 ----------
+// 256/16색은 변환기의 큐브 양자화기 (I_QuantizeASCIIColor). 프레임 셀은 한꺼번에 양자화
+static inline uint32_t term_color(uint8_t r, uint8_t g, uint8_t b) {
+    if (term_mode != ASCII_TERM_TRUECOLOR) return (uint32_t)I_QuantizeASCIIColor(term_quant_target, r, g, b);
+    return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+}
+
+static inline uint32_t cell_key(const AsciiCell& c, uint32_t color) {
+    const uint8_t ch = (uint8_t)c.character;
+    if (ch == ' ' || ch == 0) return ' ';
+    return (color << 8) | ch;
+}
+
+static inline uint64_t wide_key(const AsciiWideCell& c) {
+    const uint64_t bg = term_color(c.bg_r, c.bg_g, c.bg_b);
+    if (c.codepoint == ' ') return ((uint64_t)' ' << 48) | bg;
+    return ((uint64_t)c.codepoint << 48) | ((uint64_t)term_color(c.fg_r, c.fg_g, c.fg_b) << 24) | bg;
+}
+
+// ---------- 이스케이프 작성 ----------
+static inline int digits(int v) {
+    return v < 10 ? 1 : v < 100 ? 2 : v < 1000 ? 3 : 4;
+}
+
+static inline void put_uint(char*& p, int v) {
+    char tmp[10];
+    int n = 0;
+    do { tmp[n++] = (char)('0' + v % 10); v /= 10; } while (v);
+    while (n) *p++ = tmp[--n];
+}
+
+// ESC [ n X (n == 1이면 생략)
+static inline void put_csi(char*& p, int n, char final) {
+    *p++ = '\x1b'; *p++ = '[';
+    if (n != 1) put_uint(p, n);
+    *p++ = final;
+}
+
+static inline int csi_cost(int n) { return 3 + (n != 1 ? digits(n) : 0); }
+
+// SGR 색 인자 (ESC [ 와 m 제외). 배경은 전경 코드 + 10
+static void put_color_params(char*& p, uint32_t color, bool background) {
+    switch (term_mode) {
+    case ASCII_TERM_256:
+        std::memcpy(p, background ? "48;5;" : "38;5;", 5); p += 5;
+        put_uint(p, (int)color);
+        break;
+    case ASCII_TERM_16:
+        put_uint(p, (color < 8 ? 30 + (int)color : 90 + (int)color - 8) + (background ? 10 : 0));
+        break;
+    default:
+        std::memcpy(p, background ? "48;2;" : "38;2;", 5); p += 5;
+        put_uint(p, (int)(color >> 16)); *p++ = ';';
+        put_uint(p, (int)((color >> 8) & 0xFF)); *p++ = ';';
+        put_uint(p, (int)(color & 0xFF));
+        break;
+    }
+}
+
+static void put_sgr(char*& p, uint32_t color) {
+    *p++ = '\x1b'; *p++ = '[';
+    put_color_params(p, color, false);
+    *p++ = 'm';
+}
+
+static inline void put_utf8(char*& p, uint32_t cp) {
+    if (cp < 0x80) {
+        *p++ = (char)cp;
+    } else if (cp < 0x800) {
+        *p++ = (char)(0xC0 | (cp >> 6));
+        *p++ = (char)(0x80 | (cp & 0x3F));
+    } else {
+        *p++ = (char)(0xE0 | (cp >> 12));
+        *p++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+        *p++ = (char)(0x80 | (cp & 0x3F));
+    }
+}
+
+// 커서를 (x, y)로: 상대 이동(CUU/CUD/CUF/CUB, CR) 중 가장 짧은 것, 더 짧으면 절대 위치(CUP)
+static void move_cursor(char*& p, int x, int y) {
+    if (cur_x == x && cur_y == y) return;
+
+    const int cup = 4 + digits(y + 1) + digits(x + 1);
+    if (cur_y >= 0) {
+        // 열을 모르면(마지막 열 직후) CR 경로만 가능
+        const int dy = y - cur_y, dx = x - cur_x;
+        const int vert = dy == 0 ? 0 : csi_cost(std::abs(dy));
+        const int rel = cur_x < 0 ? 1 << 30 : vert + (dx == 0 ? 0 : csi_cost(std::abs(dx)));
+        const int cr  = vert + 1 + (x == 0 ? 0 : csi_cost(x));
+        if (std::min(rel, cr) <= cup) {
+            if (dy) put_csi(p, std::abs(dy), dy > 0 ? 'B' : 'A');
+            if (cr < rel) {
+                *p++ = '\r';
+                if (x) put_csi(p, x, 'C');
+            } else if (dx) {
+                put_csi(p, std::abs(dx), dx > 0 ? 'C' : 'D');
+            }
+            cur_x = x; cur_y = y;
+            return;
+        }
+    }
+    *p++ = '\x1b'; *p++ = '[';
+    put_uint(p, y + 1); *p++ = ';';
+    put_uint(p, x + 1); *p++ = 'H';
+    cur_x = x; cur_y = y;
+}
+
+// ---------- 출력 ----------
+// 버퍼 전체를 내보냄 (부분 쓰기/EINTR이면 이어서, 호출 수는 모두 셈)
+static void term_write(const char* data, size_t n) {
+#ifdef ASCII_HAVE_TERM
+    size_t off = 0;
+    while (off < n) {
+        const ssize_t r = write(term_fd, data + off, n - off);
+        ++total_syscalls;
+        if (r < 0) {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            term_active = false;  // 터미널이 사라짐 (SSH 끊김 등)
+            return;
+        }
+        off += (size_t)r;
+    }
+#else
+    (void)data; (void)n;
+#endif
+}
+
+// 크기/셀 종류가 바뀌었거나 무효화됐으면 버퍼를 다시 잡고 화면 지우기 시퀀스를 p에 씀
+// 하위 셀은 배경색이 터미널 기본값과 같다는 보장이 없으므로 처음에 모든 셀을 그림
+static void ensure_term_buffers(int width, int height, bool wide, char*& p) {
+    if (shown && shown_w == width && shown_h == height && shown_wide == wide) return;
+
+    const size_t cells = (size_t)width * height;
+    free(shown);
+    shown = (uint64_t*)malloc(sizeof(uint64_t) * cells);
+    std::fill(shown, shown + cells, wide ? ~(uint64_t)0 : (uint64_t)' ');
+    shown_w = width;
+    shown_h = height;
+    shown_wide = wide;
+
+    const size_t need = cells * (wide ? TERM_MAX_WIDE_CELL_BYTES : TERM_MAX_CELL_BYTES) + 64;
+    if (out_capacity < need) {
+        free(out_buf);
+        out_buf = (char*)malloc(need);
+        out_capacity = need;
+    }
+    p = out_buf;
+
+    // 화면을 지우고 공백 상태에서 다시 시작
+    static const char clear[] = "\x1b[0m\x1b[2J";
+    std::memcpy(p, clear, sizeof(clear) - 1);
+    p += sizeof(clear) - 1;
+    cur_x = cur_y = -1;
+    cur_color = -1;
+    cur_bg = -1;
+}
+
+// ---------- API ----------
+int I_InitASCIITerm(int color_mode) {
+#ifdef ASCII_HAVE_TERM
+    if (term_active) return 1;
+    if (!isatty(STDOUT_FILENO)) return 0;
+
+    term_fd = STDOUT_FILENO;
+    term_mode = (color_mode == ASCII_TERM_256 || color_mode == ASCII_TERM_16)
+              ? color_mode : ASCII_TERM_TRUECOLOR;
+    term_quant_target = term_mode == ASCII_TERM_16 ? ASCII_QUANT_ANSI16 : ASCII_QUANT_XTERM256;
+    if (term_mode != ASCII_TERM_TRUECOLOR && !I_InitASCIIQuant(term_quant_target)) {
+        term_mode = ASCII_TERM_TRUECOLOR;
+    }
+    term_active = true;
+    last_bytes = 0;
+    total_bytes = total_syscalls = total_frames = 0;
+
+    // 대체 화면, 커서 숨김, 자동 줄바꿈 끔 (마지막 열 쓰기에서 스크롤되지 않도록)
+    fflush(stdout);
+    static const char enter[] = "\x1b[?1049h\x1b[?25l\x1b[?7l";
+    term_write(enter, sizeof(enter) - 1);
+    free(shown); shown = nullptr;
+    return term_active ? 1 : 0;
+#else
+    (void)color_mode;
+    return 0;
+#endif
+}
+
+void I_ShutdownASCIITerm(void) {
+    if (term_fd < 0) return;
+
+    static const char leave[] = "\x1b[0m\x1b[?7h\x1b[?25h\x1b[?1049l";
+    term_write(leave, sizeof(leave) - 1);
+    term_active = false;
+    term_fd = -1;
+
+    if (total_frames > 0) {
+        printf("I_ShutdownASCIITerm: %llu frames, %.0f bytes/frame, "
+               "%.2f write() calls/frame\n",
+               (unsigned long long)total_frames,
+               I_GetASCIITermBytesPerFrame(), I_GetASCIITermSyscallsPerFrame());
+    }
+
+    free(shown); shown = nullptr; shown_w = shown_h = 0;
+    free(out_buf); out_buf = nullptr; out_capacity = 0;
+    free(term_quant); term_quant = nullptr; term_quant_capacity = 0;
+}
+
+int I_ASCIITermActive(void) {
+    return term_active ? 1 : 0;
+}
+
+int I_GetASCIITermSize(int *width, int *height) {
+#ifdef ASCII_HAVE_TERM
+    struct winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_col > 0 && ws.ws_row > 0) {
+        *width = ws.ws_col;
+        *height = ws.ws_row;
+        return 1;
+    }
+#endif
+    *width = *height = 0;
+    return 0;
+}
+
+void I_InvalidateASCIITerm(void) {
+    free(shown); shown = nullptr;
+}
+
+void I_SetASCIITermByteBudget(int bytes) {
+    term_budget = std::max(0, bytes);
+}
+
+void I_PresentASCIITerm(const void *cells, int width, int height) {
+    if (!term_active || !cells || width <= 0 || height <= 0) return;
+    char* p = out_buf;
+    ensure_term_buffers(width, height, false, p);
+
+    const AsciiCell* src = (const AsciiCell*)cells;
+    // 256/16색: 바뀐 셀을 찾기 전에 프레임 전체를 색 번호로 (할당 실패면 셀마다 조회)
+    const int total = width * height;
+    const uint8_t* quant = nullptr;
+    if (term_mode != ASCII_TERM_TRUECOLOR) {
+        if (term_quant_capacity < total) {
+            free(term_quant);
+            term_quant = (uint8_t*)malloc((size_t)total);
+            term_quant_capacity = term_quant ? total : 0;
+        }
+        if (term_quant) {
+            I_QuantizeASCIICells(term_quant_target, src, total, term_quant);
+            quant = term_quant;
+        }
+    }
+    // 상한이 있으면 셀 하나 최대 크기만큼 여유를 두고 멈춤 (남은 셀은 shown과 달라 다음 프레임에 나감)
+    const char* limit = term_budget > 0
+        ? out_buf + std::max(0, term_budget - TERM_MAX_CELL_BYTES)
+        : out_buf + out_capacity;
+
+    for (int y = 0; y < height && p < limit; ++y) {
+        const AsciiCell* row = src + (size_t)y * width;
+        uint64_t* shown_row = shown + (size_t)y * width;
+        for (int x = 0; x < width; ++x) {
+            const AsciiCell& c = row[x];
+            const uint32_t key = cell_key(c, quant ? quant[(size_t)y * width + x] : term_color(c.r, c.g, c.b));
+            if (key == shown_row[x]) continue;
+            if (p >= limit) break;
+
+            // 같은 행의 짧은 틈: 안 바뀐 셀이 현재 색(또는 공백)이면 커서 이동 대신 다시 씀
+            const int gap = x - cur_x;
+            if (cur_y == y && gap > 0 && gap <= TERM_MAX_MERGE_GAP) {
+                int k = cur_x;
+                for (; k < x; ++k) {
+                    const uint32_t s = (uint32_t)shown_row[k];
+                    if (s != ' ' && (int64_t)(s >> 8) != cur_color) break;
+                }
+                if (k == x) {
+                    for (k = cur_x; k < x; ++k) *p++ = (char)(shown_row[k] & 0xFF);
+                    cur_x = x;
+                }
+            }
+            move_cursor(p, x, y);
+
+            const uint8_t ch = (uint8_t)(key & 0xFF);
+            if (ch != ' ' && (int64_t)(key >> 8) != cur_color) {
+                put_sgr(p, key >> 8);
+                cur_color = (int64_t)(key >> 8);
+            }
+            *p++ = (char)ch;
+            shown_row[x] = key;
+            // 마지막 열: 자동 줄바꿈을 꺼도 커서 위치는 터미널마다 달라 모름으로 둠
+            cur_x = (x + 1 < width) ? x + 1 : -1;
+        }
+    }
+
+    const size_t n = (size_t)(p - out_buf);
+    if (n > 0) term_write(out_buf, n);
+    last_bytes = (uint32_t)n;
+    total_bytes += n;
+    ++total_frames;
+}
+
+// 하위 셀 출력: 셀마다 UTF-8 글자 + 전경/배경 SGR. 글자가 여러 바이트라 안 바뀐 틈은 다시 쓰지 않고 커서 이동
+void I_PresentASCIITermWide(const void *cells, int width, int height) {
+    if (!term_active || !cells || width <= 0 || height <= 0) return;
+    char* p = out_buf;
+    ensure_term_buffers(width, height, true, p);
+
+    const AsciiWideCell* src = (const AsciiWideCell*)cells;
+    const char* limit = term_budget > 0
+        ? out_buf + std::max(0, term_budget - TERM_MAX_WIDE_CELL_BYTES)
+        : out_buf + out_capacity;
+
+    for (int y = 0; y < height && p < limit; ++y) {
+        const AsciiWideCell* row = src + (size_t)y * width;
+        uint64_t* shown_row = shown + (size_t)y * width;
+        for (int x = 0; x < width; ++x) {
+            const uint64_t key = wide_key(row[x]);
+            if (key == shown_row[x]) continue;
+            if (p >= limit) break;
+            move_cursor(p, x, y);
+
+            const uint32_t cp = (uint32_t)(key >> 48);
+            const int64_t fg = (int64_t)((key >> 24) & 0xFFFFFF);
+            const int64_t bg = (int64_t)(key & 0xFFFFFF);
+            const bool set_fg = cp != ' ' && fg != cur_color;
+            const bool set_bg = bg != cur_bg;
+            if (set_fg || set_bg) {
+                *p++ = '\x1b'; *p++ = '[';
+                if (set_fg) put_color_params(p, (uint32_t)fg, false);
+                if (set_fg && set_bg) *p++ = ';';
+                if (set_bg) put_color_params(p, (uint32_t)bg, true);
+                *p++ = 'm';
+                if (set_fg) cur_color = fg;
+                if (set_bg) cur_bg = bg;
+            }
+            put_utf8(p, cp);
+            shown_row[x] = key;
+            cur_x = (x + 1 < width) ? x + 1 : -1;
+        }
+    }
+
+    const size_t n = (size_t)(p - out_buf);
+    if (n > 0) term_write(out_buf, n);
+    last_bytes = (uint32_t)n;
+    total_bytes += n;
+    ++total_frames;
+}
+
+uint32_t I_GetASCIITermLastBytes(void) {
+    return last_bytes;
+}
+
+double I_GetASCIITermBytesPerFrame(void) {
+    return total_frames ? (double)total_bytes / total_frames : 0.0;
+}
+
+double I_GetASCIITermSyscallsPerFrame(void) {
+    return total_frames ? (double)total_syscalls / total_frames : 0.0;
+}
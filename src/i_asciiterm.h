@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 터미널 출력 백엔드: AsciiCell 프레임 → ANSI 이스케이프 (네이티브 POSIX 전용)
+// 화면에 보이는 상태와 비교해 바뀐 셀만 내보내고, 프레임마다 write() 한 번
+
+// 색 모드
+#define ASCII_TERM_TRUECOLOR 0  // SGR 38;2;r;g;b
+#define ASCII_TERM_256       1  // SGR 38;5;n (6×6×6 큐브 + 회색 24단계)
+#define ASCII_TERM_16        2  // SGR 30-37 / 90-97
+
+// 초기화: stdout이 터미널이 아니거나 지원하지 않는 플랫폼이면 0
+int  I_InitASCIITerm(int color_mode);
+void I_ShutdownASCIITerm(void);
+int  I_ASCIITermActive(void);
+
+// 터미널 크기 (문자 단위). 알 수 없으면 0
+int  I_GetASCIITermSize(int *width, int *height);
+
+// 프레임 출력 (cells: AsciiCell[width * height])
+void I_PresentASCIITerm(const void *cells, int width, int height);
+
+// 하위 셀 프레임 출력 (cells: AsciiWideCell[width * height], 글자는 UTF-8, 전경/배경색 모두 SGR)
+// 터미널 폰트에 ▀/점자 글리프가 있어야 함. AsciiCell 출력과 번갈아 쓰면 화면을 지우고 다시 그림
+void I_PresentASCIITermWide(const void *cells, int width, int height);
+
+// 다음 프레임을 전체 다시 그림 (터미널을 밖에서 건드린 경우)
+void I_InvalidateASCIITerm(void);
+
+// 프레임당 바이트 상한 (0: 무제한). 넘치는 셀은 다음 프레임으로 밀림
+void I_SetASCIITermByteBudget(int bytes);
+
+// 측정값
+uint32_t I_GetASCIITermLastBytes(void);       // 직전 프레임 바이트
+double   I_GetASCIITermBytesPerFrame(void);   // 누적 평균
+double   I_GetASCIITermSyscallsPerFrame(void); // 누적 평균 write() 호출 수
+
+#ifdef __cplusplus
+}
+#endif
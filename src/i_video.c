@@ -48,9 +48,12 @@
 #include "w_wad.h"
 #include "z_zone.h"
 
-#ifdef __EMSCRIPTEN__
 #include "i_ascii.h"
-#endif
+#include "i_asciicast.h"
+#include "i_asciicorpus.h"
+#include "i_asciiraster.h"
+#include "i_asciisession.h"
+#include "i_asciiterm.h"
 
 // These are (1) the window (or the full screen) that our game is rendered to
 // and (2) the renderer that scales the texture (see below) into this window.
@@ -183,6 +186,17 @@ static boolean display_fps_dots;
 
 static boolean noblit;
 
+// If this is true, the ASCII converter is the only consumer of the frame:
+// no renderer or textures are created and nothing is presented to the
+// window, which only remains for input.
+
+static boolean ascii_only;
+
+// With -asciiheadless there is no visible window either: SDL uses its
+// dummy video driver, so the game runs on a server without a display.
+
+static boolean ascii_headless;
+
 // Callback function to invoke to determine whether to grab the 
 // mouse pointer.
 
@@ -274,16 +288,150 @@ static void SetShowCursor(boolean show)
     }
 }
 
+// Dump the per-stage ASCII conversion latency histograms on exit.
+
+static void WriteASCIIStats(void)
+{
+    const char *json;
+    int i;
+
+    //!
+    // @category video
+    // @arg <file>
+    //
+    // On exit, write per-stage ASCII conversion latency percentiles
+    // (JSON, microseconds) to the specified file.
+    //
+
+    i = M_CheckParmWithArgs("-asciistats", 1);
+
+    if (i == 0)
+    {
+        return;
+    }
+
+    json = ascii_get_stage_stats_json();
+
+    if (!M_WriteFile(myargv[i + 1], json, strlen(json)))
+    {
+        printf("WriteASCIIStats: failed to write '%s'\n", myargv[i + 1]);
+    }
+}
+
+// Append the rasterized ASCII view to the -asciiy4m recording.
+
+static void RecordASCIIFrame(void)
+{
+    if (!I_ASCIIRasterY4MActive())
+    {
+        return;
+    }
+
+    I_RasterizeASCII(I_GetASCIIBuffer(), I_GetASCIIWidth(), I_GetASCIIHeight());
+    I_WriteASCIIRasterY4MFrame();
+}
+
+// Hand the finished frame to readers on other threads / rAF cadence and
+// to the terminal. If the converter skipped an identical frame, readers
+// keep the previous one (same sequence number) and nothing is redrawn.
+
+static void PresentASCIIFrame(void)
+{
+    if (!ascii_get_frame_unchanged())
+    {
+        const AsciiWideCell *wide = ascii_get_wide_buffer();
+
+        I_PublishASCIIFrame(I_GetTime());
+
+        if (wide != NULL)
+        {
+            I_PresentASCIITermWide(wide, I_GetASCIIWidth(),
+                                   I_GetASCIIHeight());
+        }
+        else
+        {
+            I_PresentASCIITerm(I_GetASCIIBuffer(),
+                               I_GetASCIIWidth(), I_GetASCIIHeight());
+        }
+
+        // Spectators and session files keep the plain AsciiCell grid.
+
+        I_BroadcastASCIIFrame(I_GetASCIIBuffer(),
+                              I_GetASCIIWidth(), I_GetASCIIHeight());
+        I_WriteASCIISessionFrame(I_GetASCIIBuffer(), I_GetASCIIWidth(),
+                                 I_GetASCIIHeight(), I_GetTime());
+    }
+    else
+    {
+        // Keep feeding subscribers that are still catching up.
+        I_PumpASCIICast();
+    }
+
+    RecordASCIIFrame();
+}
+
+static void StopASCIICast(void)
+{
+    AsciiCastStats stats;
+
+    if (!I_ASCIICastActive())
+    {
+        return;
+    }
+
+    I_GetASCIICastStats(&stats);
+    I_StopASCIICast();
+
+    if (stats.frames > 0)
+    {
+        printf("StopASCIICast: %llu frames, %llu keyframes, "
+               "%.3f ms encode/frame, %llu subscriber(s), "
+               "%llu bytes sent, %llu drop(s)\n",
+               (unsigned long long) stats.frames,
+               (unsigned long long) stats.keyframes,
+               stats.encode_ms / stats.frames,
+               (unsigned long long) stats.accepted,
+               (unsigned long long) stats.sent_bytes,
+               (unsigned long long) stats.drops);
+    }
+}
+
+static void StopASCIISession(void)
+{
+    AsciiSessionStats stats;
+
+    if (!I_ASCIISessionActive())
+    {
+        return;
+    }
+
+    I_GetASCIISessionStats(&stats);
+    I_StopASCIISession();
+
+    if (stats.frames > 0)
+    {
+        printf("StopASCIISession: %u frames, %u keyframes, %llu bytes, "
+               "%.3f ms encode/frame\n",
+               stats.frames, stats.keyframes,
+               (unsigned long long) stats.bytes,
+               stats.encode_ms / stats.frames);
+    }
+}
+
 void I_ShutdownGraphics(void)
 {
     if (initialized)
     {
         SetShowCursor(true);
 
-#ifdef __EMSCRIPTEN__
         // Shutdown ASCII rendering
+        WriteASCIIStats();
+        I_StopASCIICapture();
+        StopASCIICast();
+        StopASCIISession();
+        I_ShutdownASCIIRaster();
+        I_ShutdownASCIITerm();
         I_ShutdownASCII();
-#endif
 
         SDL_FreeSurface(argbbuffer);
         SDL_FreeSurface(screenbuffer);
@@ -715,6 +863,7 @@ void I_FinishUpdate (void)
     static int lasttic;
     int tics;
     int i;
+    int ascii_needs_rgba;
 
     if (!initialized)
         return;
@@ -739,7 +888,10 @@ void I_FinishUpdate (void)
                 AdjustWindowSize();
                 SDL_SetWindowSize(screen, window_width, window_height);
             }
-            CreateUpscaledTexture(false);
+            if (!ascii_only)
+            {
+                CreateUpscaledTexture(false);
+            }
             need_resize = false;
             palette_to_set = true;
         }
@@ -773,6 +925,8 @@ void I_FinishUpdate (void)
 	    I_VideoBuffer[ (SCREENHEIGHT-1)*SCREENWIDTH + i] = 0xff;
 	for ( ; i<20*4 ; i+=4)
 	    I_VideoBuffer[ (SCREENHEIGHT-1)*SCREENWIDTH + i] = 0x0;
+
+        I_MarkASCIIRect(0, SCREENHEIGHT - 1, 20 * 4, 1);
     }
 
     // Draw disk icon before blit, if necessary.
@@ -783,7 +937,7 @@ void I_FinishUpdate (void)
         SDL_SetPaletteColors(screenbuffer->format->palette, palette, 0, 256);
         palette_to_set = false;
 
-        if (vga_porch_flash)
+        if (vga_porch_flash && !ascii_only)
         {
             // "flash" the pillars/letterboxes with palette changes, emulating
             // VGA "porch" behaviour (GitHub issue #832)
@@ -792,6 +946,38 @@ void I_FinishUpdate (void)
         }
     }
 
+    // If nobody looks at the SDL texture (the web page only shows the
+    // ASCII canvas), convert straight from the paletted 8-bit buffer and
+    // skip the 32-bit blit, texture upload and present entirely.
+    // With -asciionly there is no texture at all; a 32-bit frame, when
+    // the converter wants one, is blitted into our own surface instead.
+
+    ascii_needs_rgba = I_ASCIINeedsRGBA();
+
+    if (ascii_only || (!ascii_needs_rgba && !ascii_get_sdl_output()))
+    {
+        if (ascii_needs_rgba)
+        {
+            SDL_LowerBlit(screenbuffer, &blit_rect, argbbuffer, &blit_rect);
+            I_CaptureASCIIRGBA((const uint32_t *)argbbuffer->pixels,
+                               SCREENWIDTH, SCREENHEIGHT);
+            I_ConvertRGBAtoASCII((const uint32_t *)argbbuffer->pixels,
+                                 SCREENWIDTH, SCREENHEIGHT,
+                                 (void *) I_GetASCIIBuffer(),
+                                 I_GetASCIIWidth(), I_GetASCIIHeight());
+        }
+        else
+        {
+            I_CaptureASCIIPal8(I_VideoBuffer, SCREENWIDTH, SCREENHEIGHT);
+            I_ConvertPal8toASCII(I_VideoBuffer, SCREENWIDTH, SCREENHEIGHT,
+                                 (void *) I_GetASCIIBuffer(),
+                                 I_GetASCIIWidth(), I_GetASCIIHeight());
+        }
+        PresentASCIIFrame();
+        V_RestoreDiskBackground();
+        return;
+    }
+
     // Blit from the paletted 8-bit screen buffer to the intermediate
     // 32-bit RGBA buffer and update the intermediate texture with the
     // contents of the RGBA buffer.
@@ -800,18 +986,27 @@ void I_FinishUpdate (void)
                     &argbbuffer->pitch);
     SDL_LowerBlit(screenbuffer, &blit_rect, argbbuffer, &blit_rect);
     
-#ifdef __EMSCRIPTEN__
-    // Convert RGBA buffer to ASCII for web display
-    if (argbbuffer != NULL && argbbuffer->pixels != NULL)
+    // Convert to ASCII (web display, or native profiling)
+    if (!ascii_needs_rgba)
+    {
+        I_CaptureASCIIPal8(I_VideoBuffer, SCREENWIDTH, SCREENHEIGHT);
+        I_ConvertPal8toASCII(I_VideoBuffer, SCREENWIDTH, SCREENHEIGHT,
+                             (void *) I_GetASCIIBuffer(),
+                             I_GetASCIIWidth(), I_GetASCIIHeight());
+    }
+    else if (argbbuffer != NULL && argbbuffer->pixels != NULL)
     {
         void *ascii_buf = (void *)I_GetASCIIBuffer();
+        I_CaptureASCIIRGBA((const uint32_t *)argbbuffer->pixels,
+                           SCREENWIDTH, SCREENHEIGHT);
         I_ConvertRGBAtoASCII((const uint32_t *)argbbuffer->pixels,
                              SCREENWIDTH, SCREENHEIGHT,
                              ascii_buf,
-                             ASCII_WIDTH, ASCII_HEIGHT);
+                             I_GetASCIIWidth(), I_GetASCIIHeight());
     }
-#endif
-    
+
+    PresentASCIIFrame();
+
     SDL_UnlockTexture(texture);
 
     // Make sure the pillarboxes are kept clear each frame.
@@ -860,6 +1055,7 @@ void I_ReadScreen (pixel_t* scr)
 //
 void I_SetPalette (byte *doompalette)
 {
+    byte ascii_palette[256 * 3];
     int i;
 
     for (i=0; i<256; ++i)
@@ -871,8 +1067,17 @@ void I_SetPalette (byte *doompalette)
         palette[i].r = gammatable[usegamma][*doompalette++] & ~3;
         palette[i].g = gammatable[usegamma][*doompalette++] & ~3;
         palette[i].b = gammatable[usegamma][*doompalette++] & ~3;
+
+        ascii_palette[i * 3 + 0] = palette[i].r;
+        ascii_palette[i * 3 + 1] = palette[i].g;
+        ascii_palette[i * 3 + 2] = palette[i].b;
     }
 
+    // The ASCII converter reads I_VideoBuffer directly and needs the
+    // same colors the 8-bit -> 32-bit blit would produce.
+    I_SetASCIIPalette(ascii_palette);
+    I_CaptureASCIIPalette(ascii_palette);
+
     palette_to_set = true;
 }
 
@@ -985,6 +1190,31 @@ void I_GraphicsCheckCommandLine(void)
 
     noblit = M_CheckParm ("-noblit");
 
+    //!
+    // @category video
+    //
+    // Only produce the ASCII frame: don't create an SDL renderer or
+    // textures and don't present anything to the window. Useful for
+    // the web build and for headless servers.
+    //
+
+    ascii_only = M_ParmExists("-asciionly");
+
+    //!
+    // @category video
+    //
+    // Run without a display: implies -asciionly, uses SDL's dummy
+    // video driver and keeps the window hidden. Meant for spectator
+    // servers (-asciicast) and the terminal output (-asciiterm).
+    //
+
+    ascii_headless = M_ParmExists("-asciiheadless");
+
+    if (ascii_headless)
+    {
+        ascii_only = true;
+    }
+
     //!
     // @category video 
     //
@@ -1146,6 +1376,14 @@ void I_CheckIsScreensaver(void)
 
 static void SetSDLVideoDriver(void)
 {
+    static char dummy_driver[] = "SDL_VIDEODRIVER=dummy";
+
+    if (ascii_headless)
+    {
+        putenv(dummy_driver);
+        return;
+    }
+
     // Allow a default value for the SDL video driver to be specified
     // in the configuration file.
 
@@ -1221,6 +1459,33 @@ void I_GetWindowPosition(int *x, int *y, int w, int h)
     }
 }
 
+// With -asciionly, only the 8-bit screen buffer and (for conversions
+// that need 32-bit input) a 320x200 RGBA surface with its own pixels are
+// created. The window is kept so that input events still arrive.
+
+static void SetASCIIOnlyMode(void)
+{
+    if (screenbuffer == NULL)
+    {
+        screenbuffer = SDL_CreateRGBSurface(0,
+                                            SCREENWIDTH, SCREENHEIGHT, 8,
+                                            0, 0, 0, 0);
+        SDL_FillRect(screenbuffer, NULL, 0);
+    }
+
+    if (argbbuffer == NULL)
+    {
+        argbbuffer = SDL_CreateRGBSurfaceWithFormat(
+                     0, SCREENWIDTH, SCREENHEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+    }
+
+    if (screenbuffer == NULL || argbbuffer == NULL)
+    {
+        I_Error("Error creating ASCII-only screen buffers: %s",
+                SDL_GetError());
+    }
+}
+
 static void SetVideoMode(void)
 {
     int w, h;
@@ -1265,6 +1530,11 @@ static void SetVideoMode(void)
         window_flags |= SDL_WINDOW_BORDERLESS;
     }
 
+    if (ascii_headless)
+    {
+        window_flags = SDL_WINDOW_HIDDEN;
+    }
+
     I_GetWindowPosition(&x, &y, w, h);
 
     // Create window and renderer contexts. We set the window title
@@ -1288,6 +1558,12 @@ static void SetVideoMode(void)
         I_InitWindowIcon();
     }
 
+    if (ascii_only)
+    {
+        SetASCIIOnlyMode();
+        return;
+    }
+
     // The SDL_RENDERER_TARGETTEXTURE flag is required to render the
     // intermediate texture into the upscaled texture.
     renderer_flags = SDL_RENDERER_TARGETTEXTURE;
@@ -1435,10 +1711,78 @@ static void SetVideoMode(void)
     CreateUpscaledTexture(true);
 }
 
+// Start the ANSI terminal presenter for the ASCII frame (-asciiterm).
+
+static void InitASCIITerm(boolean grid_given)
+{
+    int color_mode = ASCII_TERM_TRUECOLOR;
+    int i;
+
+    //!
+    // @category video
+    // @arg <n>
+    //
+    // Number of colors to use for -asciiterm: 24 (24-bit truecolor,
+    // default), 256 or 16.
+    //
+
+    i = M_CheckParmWithArgs("-asciitermcolors", 1);
+
+    if (i > 0)
+    {
+        int colors = atoi(myargv[i + 1]);
+
+        if (colors == 256)
+        {
+            color_mode = ASCII_TERM_256;
+        }
+        else if (colors == 16)
+        {
+            color_mode = ASCII_TERM_16;
+        }
+        else if (colors != 24)
+        {
+            I_Error("Invalid -asciitermcolors value: '%s'", myargv[i + 1]);
+        }
+    }
+
+    if (!I_InitASCIITerm(color_mode))
+    {
+        printf("I_InitGraphics: -asciiterm needs stdout to be a terminal\n");
+        return;
+    }
+
+    //!
+    // @category video
+    // @arg <bytes>
+    //
+    // Limit the terminal output of -asciiterm to this many bytes per
+    // frame. Cells that do not fit are sent in the following frames.
+    //
+
+    i = M_CheckParmWithArgs("-asciitermbudget", 1);
+
+    if (i > 0)
+    {
+        I_SetASCIITermByteBudget(atoi(myargv[i + 1]));
+    }
+
+    if (!grid_given)
+    {
+        int w, h;
+
+        if (I_GetASCIITermSize(&w, &h))
+        {
+            I_SetASCIIGrid(w, h);
+        }
+    }
+}
+
 void I_InitGraphics(void)
 {
     SDL_Event dummy;
     byte *doompal;
+    int i;
     char *env;
 
     // Pass through the XSCREENSAVER_WINDOW environment variable to 
@@ -1528,14 +1872,256 @@ void I_InitGraphics(void)
 
     initialized = true;
 
-#ifdef __EMSCRIPTEN__
     // Initialize ASCII rendering
     I_InitASCII();
-#endif
 
     // Call I_ShutdownGraphics on quit
 
     I_AtExit(I_ShutdownGraphics, true);
+
+    //!
+    // @category video
+    // @arg <WxH>
+    //
+    // Specify the size of the ASCII character grid (default 240x80).
+    //
+
+    i = M_CheckParmWithArgs("-asciigrid", 1);
+
+    if (i > 0)
+    {
+        int w, h;
+
+        if (sscanf(myargv[i + 1], "%ix%i", &w, &h) != 2
+         || !I_SetASCIIGrid(w, h))
+        {
+            I_Error("Invalid ASCII grid size: '%s'", myargv[i + 1]);
+        }
+    }
+
+    //!
+    // @category video
+    //
+    // Also draw the ASCII frame to the terminal on stdout with ANSI
+    // escape sequences, sending only the cells that changed. Unless
+    // -asciigrid is given, the grid is sized to fit the terminal.
+    //
+
+    if (M_ParmExists("-asciiterm"))
+    {
+        InitASCIITerm(i > 0);
+    }
+
+    //!
+    // @category video
+    //
+    // Smooth the ASCII view over time: a cell keeps its previous glyph
+    // until its brightness leaves that glyph's range by a margin, and
+    // its previous colour while the new one stays within a margin.
+    // This suppresses flicker and shrinks the per-frame cell deltas.
+    //
+
+    if (M_ParmExists("-asciitemporal"))
+    {
+        ascii_set_temporal_filter(1);
+    }
+
+    //!
+    // @category video
+    // @arg [<threshold>]
+    //
+    // Pick ASCII glyphs by shape as well as brightness: cells whose
+    // quadrants differ in brightness by at least the threshold
+    // (0-255, default 40) get an edge glyph such as / \ _ or ' that
+    // follows the outline.
+    //
+
+    i = M_CheckParm("-asciishape");
+
+    if (i > 0)
+    {
+        ascii_set_shape_glyphs(1);
+
+        if (i + 1 < myargc && myargv[i + 1][0] != '-')
+        {
+            ascii_set_shape_threshold(atoi(myargv[i + 1]));
+        }
+    }
+
+    //!
+    // @category video
+    // @arg half|braille
+    //
+    // Render each ASCII cell with Unicode sub-cell glyphs: "half" uses
+    // the upper half block with separate top and bottom colours,
+    // "braille" uses a 2x4 Braille dot pattern thresholded against
+    // the cell's mean brightness. Doubles or quadruples the effective
+    // resolution in -asciiterm and the browser; needs a font with
+    // these glyphs.
+    //
+
+    i = M_CheckParmWithArgs("-asciisubcell", 1);
+
+    if (i > 0)
+    {
+        if (!strcmp(myargv[i + 1], "half"))
+        {
+            ascii_set_subcell_mode(ASCII_SUBCELL_HALF);
+        }
+        else if (!strcmp(myargv[i + 1], "braille"))
+        {
+            ascii_set_subcell_mode(ASCII_SUBCELL_BRAILLE);
+        }
+        else
+        {
+            I_Error("Invalid -asciisubcell value: '%s'", myargv[i + 1]);
+        }
+    }
+
+    //!
+    // @category video
+    // @arg bayer|floyd|atkinson [<levels>]
+    //
+    // Dither ASCII glyph and colour selection to break up banding in
+    // smooth gradients: "bayer" adds an ordered 8x8 threshold that is
+    // stable from frame to frame, "floyd" and "atkinson" diffuse the
+    // quantization error to neighbouring cells. The optional levels
+    // (2-256) quantize each colour channel; by default colours are
+    // quantized when packed RGB444 output is on, to match its 4-bit
+    // channels.
+    //
+
+    i = M_CheckParmWithArgs("-asciidither", 1);
+
+    if (i > 0)
+    {
+        if (!strcmp(myargv[i + 1], "bayer"))
+        {
+            ascii_set_dither(ASCII_DITHER_BAYER);
+        }
+        else if (!strcmp(myargv[i + 1], "floyd"))
+        {
+            ascii_set_dither(ASCII_DITHER_FLOYD);
+        }
+        else if (!strcmp(myargv[i + 1], "atkinson"))
+        {
+            ascii_set_dither(ASCII_DITHER_ATKINSON);
+        }
+        else
+        {
+            I_Error("Invalid -asciidither value: '%s'", myargv[i + 1]);
+        }
+
+        if (i + 2 < myargc && myargv[i + 2][0] != '-')
+        {
+            ascii_set_dither_levels(atoi(myargv[i + 2]));
+        }
+    }
+
+    //!
+    // @category video
+    //
+    // Convert the status bar and view border to ASCII every frame
+    // instead of reusing their cells until something is drawn over
+    // them. Useful to check the static region cache.
+    //
+
+    if (M_ParmExists("-asciinoregions"))
+    {
+        ascii_set_static_regions(0);
+    }
+
+    //!
+    // @category video
+    // @arg <file>
+    //
+    // Record every frame passed to the ASCII converter (8-bit frames
+    // with their palettes, or 32-bit frames) to the specified corpus
+    // file for the asciibench tool. Best used with -timedemo.
+    //
+
+    i = M_CheckParmWithArgs("-asciicapture", 1);
+
+    if (i > 0)
+    {
+        if (!I_StartASCIICapture(myargv[i + 1]))
+        {
+            I_Error("Failed to open ASCII capture file '%s'", myargv[i + 1]);
+        }
+
+        printf("I_InitGraphics: capturing ASCII frames to '%s'\n",
+               myargv[i + 1]);
+    }
+
+    //!
+    // @category video
+    // @arg <file>
+    //
+    // Record the ASCII view, drawn with the 8x16 textscreen font, to
+    // the specified YUV4MPEG2 (4:4:4) video file, one frame per
+    // converted frame.
+    //
+
+    i = M_CheckParmWithArgs("-asciiy4m", 1);
+
+    if (i > 0)
+    {
+        if (!I_StartASCIIRasterY4M(myargv[i + 1], TICRATE))
+        {
+            I_Error("Failed to open ASCII video file '%s'", myargv[i + 1]);
+        }
+
+        printf("I_InitGraphics: recording ASCII video to '%s'\n",
+               myargv[i + 1]);
+    }
+
+    //!
+    // @category video
+    // @arg <address>
+    //
+    // Broadcast the ASCII frames to spectators connecting to the given
+    // address: "unix:<path>" for a Unix domain socket, "<host>:<port>"
+    // or "<port>" for TCP. Each frame is delta-encoded once for all
+    // subscribers; a subscriber that falls behind skips ahead to a
+    // keyframe. Usually combined with -asciiheadless.
+    //
+
+    i = M_CheckParmWithArgs("-asciicast", 1);
+
+    if (i > 0)
+    {
+        if (!I_StartASCIICast(myargv[i + 1]))
+        {
+            I_Error("Failed to listen for ASCII spectators on '%s'",
+                    myargv[i + 1]);
+        }
+
+        printf("I_InitGraphics: broadcasting ASCII frames on '%s'\n",
+               myargv[i + 1]);
+    }
+
+    //!
+    // @category video
+    // @arg <file>
+    //
+    // Record the converted ASCII frames and their game tics to the
+    // specified session file (keyframes plus XOR deltas, with a tic
+    // index for seeking). Play it back with asciiplay or the browser
+    // build's ?replay= parameter.
+    //
+
+    i = M_CheckParmWithArgs("-asciirecord", 1);
+
+    if (i > 0)
+    {
+        if (!I_StartASCIISession(myargv[i + 1], 0))
+        {
+            I_Error("Failed to open ASCII session file '%s'", myargv[i + 1]);
+        }
+
+        printf("I_InitGraphics: recording ASCII session to '%s'\n",
+               myargv[i + 1]);
+    }
 }
 
 // Bind all variables controlling video options into the configuration
@@ -1,9 +1,10 @@
 // Doom args
-const commonArgs = ["-iwad","doom1.wad","-window","-nogui","-nomusic","-config","default.cfg","-servername","doomflare","-force_software_renderer","1"];
+const commonArgs = ["-iwad","doom1.wad","-window","-nogui","-nomusic","-config","default.cfg","-servername","doomflare","-force_software_renderer","1","-asciionly"];
 
-// JS/WASM 해상도 (i_ascii.h의 ASCII_WIDTH/HEIGHT와 반드시 동일)
-const ASCII_WIDTH  = 240;
-const ASCII_HEIGHT = 80;
+// 문자 그리드 크기: 엔진(ascii_get_grid_width/height)에서 매 프레임 읽어 맞춤
+// 페이지 URL에 ?grid=160x50 처럼 주면 시작 시 그 크기로 설정
+let ASCII_WIDTH  = 240;
+let ASCII_HEIGHT = 80;
 const SCREENWIDTH  = 320;
 const SCREENHEIGHT = 200;
 
@@ -14,6 +15,25 @@ function setupRenderer() {
   const setSimd       = Module.cwrap('ascii_set_simd', null, ['number']);
   const getSimd       = Module.cwrap('ascii_get_simd', 'number', []);
   const simdSupported = Module.cwrap('ascii_simd_supported', 'number', []);
+  const setFused      = Module.cwrap('ascii_set_fused', null, ['number']);
+  const getFused      = Module.cwrap('ascii_get_fused', 'number', []);
+  const setSdlOutput  = Module.cwrap('ascii_set_sdl_output', null, ['number']);
+  const setGrid       = Module.cwrap('ascii_set_grid', 'number', ['number', 'number']);
+  const getGridWidth  = Module.cwrap('ascii_get_grid_width', 'number', []);
+  const getGridHeight = Module.cwrap('ascii_get_grid_height', 'number', []);
+  const getFrameId    = Module.cwrap('ascii_get_frame_id', 'number', []);
+  // 발행된 프레임 (트리플 버퍼): 엔진이 쓰는 중인 셀 버퍼 대신 완성된 최신 프레임을 읽음
+  const acquireFrame  = Module.cwrap('ascii_acquire_frame', 'number', []);
+  const getAcqCells   = Module.cwrap('ascii_get_acquired_cells', 'number', []);
+  const getAcqPacked  = Module.cwrap('ascii_get_acquired_packed', 'number', []);
+  const getAcqPalette = Module.cwrap('ascii_get_acquired_palette', 'number', []);
+  const getAcqPaletteCount = Module.cwrap('ascii_get_acquired_palette_count', 'number', []);
+  const getAcqWidth   = Module.cwrap('ascii_get_acquired_width', 'number', []);
+  const getAcqHeight  = Module.cwrap('ascii_get_acquired_height', 'number', []);
+  const getAcqFrameId = Module.cwrap('ascii_get_acquired_frame_id', 'number', []);
+  const getDeltaPtr   = Module.cwrap('ascii_get_delta_buffer', 'number', []);
+  const getDeltaCount = Module.cwrap('ascii_get_delta_count', 'number', []);
+  const getDeltaFull  = Module.cwrap('ascii_get_delta_full', 'number', []);
   const setBenchmarkMode = Module.cwrap('ascii_set_benchmark_mode', null, ['number']);
   const getBenchmarkMode = Module.cwrap('ascii_get_benchmark_mode', 'number', []);
   const resetBenchmarkStats = Module.cwrap('ascii_reset_benchmark_stats', null, []);
@@ -36,6 +56,72 @@ function setupRenderer() {
   const getCurrentFpsOn = Module.cwrap('ascii_get_current_fps_simd_on', 'number', []);
   const getCurrentFpsOff = Module.cwrap('ascii_get_current_fps_simd_off', 'number', []);
 
+  // 16비트 패킹 출력 (문자 번호 4비트 + RGB444 또는 팔레트 번호 12비트)
+  const setPackedFormat = Module.cwrap('ascii_set_packed_format', null, ['number']);
+
+  // 단계별 지연 히스토그램 (JSON, 단위 µs)
+  const getStageStatsJson = Module.cwrap('ascii_get_stage_stats_json', 'string', []);
+  const resetStageStats = Module.cwrap('ascii_reset_stage_stats', null, []);
+  const setBenchmarkWarmup = Module.cwrap('ascii_set_benchmark_warmup', null, ['number']);
+
+  // 같은 프레임 건너뛰기 (내용 해시). 건너뛴 프레임은 발행되지 않아 frame_id가 그대로 → 다시 그리지 않음
+  const getFramesConverted = Module.cwrap('ascii_get_frames_converted', 'number', []);
+  const getFramesSkipped = Module.cwrap('ascii_get_frames_skipped', 'number', []);
+  const resetFrameCounters = Module.cwrap('ascii_reset_frame_counters', null, []);
+
+  // 시간 히스테리시스 (?temporal=1, ?temporal=밝기여유,색여유): 경계 근처 셀의 글리프/색 깜빡임 억제
+  const setTemporalFilter = Module.cwrap('ascii_set_temporal_filter', null, ['number']);
+  const setTemporalMargin = Module.cwrap('ascii_set_temporal_margin', null, ['number', 'number']);
+  const getTemporalStabilized = Module.cwrap('ascii_get_temporal_stabilized', 'number', []);
+
+  // 모양 글리프 (?shape=1, ?shape=임계값): 사분면 밝기 서명으로 윤곽선 셀에 / \ _ ' 등
+  const setShapeGlyphs    = Module.cwrap('ascii_set_shape_glyphs', null, ['number']);
+  const setShapeThreshold = Module.cwrap('ascii_set_shape_threshold', null, ['number']);
+  const getShapeMatched   = Module.cwrap('ascii_get_shape_matched', 'number', []);
+
+  // 하위 셀 출력 (?subcell=half | ?subcell=braille): 셀마다 반 블록 위/아래 색 또는 2x4 점자 + 전경/배경색
+  const setSubcellMode = Module.cwrap('ascii_set_subcell_mode', null, ['number']);
+  const getAcqWide     = Module.cwrap('ascii_get_acquired_wide', 'number', []);
+
+  // 디더링 (?dither=bayer | floyd | atkinson, ?dither=방식,색단계): 그라데이션 띠를 문자/색 디더링으로 완화
+  const setDither       = Module.cwrap('ascii_set_dither', null, ['number']);
+  const setDitherLevels = Module.cwrap('ascii_set_dither_levels', null, ['number']);
+  const getBenchAvgTimeDither = Module.cwrap('ascii_get_benchmark_avg_time_dither', 'number', ['number']);
+  const getBenchFrameCountDither = Module.cwrap('ascii_get_benchmark_frame_count_dither', 'number', ['number']);
+
+  // 정적 영역 재사용 (?regions=0으로 끔): 상태 표시줄/테두리 셀 행을 다시 그려질 때까지 직전 출력에서 재사용
+  const setStaticRegions     = Module.cwrap('ascii_set_static_regions', null, ['number']);
+  const getRegionRowsReused  = Module.cwrap('ascii_get_region_rows_reused', 'number', []);
+
+  // 세션 녹화/재생: 녹화는 MEMFS 파일에 쓰고 멈출 때 내려받음, 재생은 받아 온 파일의 셀 그리드를 그대로 그림
+  const sessionStart    = Module.cwrap('ascii_session_start', 'number', ['string', 'number']);
+  const sessionStop     = Module.cwrap('ascii_session_stop', null, []);
+  const sessionActive   = Module.cwrap('ascii_session_active', 'number', []);
+  const sessionFrames   = Module.cwrap('ascii_session_frames', 'number', []);
+  const sessionEncodeMs = Module.cwrap('ascii_session_encode_ms', 'number', []);
+  const replayOpen      = Module.cwrap('ascii_replay_open', 'number', ['string']);
+  const replaySeek      = Module.cwrap('ascii_replay_seek', 'number', ['number']);
+  const replayCells     = Module.cwrap('ascii_replay_cells', 'number', []);
+  const replayWidth     = Module.cwrap('ascii_replay_width', 'number', []);
+  const replayHeight    = Module.cwrap('ascii_replay_height', 'number', []);
+  const replayFrame     = Module.cwrap('ascii_replay_frame', 'number', []);
+  const replayFirstTic  = Module.cwrap('ascii_replay_first_tic', 'number', []);
+  const replayLastTic   = Module.cwrap('ascii_replay_last_tic', 'number', []);
+
+  // 글리프 아틀라스 래스터라이저: 셀 → RGBA 이미지 (바뀐 셀만 다시 그림, 바뀐 사각형만 putImageData)
+  const rasterCells     = Module.cwrap('ascii_raster_cells', 'number', ['number', 'number', 'number']);
+  const setRasterFont   = Module.cwrap('ascii_set_raster_font', null, ['number']);
+  const getRasterCellW  = Module.cwrap('ascii_get_raster_cell_width', 'number', []);
+  const getRasterCellH  = Module.cwrap('ascii_get_raster_cell_height', 'number', []);
+  const invalidateRaster = Module.cwrap('ascii_invalidate_raster', null, []);
+  const getRasterBuffer = Module.cwrap('ascii_get_raster_buffer', 'number', []);
+  const getRasterWidth  = Module.cwrap('ascii_get_raster_width', 'number', []);
+  const getRasterHeight = Module.cwrap('ascii_get_raster_height', 'number', []);
+  const getRasterDirtyX = Module.cwrap('ascii_get_raster_dirty_x', 'number', []);
+  const getRasterDirtyY = Module.cwrap('ascii_get_raster_dirty_y', 'number', []);
+  const getRasterDirtyW = Module.cwrap('ascii_get_raster_dirty_w', 'number', []);
+  const getRasterDirtyH = Module.cwrap('ascii_get_raster_dirty_h', 'number', []);
+
   // JS 모드 관련 WASM exports
   const setJsMode = Module.cwrap('ascii_set_js_mode', null, ['number']);
   const getJsMode = Module.cwrap('ascii_get_js_mode', 'number', []);
@@ -46,6 +132,11 @@ function setupRenderer() {
 
   if (!getBufferPtr || !getBufferSize) { console.error("Failed to wrap WASM buffer functions."); return; }
 
+  // SDL 캔버스(#sdl-canvas)는 숨겨져 있음 → 엔진이 32비트 blit/텍스처 표시를 생략하고
+  // 8비트 팔레트 버퍼에서 바로 ASCII 변환 (JS 엔진 모드에서는 RGBA 버퍼를 계속 만듦)
+  // -asciionly라 SDL 렌더러/텍스처는 아예 만들지 않음
+  setSdlOutput(0);
+
   // ===== JS ASCII 변환 로직 =====
   const ASCII_CHARS = " .:-=+*#%@";
   const ASCII_CHARS_LEN = ASCII_CHARS.length;
@@ -285,6 +376,13 @@ function setupRenderer() {
   // 엔진 모드: 'cpp' | 'js'
   let engineMode = 'cpp';
 
+  // C++ 모드 그리기: 래스터 이미지(기본) | fillText (?raster=0)
+  // 하위 셀 출력은 배경색/반 블록을 직접 칠해야 하므로 fillText 경로를 씀
+  const rasterMode = new URLSearchParams(window.location.search).get('raster') !== '0';
+  const subcellParam = new URLSearchParams(window.location.search).get('subcell');
+  const subcellMode = subcellParam === 'half' ? 1 : subcellParam === 'braille' ? 2 : 0;
+  const useRaster = () => rasterMode && !subcellMode && engineMode === 'cpp';
+
   const canvas = document.getElementById('canvas');
   const ctx = canvas.getContext('2d', { alpha: false });
 
@@ -298,6 +396,22 @@ function setupRenderer() {
     DPR = window.devicePixelRatio || 1;
     CW = Math.round(rect.width  * DPR);
     CH = Math.round(rect.height * DPR);
+
+    // 래스터: 캔버스 = 이미지 크기 (CSS로 늘림). 그리드 폭이 화면에 들어가는 가장 큰 폰트
+    if (useRaster()) {
+      let font = 2;
+      while (font > 0) {
+        setRasterFont(font);
+        if (getRasterCellW() * ASCII_WIDTH <= CW) break;
+        font--;
+      }
+      setRasterFont(font);
+      canvas.width = ASCII_WIDTH * getRasterCellW();
+      canvas.height = ASCII_HEIGHT * getRasterCellH();
+      rasterImage = null;
+      return;
+    }
+
     canvas.width = CW;
     canvas.height = CH;
 
@@ -332,9 +446,138 @@ function setupRenderer() {
     yAdvance = lineHeight;
   }
 
-  // 최초 계산 + 리사이즈 대응
+  // 래스터 이미지를 힙 위에 그대로 씌운 ImageData (버퍼 주소/힙이 바뀌면 다시 만듦)
+  let rasterImage = null;
+
+  function paintRaster(heap, cellsPtr, full) {
+    if (full) invalidateRaster();
+    if (rasterCells(cellsPtr, ASCII_WIDTH, ASCII_HEIGHT) <= 0) return;
+    const ptr = getRasterBuffer();
+    const w = getRasterWidth();
+    const h = getRasterHeight();
+    if (!rasterImage || rasterImage.data.buffer !== heap ||
+        rasterImage.data.byteOffset !== ptr || rasterImage.width !== w || rasterImage.height !== h) {
+      rasterImage = new ImageData(new Uint8ClampedArray(heap, ptr, w * h * 4), w, h);
+    }
+    ctx.putImageData(rasterImage, 0, 0,
+                     getRasterDirtyX(), getRasterDirtyY(), getRasterDirtyW(), getRasterDirtyH());
+  }
+
+  // 증분 그리기 상태: 마지막으로 그린 C++ 프레임 id
+  let lastPaintedFrameId = -1;
+  let needFullRepaint = true;
+
+  // 엔진 그리드 크기가 바뀌면 셀 크기 재계산 + 전체 다시 그리기
+  function syncGrid() {
+    const w = getGridWidth();
+    const h = getGridHeight();
+    if (w === ASCII_WIDTH && h === ASCII_HEIGHT) return;
+    ASCII_WIDTH = w;
+    ASCII_HEIGHT = h;
+    recalc();
+    needFullRepaint = true;
+  }
+
+  // 최초 계산 + 리사이즈 대응 (캔버스가 지워지므로 다음 프레임은 전체 다시 그리기)
   recalc();
-  window.addEventListener('resize', () => { recalc(); });
+  window.addEventListener('resize', () => { recalc(); needFullRepaint = true; });
+
+  // 셀 하나 그리기 (buffer[i..i+3] = char, r, g, b)
+  function drawCell(buffer, i, x, yPos) {
+    const charCode = buffer[i];
+    const r = buffer[i + 1];
+    const g = buffer[i + 2];
+    const b = buffer[i + 3];
+    if (charCode > 32 || r > 10 || g > 10 || b > 10) {
+      ctx.fillStyle = `rgb(${r},${g},${b})`;
+      ctx.fillText(String.fromCharCode(charCode), x * xAdvance, yPos);
+    }
+  }
+
+  // 전체 그리기
+  function paintAll(buffer) {
+    ctx.fillStyle = '#000';
+    ctx.fillRect(0, 0, canvas.width, canvas.height);
+
+    let i = 0;
+    for (let y = 0; y < ASCII_HEIGHT; y++) {
+      const yPos = y * yAdvance;
+      for (let x = 0; x < ASCII_WIDTH; x++) {
+        drawCell(buffer, i, x, yPos);
+        i += 4;
+      }
+    }
+  }
+
+  // 패킹 출력 형식 (0: 끔, 1: RGB444, 2: 팔레트 번호). ?packed=444 | ?packed=indexed
+  let packedFormat = 0;
+
+  // 패킹 셀 전체 그리기: 셀당 2바이트만 힙에서 읽음 (발행 프레임의 패킹 버퍼/팔레트)
+  function paintAllPacked(heap, ptr) {
+    const packed = new Uint16Array(heap, ptr, ASCII_WIDTH * ASCII_HEIGHT);
+    const palette = packedFormat === 2
+      ? new Uint8Array(heap, getAcqPalette(), getAcqPaletteCount() * 3) : null;
+    ctx.fillStyle = '#000';
+    ctx.fillRect(0, 0, canvas.width, canvas.height);
+
+    let i = 0;
+    for (let y = 0; y < ASCII_HEIGHT; y++) {
+      const yPos = y * yAdvance;
+      for (let x = 0; x < ASCII_WIDTH; x++, i++) {
+        const p = packed[i];
+        const glyph = p >> 12;
+        const c = p & 0x0fff;
+        let r, g, b;
+        if (palette) {
+          r = palette[c * 3]; g = palette[c * 3 + 1]; b = palette[c * 3 + 2];
+        } else {
+          r = (c >> 8) * 17; g = ((c >> 4) & 15) * 17; b = (c & 15) * 17;
+        }
+        if (glyph > 0 || r > 10 || g > 10 || b > 10) {
+          ctx.fillStyle = `rgb(${r},${g},${b})`;
+          ctx.fillText(ASCII_CHARS[glyph], x * xAdvance, yPos);
+        }
+      }
+    }
+  }
+
+  // 하위 셀 전체 그리기: AsciiWideCell {uint16 코드포인트, 전경 r,g,b, 배경 r,g,b} (8바이트)
+  // 배경을 칠한 뒤 반 블록(▀)은 위 절반을 사각형으로, 점자는 글자로 그림 (폰트에 ▀가 없어도 됨)
+  function paintAllWide(heap, ptr) {
+    const cells = new Uint8Array(heap, ptr, ASCII_WIDTH * ASCII_HEIGHT * 8);
+    let o = 0;
+    for (let y = 0; y < ASCII_HEIGHT; y++) {
+      const yPos = y * yAdvance;
+      for (let x = 0; x < ASCII_WIDTH; x++, o += 8) {
+        const cp = cells[o] | (cells[o + 1] << 8);
+        const xPos = x * xAdvance;
+        ctx.fillStyle = `rgb(${cells[o + 5]},${cells[o + 6]},${cells[o + 7]})`;
+        ctx.fillRect(xPos, yPos, xAdvance, yAdvance);
+        if (cp === 32) continue;
+        ctx.fillStyle = `rgb(${cells[o + 2]},${cells[o + 3]},${cells[o + 4]})`;
+        if (cp === 0x2580) {
+          ctx.fillRect(xPos, yPos, xAdvance, yAdvance / 2);
+        } else {
+          ctx.fillText(String.fromCharCode(cp), xPos, yPos);
+        }
+      }
+    }
+  }
+
+  // 델타 그리기: AsciiCellDelta {uint32 index, char, r, g, b} * count
+  // 바뀐 셀만 배경을 지우고 다시 씀
+  function paintDelta(heap, ptr, count) {
+    const delta = new Uint8Array(heap, ptr, count * 8);
+    for (let k = 0; k < count; k++) {
+      const o = k * 8;
+      const index = delta[o] | (delta[o + 1] << 8) | (delta[o + 2] << 16) | (delta[o + 3] << 24);
+      const x = index % ASCII_WIDTH;
+      const yPos = ((index - x) / ASCII_WIDTH) * yAdvance;
+      ctx.fillStyle = '#000';
+      ctx.fillRect(x * xAdvance, yPos, xAdvance, yAdvance);
+      drawCell(delta, o + 4, x, yPos);
+    }
+  }
 
   function getMemoryBuffer() {
     if (typeof HEAPU8 !== 'undefined' && HEAPU8 && HEAPU8.buffer) return HEAPU8.buffer;
@@ -424,6 +667,7 @@ function setupRenderer() {
       if (engineMode === 'cpp') {
         resetBenchmarkStats();
         setSimd(1);
+        setFused(1);
       } else {
         resetJsBenchmarkStats();
       }
@@ -434,7 +678,7 @@ function setupRenderer() {
       benchmarkFrameCounter = 0;
       updateBenchmarkUI();
       if (engineMode === 'cpp') {
-        currentModeEl.textContent = 'Testing: SIMD ON';
+        currentModeEl.textContent = 'Testing: SIMD ON (fused)';
         currentModeEl.style.color = '#0f0';
       } else {
         currentModeEl.textContent = 'Testing: JavaScript';
@@ -458,6 +702,7 @@ function setupRenderer() {
     if (engineMode === 'cpp') {
       engineMode = 'js';
       setJsMode(1);
+      recalc();
       engineToggle.textContent = 'ENGINE: JS';
       engineToggle.style.color = '#ff0';
       engineToggle.style.borderColor = '#ff0';
@@ -468,6 +713,8 @@ function setupRenderer() {
     } else {
       engineMode = 'cpp';
       setJsMode(0);
+      recalc();
+      needFullRepaint = true;
       engineToggle.textContent = 'ENGINE: C++';
       engineToggle.style.color = '#0f0';
       engineToggle.style.borderColor = '#0f0';
@@ -500,52 +747,60 @@ function setupRenderer() {
 
   // 렌더 루프
   function renderFrame() {
+    syncGrid();
     if (engineMode === 'cpp') {
       // C++ 모드
       if (benchmarkMode) {
-        // 벤치마크 모드일 때 SIMD ON/OFF 전환
+        // 벤치마크 모드일 때 SIMD ON/OFF 전환 (한 바퀴마다 융합/2-패스 전환)
         benchmarkFrameCounter++;
         if (benchmarkFrameCounter >= BENCHMARK_SWITCH_INTERVAL) {
           benchmarkFrameCounter = 0;
           const current = getSimd();
           setSimd(current ? 0 : 1);
           const newState = getSimd();
-          currentModeEl.textContent = `Testing: SIMD ${newState ? 'ON' : 'OFF'}`;
+          if (newState) setFused(getFused() ? 0 : 1);
+          const pipeline = getFused() ? 'fused' : '2-pass';
+          currentModeEl.textContent = `Testing: SIMD ${newState ? 'ON' : 'OFF'} (${pipeline})`;
           currentModeEl.style.color = newState ? '#0f0' : '#ff3333';
         }
         updateBenchmarkStats();
+        needFullRepaint = true;
       } else {
-        // 일반 모드: canvas 그리기
+        // 일반 모드: canvas 그리기 (가장 최근에 발행된 완성 프레임)
         try {
-          const ptr = getBufferPtr();
-          const size = getBufferSize();
-          if (!ptr || !size) return;
+          acquireFrame();
+          const ptr = getAcqCells();
+          if (!ptr) return;
+          // 그리드가 막 바뀌었으면 새 크기 프레임이 발행될 때까지 기다림
+          if (getAcqWidth() !== ASCII_WIDTH || getAcqHeight() !== ASCII_HEIGHT) return;
 
           const heap = getMemoryBuffer();
-          const buffer = new Uint8Array(heap, ptr, size);
-
-          const expected = ASCII_WIDTH * ASCII_HEIGHT * 4;
-          if (buffer.length < expected) return;
-
-          ctx.fillStyle = '#000';
-          ctx.fillRect(0, 0, canvas.width, canvas.height);
-
-          let i = 0;
-          for (let y = 0; y < ASCII_HEIGHT; y++) {
-            const yPos = y * yAdvance;
-            for (let x = 0; x < ASCII_WIDTH; x++) {
-              const charCode = buffer[i];
-              const r = buffer[i + 1];
-              const g = buffer[i + 2];
-              const b = buffer[i + 3];
-              i += 4;
-
-              if (charCode > 32 || r > 10 || g > 10 || b > 10) {
-                ctx.fillStyle = `rgb(${r},${g},${b})`;
-                ctx.fillText(String.fromCharCode(charCode), x * xAdvance, yPos);
-              }
-            }
+          const buffer = new Uint8Array(heap, ptr, ASCII_WIDTH * ASCII_HEIGHT * 4);
+
+          // 새 프레임이 없으면 그대로 두고, 바로 다음 프레임이면 델타만 그림
+          // (프레임을 건너뛰었거나 전체 변환 프레임이면 전체 다시 그리기)
+          // 델타 목록은 엔진의 마지막 변환 것 → 발행 프레임이 그 변환일 때만 사용
+          const frameId = getAcqFrameId() >>> 0;
+          if (!needFullRepaint && frameId === lastPaintedFrameId) return;
+
+          const deltaPtr = getDeltaPtr();
+          const packedPtr = getAcqPacked();
+          const widePtr = subcellMode ? getAcqWide() : 0;
+          if (widePtr) {
+            paintAllWide(heap, widePtr);
+          } else if (useRaster()) {
+            paintRaster(heap, ptr, needFullRepaint);
+          } else if (!needFullRepaint && !getDeltaFull() && deltaPtr &&
+              frameId === (getFrameId() >>> 0) &&
+              frameId === ((lastPaintedFrameId + 1) >>> 0)) {
+            paintDelta(heap, deltaPtr, getDeltaCount());
+          } else if (packedFormat && packedPtr) {
+            paintAllPacked(heap, packedPtr);
+          } else {
+            paintAll(buffer);
           }
+          lastPaintedFrameId = frameId;
+          needFullRepaint = false;
         } catch (e) {
           console.error("Error during canvas rendering:", e);
         }
@@ -580,26 +835,9 @@ function setupRenderer() {
           updateBenchmarkStats();
         }
 
-        // Canvas 렌더링
-        ctx.fillStyle = '#000';
-        ctx.fillRect(0, 0, canvas.width, canvas.height);
-
-        let i = 0;
-        for (let y = 0; y < ASCII_HEIGHT; y++) {
-          const yPos = y * yAdvance;
-          for (let x = 0; x < ASCII_WIDTH; x++) {
-            const charCode = buffer[i];
-            const r = buffer[i + 1];
-            const g = buffer[i + 2];
-            const b = buffer[i + 3];
-            i += 4;
-
-            if (charCode > 32 || r > 10 || g > 10 || b > 10) {
-              ctx.fillStyle = `rgb(${r},${g},${b})`;
-              ctx.fillText(String.fromCharCode(charCode), x * xAdvance, yPos);
-            }
-          }
-        }
+        // Canvas 렌더링 (C++ 모드로 돌아가면 전체 다시 그리기)
+        paintAll(buffer);
+        needFullRepaint = true;
       } catch (e) {
         console.error("Error during JS canvas rendering:", e);
       }
@@ -611,7 +849,125 @@ function setupRenderer() {
     requestAnimationFrame(loop);
   }
 
-  // 시작
+  // 세션 재생 (?replay=<url>&speed=N): 게임을 실행하지 않고 녹화된 셀 그리드를 tic 시간(35/초 × speed)에
+  // 맞춰 그림. 탐색은 앞으로 가는 동안 이어서 디코딩하므로 rAF마다 목표 tic으로 seek만 함. 끝나면 처음부터 반복
+  const TICRATE = 35;
+  const REPLAY_PATH = '/replay.arec';
+
+  function startReplay(url, speed) {
+    fetch(url).then((r) => {
+      if (!r.ok) throw new Error(`HTTP ${r.status}`);
+      return r.arrayBuffer();
+    }).then((data) => {
+      Module.FS.writeFile(REPLAY_PATH, new Uint8Array(data));
+      if (replayOpen(REPLAY_PATH) <= 0) throw new Error('not an ASCII session file');
+      const firstTic = replayFirstTic();
+      const lastTic = replayLastTic();
+      let start = performance.now();
+      let lastFrame = -1;
+
+      function replayLoop(now) {
+        let tic = firstTic + Math.floor((now - start) * TICRATE * speed / 1000);
+        if (tic > lastTic) {
+          start = now;
+          tic = firstTic;
+        }
+        replaySeek(tic);
+        const frame = replayFrame();
+        const w = replayWidth(), h = replayHeight();
+        if (w !== ASCII_WIDTH || h !== ASCII_HEIGHT) {
+          ASCII_WIDTH = w;
+          ASCII_HEIGHT = h;
+          recalc();
+          needFullRepaint = true;
+        }
+        if (frame !== lastFrame || needFullRepaint) {
+          const heap = getMemoryBuffer();
+          const ptr = replayCells();
+          if (useRaster()) {
+            paintRaster(heap, ptr, needFullRepaint);
+          } else {
+            paintAll(new Uint8Array(heap, ptr, w * h * 4));
+          }
+          lastFrame = frame;
+          needFullRepaint = false;
+        }
+        requestAnimationFrame(replayLoop);
+      }
+      requestAnimationFrame(replayLoop);
+    }).catch((e) => console.error(`Cannot replay ${url}:`, e));
+  }
+
+  const replayParam = new URLSearchParams(window.location.search).get('replay');
+  if (replayParam) {
+    const speed = parseFloat(new URLSearchParams(window.location.search).get('speed'));
+    startReplay(replayParam, speed > 0 ? speed : 1);
+    return;
+  }
+
+  // 콘솔용: asciiRecordStart(키프레임 간격) → 플레이 → asciiRecordStop() → session.arec 내려받기
+  const RECORD_PATH = '/session.arec';
+  window.asciiRecordStart = (interval) => sessionStart(RECORD_PATH, interval || 0) === 1;
+  window.asciiRecordStop = () => {
+    if (!sessionActive()) return null;
+    const frames = sessionFrames() >>> 0;
+    const encodeMs = sessionEncodeMs();
+    sessionStop();
+    const data = Module.FS.readFile(RECORD_PATH);
+    Module.FS.unlink(RECORD_PATH);
+    const a = document.createElement('a');
+    a.href = URL.createObjectURL(new Blob([data], { type: 'application/octet-stream' }));
+    a.download = 'session.arec';
+    a.click();
+    setTimeout(() => URL.revokeObjectURL(a.href), 1000);
+    return { frames, bytes: data.length, encodeMsPerFrame: frames ? encodeMs / frames : 0 };
+  };
+
+  // 시작 (?grid=WxH 지정 시 그리드 크기 설정)
   callMain(commonArgs);
+  const gridParam = new URLSearchParams(window.location.search).get('grid');
+  const gridMatch = gridParam && /^(\d+)x(\d+)$/.exec(gridParam);
+  if (gridMatch && !setGrid(parseInt(gridMatch[1], 10), parseInt(gridMatch[2], 10))) {
+    console.warn(`Invalid grid size: ${gridParam}`);
+  }
+  // 콘솔용: asciiStageStats() → {stages: {total: {p50, p99, ...}}}, ?warmup=N으로 워밍업 프레임 지정
+  window.asciiStageStats = () => JSON.parse(getStageStatsJson());
+  window.asciiResetStageStats = resetStageStats;
+  // 콘솔용: asciiFrameCounters() → {converted, skipped}
+  window.asciiFrameCounters = () => ({ converted: getFramesConverted() >>> 0, skipped: getFramesSkipped() >>> 0 });
+  window.asciiResetFrameCounters = resetFrameCounters;
+  const warmupParam = new URLSearchParams(window.location.search).get('warmup');
+  if (warmupParam && /^\d+$/.test(warmupParam)) setBenchmarkWarmup(parseInt(warmupParam, 10));
+  const packedParam = new URLSearchParams(window.location.search).get('packed');
+  packedFormat = packedParam === '444' ? 1 : packedParam === 'indexed' ? 2 : 0;
+  setPackedFormat(packedFormat);
+  const temporalParam = new URLSearchParams(window.location.search).get('temporal');
+  const temporalMatch = temporalParam && /^(\d+),(\d+)$/.exec(temporalParam);
+  if (temporalParam === '1' || temporalMatch) {
+    if (temporalMatch) setTemporalMargin(parseInt(temporalMatch[1], 10), parseInt(temporalMatch[2], 10));
+    setTemporalFilter(1);
+  }
+  // 콘솔용: asciiTemporalStabilized() → 직전 프레임에서 이전 글리프/색을 유지한 셀 수
+  window.asciiTemporalStabilized = getTemporalStabilized;
+  const shapeParam = new URLSearchParams(window.location.search).get('shape');
+  if (shapeParam && /^\d+$/.test(shapeParam) && shapeParam !== '0') {
+    if (shapeParam !== '1') setShapeThreshold(parseInt(shapeParam, 10));
+    setShapeGlyphs(1);
+  }
+  // 콘솔용: asciiShapeMatched() → 직전 프레임에서 모양 글리프로 바꾼 셀 수
+  window.asciiShapeMatched = getShapeMatched;
+  if (subcellMode) setSubcellMode(subcellMode);
+  const DITHER_MODES = ['off', 'bayer', 'floyd', 'atkinson'];
+  const ditherMatch = /^(bayer|floyd|atkinson)(?:,(\d+))?$/.exec(new URLSearchParams(window.location.search).get('dither') || '');
+  if (ditherMatch) {
+    if (ditherMatch[2]) setDitherLevels(parseInt(ditherMatch[2], 10));
+    setDither(DITHER_MODES.indexOf(ditherMatch[1]));
+  }
+  // 콘솔용: asciiDitherTimes() → 디더링 방식별 {avg(ms), frames} (벤치마크 모드에서 누적)
+  window.asciiDitherTimes = () => Object.fromEntries(DITHER_MODES.map((name, i) =>
+    [name, { avg: getBenchAvgTimeDither(i), frames: getBenchFrameCountDither(i) }]));
+  if (new URLSearchParams(window.location.search).get('regions') === '0') setStaticRegions(0);
+  // 콘솔용: asciiRegionRowsReused() → 직전 프레임에서 재사용한 셀 행 수
+  window.asciiRegionRowsReused = getRegionRowsReused;
   requestAnimationFrame(loop);
 }
@@ -29,6 +29,8 @@
 #include "doomtype.h"
 
 #include "deh_str.h"
+#include "i_ascii.h"
+#include "i_asciiraster.h"
 #include "i_input.h"
 #include "i_swap.h"
 #include "i_video.h"
@@ -77,6 +79,11 @@ void V_MarkRect(int x, int y, int width, int height)
     {
         M_AddToBox (dirtybox, x, y); 
         M_AddToBox (dirtybox, x + width-1, y + height-1); 
+
+        // The ASCII converter must look at any static region (status
+        // bar, view border) that this drawing touches again.
+
+        I_MarkASCIIRect(x, y, width, height);
     }
 } 
  
@@ -537,6 +544,8 @@ void V_DrawFilledBox(int x, int y, int w, int h, int c)
     pixel_t *buf, *buf1;
     int x1, y1;
 
+    V_MarkRect(x, y, w, h);
+
     buf = I_VideoBuffer + SCREENWIDTH * y + x;
 
     for (y1 = 0; y1 < h; ++y1)
@@ -557,6 +566,8 @@ void V_DrawHorizLine(int x, int y, int w, int c)
     pixel_t *buf;
     int x1;
 
+    V_MarkRect(x, y, w, 1);
+
     buf = I_VideoBuffer + SCREENWIDTH * y + x;
 
     for (x1 = 0; x1 < w; ++x1)
@@ -570,6 +581,8 @@ void V_DrawVertLine(int x, int y, int h, int c)
     pixel_t *buf;
     int y1;
 
+    V_MarkRect(x, y, 1, h);
+
     buf = I_VideoBuffer + SCREENWIDTH * y + x;
 
     for (y1 = 0; y1 < h; ++y1)
@@ -836,6 +849,9 @@ void V_ScreenShot(const char *format)
 {
     int i;
     char lbmname[16]; // haleyjd 20110213: BUG FIX - 12 is too small!
+#ifdef HAVE_LIBPNG
+    char asciiname[32];
+#endif
     const char *ext;
     
     // find a file name to save it to
@@ -881,6 +897,12 @@ void V_ScreenShot(const char *format)
     WritePNGfile(lbmname, I_VideoBuffer,
                  SCREENWIDTH, SCREENHEIGHT,
                  W_CacheLumpName (DEH_String("PLAYPAL"), PU_CACHE));
+
+    // Save the ASCII view alongside it (DOOM00.png -> DOOM00-ascii.png).
+    M_snprintf(asciiname, sizeof(asciiname), "%.*s-ascii.png",
+               (int) strlen(lbmname) - 4, lbmname);
+    I_RasterizeASCII(I_GetASCIIBuffer(), I_GetASCIIWidth(), I_GetASCIIHeight());
+    I_WriteASCIIRasterPNG(asciiname);
     }
     else
 #endif